@@ -0,0 +1,132 @@
+// Compares the predictions of an additive model of Lorentzian modes when
+// all parameters change between two calls, and when only the parameters of
+// a single mode change, in which case only that mode is recomputed.
+//
+// Compile with:
+// clang++ -o demoAdditiveModel demoAdditiveModel.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <Eigen/Core>
+#include "Functions.h"
+#include "AdditiveModel.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Flat background with Lorentzian modes. The model parameters are the background
+// followed by (centroid, height, linewidth) for each mode. The background and each
+// mode are separate components.
+
+class LorentzianModesModel : public AdditiveModel
+{
+    public:
+
+        LorentzianModesModel(const RefArrayXd covariates, int Nmodes)
+        : AdditiveModel(covariates)
+        {
+            Nparameters = 1 + 3 * Nmodes;
+            addComponent(0, 1);
+
+            for (int mode = 0; mode < Nmodes; ++mode)
+            {
+                addComponent(1 + 3*mode, 3);
+            }
+        }
+
+    protected:
+
+        virtual void predictComponent(RefArrayXd contribution, const int componentIndex, const RefArrayXd componentParameters) override
+        {
+            if (componentIndex == 0)
+            {
+                contribution += componentParameters(0);
+            }
+            else
+            {
+                Functions::modeProfile(contribution, covariates, componentParameters(0), componentParameters(1), componentParameters(2));
+            }
+        }
+};
+
+
+
+int main()
+{
+    int Nbins = 500000;
+    int Nmodes = 40;
+    int Nevaluations = 50;
+
+    mt19937 engine(42);
+    uniform_real_distribution<> uniform(0.0, 1.0);
+    normal_distribution<> normal(0.0, 1.0);
+
+    ArrayXd covariates = ArrayXd::LinSpaced(Nbins, 100.0, 5000.0);
+    ArrayXd parameters(1 + 3*Nmodes);
+    parameters(0) = 2.0;
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        parameters(1 + 3*mode) = 1000.0 + 70.0 * mode;
+        parameters(2 + 3*mode) = 10.0 + 40.0 * uniform(engine);
+        parameters(3 + 3*mode) = 0.5 + 1.5 * uniform(engine);
+    }
+
+    LorentzianModesModel model(covariates, Nmodes);
+    ArrayXd predictions(Nbins);
+
+
+    // Change all parameters at each call
+
+    clock_t startTime = clock();
+
+    for (int n = 0; n < Nevaluations; ++n)
+    {
+        parameters *= 1.0 + 1.e-6 * normal(engine);
+        predictions.setZero();
+        model.predict(predictions, parameters);
+    }
+
+    double fullTime = double(clock() - startTime) / CLOCKS_PER_SEC / Nevaluations;
+    unsigned long NfullComponentEvaluations = model.getNcomponentEvaluations();
+
+
+    // Change the parameters of a single mode at each call
+
+    startTime = clock();
+
+    for (int n = 0; n < Nevaluations; ++n)
+    {
+        int mode = n % Nmodes;
+        parameters.segment(1 + 3*mode, 3) *= 1.0 + 1.e-6 * normal(engine);
+        predictions.setZero();
+        model.predict(predictions, parameters);
+    }
+
+    double incrementalTime = double(clock() - startTime) / CLOCKS_PER_SEC / Nevaluations;
+    unsigned long NincrementalComponentEvaluations = model.getNcomponentEvaluations() - NfullComponentEvaluations;
+
+
+    // Check the incremental predictions against predictions from scratch
+
+    model.clearCache();
+    ArrayXd referencePredictions = ArrayXd::Zero(Nbins);
+    model.predict(referencePredictions, parameters);
+
+    cerr << setprecision(6);
+    cerr << Nbins << " bins, " << Nmodes << " modes, " << Nevaluations << " evaluations" << endl;
+    cerr << "All parameters changed:   " << fullTime << " s per prediction, " 
+         << NfullComponentEvaluations / double(Nevaluations) << " components recomputed" << endl;
+    cerr << "One mode changed:         " << incrementalTime << " s per prediction, "
+         << NincrementalComponentEvaluations / double(Nevaluations) << " components recomputed" << endl;
+    cerr << "Max relative difference with predictions from scratch: " 
+         << ((predictions - referencePredictions) / referencePredictions).abs().maxCoeff() << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+// Runs the nested sampler on the five 2D Gaussians, and saves the results once
+// in the usual ASCII files and once in a single binary archive. The archive is
+// then read back, both with an ArchiveReader and with Results::readArchive(),
+// and compared with the results of the run.
+//
+// Compile with:
+// clang++ -o demoBinaryArchive demoBinaryArchive.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include "Functions.h"
+#include "MultiEllipsoidSampler.h"
+#include "KmeansClusterer.h"
+#include "EuclideanMetric.h"
+#include "UniformPrior.h"
+#include "ZeroModel.h"
+#include "ZeroLikelihood.h"
+#include "ZeroClusterer.h"
+#include "ZeroSampler.h"
+#include "ZeroPrior.h"
+#include "PowerlawReducer.h"
+#include "Results.h"
+#include "ArchiveWriter.h"
+#include "ArchiveReader.h"
+#include "demoFive2DGaussians.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+int main()
+{
+    // Run the nested sampler
+
+    ArrayXd covariates;
+    ArrayXd observations;
+    ZeroModel model(covariates);
+
+    int Ndimensions = 2;
+    vector<Prior*> ptrPriors(1);
+    ArrayXd parametersMinima(Ndimensions);
+    ArrayXd parametersMaxima(Ndimensions);
+    parametersMinima << -0.7, -0.7;
+    parametersMaxima << +1.0, +1.0;
+    UniformPrior uniformPrior(parametersMinima, parametersMaxima);
+    ptrPriors[0] = &uniformPrior;
+
+    Multiple2DGaussiansLikelihood likelihood(observations, model);
+    EuclideanMetric myMetric;
+    KmeansClusterer kmeans(myMetric, 1, 6, 10, 0.01);
+
+    bool printOnTheScreen = false;
+    int initialNobjects = 200;
+    int minNobjects = 200;
+    int maxNdrawAttempts = 20000;
+    int NinitialIterationsWithoutClustering = 100;
+    int NiterationsWithSameClustering = 20;
+    double initialEnlargementFraction = 10.0;
+    double shrinkingRate = 0.2;
+    double terminationFactor = 0.05;
+
+    MultiEllipsoidSampler nestedSampler(printOnTheScreen, ptrPriors, likelihood, myMetric, kmeans,
+                                        initialNobjects, minNobjects, initialEnlargementFraction, shrinkingRate);
+    PowerlawReducer livePointsReducer(nestedSampler, 1.e2, 0.4, terminationFactor);
+
+    nestedSampler.run(livePointsReducer, NinitialIterationsWithoutClustering, NiterationsWithSameClustering,
+                      maxNdrawAttempts, terminationFactor, "demoBinaryArchive_");
+    nestedSampler.outputFile.close();
+
+
+    // Save the results in ASCII files
+
+    double credibleLevel = 68.3;
+    Results results(nestedSampler);
+
+    auto startTime = chrono::steady_clock::now();
+
+    results.writeParametersToFile("parameter");
+    results.writeLogLikelihoodToFile("logLikelihood.txt");
+    results.writeLogWeightsToFile("logWeight.txt");
+    results.writeEvidenceInformationToFile("evidenceInformation.txt");
+    results.writePosteriorProbabilityToFile("posteriorDistribution.txt");
+    results.writeParametersSummaryToFile("parameterSummary.txt", credibleLevel, true);
+
+    chrono::duration<double> asciiTime = chrono::steady_clock::now() - startTime;
+
+
+    // Save the same results in a binary archive, and append a note to it afterwards
+
+    startTime = chrono::steady_clock::now();
+
+    results.writeArchive("archive.bin", false, credibleLevel, true);
+
+    chrono::duration<double> archiveTime = chrono::steady_clock::now() - startTime;
+
+    ArchiveWriter appendingWriter("demoBinaryArchive_archive.bin", true);
+    appendingWriter.appendText("note", "Five 2D Gaussians, uniform priors in [-0.7, 1.0]");
+    appendingWriter.close();
+
+    cerr << setprecision(4);
+    cerr << "Posterior sample of " << nestedSampler.getPosteriorSample().cols() << " points" << endl;
+    cerr << "ASCII files:    " << asciiTime.count() << " s" << endl;
+    cerr << "Binary archive: " << archiveTime.count() << " s" << endl << endl;
+
+
+    // Read the archive back
+
+    ArchiveReader reader("demoBinaryArchive_archive.bin");
+    vector<string> blockNames = reader.getBlockNames();
+
+    cerr << "Blocks in the archive:";
+    for (size_t n = 0; n < blockNames.size(); ++n) cerr << " " << blockNames[n];
+    cerr << endl;
+    cerr << "Note: " << reader.readText("note") << endl << endl;
+
+    ArrayXXd parameterSummary = reader.readArrayXXd("parameterSummary");
+    cerr << "Parameter summary (Mean, Median, Mode, II Moment, Lower CL, Upper CL, Skewness):" << endl;
+    cerr << parameterSummary << endl << endl;
+
+
+    // Read the archive into another sampler, as the merging of runs does, and compare
+
+    ZeroLikelihood zeroLikelihood(observations, model);
+    ZeroClusterer zeroClusterer(myMetric);
+    vector<Prior*> ptrZeroPriors(1);
+    ZeroPrior zeroPrior(1);
+    ptrZeroPriors[0] = &zeroPrior;
+    ZeroSampler zeroSampler(printOnTheScreen, initialNobjects, minNobjects, ptrZeroPriors, zeroLikelihood, myMetric, zeroClusterer);
+
+    Results readResults(zeroSampler);
+    readResults.readArchive("demoBinaryArchive_archive.bin");
+
+    cerr << "Largest differences between the run and the archive:" << endl;
+    cerr << "  posterior sample: " << (zeroSampler.getPosteriorSample() - nestedSampler.getPosteriorSample()).abs().maxCoeff() << endl;
+    cerr << "  log(Likelihood):  " << (zeroSampler.getLogLikelihoodOfPosteriorSample()
+                                      - nestedSampler.getLogLikelihoodOfPosteriorSample()).abs().maxCoeff() << endl;
+    cerr << "  log(Weight):      " << (zeroSampler.getLogWeightOfPosteriorSample()
+                                      - nestedSampler.getLogWeightOfPosteriorSample()).abs().maxCoeff() << endl;
+    cerr << "  log(Evidence):    " << fabs(zeroSampler.getLogEvidence() - nestedSampler.getLogEvidence()) << endl;
+
+    return EXIT_SUCCESS;
+}
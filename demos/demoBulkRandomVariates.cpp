@@ -0,0 +1,113 @@
+// Draws large arrays of uniform and standard normal random numbers, once in bulk
+// with the fill functions of the Philox4x32Engine, and once one number at a time
+// with the distributions of <random> on a Mersenne Twister, as the samplers did
+// before. The timings are compared, and the first moments of the bulk variates
+// are checked against their expected values.
+//
+// Compile with:
+// clang++ -o demoBulkRandomVariates demoBulkRandomVariates.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <Eigen/Core>
+#include "Philox4x32Engine.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Print the mean, variance, skewness and excess kurtosis of an array
+
+void printMoments(string name, const ArrayXd &values)
+{
+    double mean = values.mean();
+    ArrayXd deviations = values - mean;
+    double variance = deviations.square().mean();
+    double skewness = deviations.cube().mean() / pow(variance, 1.5);
+    double kurtosis = deviations.square().square().mean() / (variance * variance) - 3.0;
+
+    cerr << name << ":   mean = " << mean << "   variance = " << variance
+         << "   skewness = " << skewness << "   excess kurtosis = " << kurtosis << endl;
+}
+
+
+
+int main()
+{
+    const int Nvalues = 10000000;
+    const int Nrepetitions = 5;
+
+    ArrayXd values(Nvalues);
+    Philox4x32Engine philox(2024, 0);
+    mt19937 mersenneTwister(2024);
+    uniform_real_distribution<> uniform(0.0, 1.0);
+    normal_distribution<> normal(0.0, 1.0);
+
+    cerr << setprecision(4);
+
+
+    // Uniform numbers
+
+    auto startTime = chrono::steady_clock::now();
+
+    for (int n = 0; n < Nrepetitions; ++n)
+    {
+        philox.fillUniform(values);
+    }
+
+    chrono::duration<double> bulkTime = chrono::steady_clock::now() - startTime;
+    printMoments("Bulk uniform  ", values);
+
+    startTime = chrono::steady_clock::now();
+
+    for (int n = 0; n < Nrepetitions; ++n)
+    {
+        for (int i = 0; i < Nvalues; ++i)
+        {
+            values(i) = uniform(mersenneTwister);
+        }
+    }
+
+    chrono::duration<double> scalarTime = chrono::steady_clock::now() - startTime;
+
+    cerr << "Expected      :   mean = 0.5   variance = " << 1.0/12.0 << "   skewness = 0   excess kurtosis = -1.2" << endl;
+    cerr << "Uniform: " << Nvalues * Nrepetitions / bulkTime.count() / 1.e6 << " million numbers/s in bulk, "
+         << Nvalues * Nrepetitions / scalarTime.count() / 1.e6 << " million numbers/s one at a time" << endl << endl;
+
+
+    // Standard normal numbers
+
+    startTime = chrono::steady_clock::now();
+
+    for (int n = 0; n < Nrepetitions; ++n)
+    {
+        philox.fillNormal(values);
+    }
+
+    bulkTime = chrono::steady_clock::now() - startTime;
+    printMoments("Bulk normal   ", values);
+
+    startTime = chrono::steady_clock::now();
+
+    for (int n = 0; n < Nrepetitions; ++n)
+    {
+        for (int i = 0; i < Nvalues; ++i)
+        {
+            values(i) = normal(mersenneTwister);
+        }
+    }
+
+    scalarTime = chrono::steady_clock::now() - startTime;
+
+    cerr << "Expected      :   mean = 0   variance = 1   skewness = 0   excess kurtosis = 0" << endl;
+    cerr << "Normal: " << Nvalues * Nrepetitions / bulkTime.count() / 1.e6 << " million numbers/s in bulk, "
+         << Nvalues * Nrepetitions / scalarTime.count() / 1.e6 << " million numbers/s one at a time" << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+// Shows the cache of log-likelihood values on a grid of parameters.
+// First, the same points are evaluated through two caches, in opposite orders:
+// since each value is computed at the node of the grid nearest to the point,
+// and not at the first point that fell in its cell, both orders give
+// bit-identical values. Then the nested sampler is run on the single 2D 
+// Gaussian, with and without the cache, and prints the hits and misses 
+// of the cache at the end of the run.
+//
+// Compile with:
+// clang++ -o demoCachedLikelihood demoCachedLikelihood.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include "Functions.h"
+#include "MultiEllipsoidSampler.h"
+#include "KmeansClusterer.h"
+#include "EuclideanMetric.h"
+#include "UniformPrior.h"
+#include "ZeroModel.h"
+#include "PowerlawReducer.h"
+#include "CachedLikelihood.h"
+#include "RandomStreams.h"
+#include "demoSingle2DGaussian.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Run the nested sampler on the given likelihood, always with the same run seed, 
+// and return the log-evidence
+
+double runNestedSampler(Likelihood &likelihood, string outputPathPrefix)
+{
+    RandomStreams::setRunSeed(12345);
+
+    int Ndimensions = 2;
+    vector<Prior*> ptrPriors(1);
+    ArrayXd parametersMinima(Ndimensions);
+    ArrayXd parametersMaxima(Ndimensions);
+    parametersMinima <<  0.0, 10.0;
+    parametersMaxima << 20.0, 30.0;
+    UniformPrior uniformPrior(parametersMinima, parametersMaxima);
+    ptrPriors[0] = &uniformPrior;
+
+    EuclideanMetric myMetric;
+    KmeansClusterer kmeans(myMetric, 1, 3, 10, 0.01);
+
+    bool printOnTheScreen = true;
+    int initialNobjects = 1000;
+    int minNobjects = 400;
+    int maxNdrawAttempts = 100;
+    int NinitialIterationsWithoutClustering = 100;
+    int NiterationsWithSameClustering = 10;
+    double initialEnlargementFraction = 1.5;
+    double shrinkingRate = 0.2;
+    double terminationFactor = 0.05;
+
+    MultiEllipsoidSampler nestedSampler(printOnTheScreen, ptrPriors, likelihood, myMetric, kmeans, 
+                                        initialNobjects, minNobjects, initialEnlargementFraction, shrinkingRate);
+    PowerlawReducer livePointsReducer(nestedSampler, 1.e2, 0.4, terminationFactor);
+
+    nestedSampler.run(livePointsReducer, NinitialIterationsWithoutClustering, NiterationsWithSameClustering, 
+                      maxNdrawAttempts, terminationFactor, outputPathPrefix);
+    nestedSampler.outputFile.close();
+
+    return nestedSampler.getLogEvidence();
+}
+
+
+
+int main()
+{
+    ArrayXd covariates;
+    ArrayXd observations;
+    ZeroModel model(covariates);
+    Single2DGaussianLikelihood likelihood(observations, model);
+
+    ArrayXd quantizationSteps(2);
+    quantizationSteps << 0.05, 0.05;
+
+
+    // The same points, in opposite orders, through two caches. Many points share a cell.
+
+    int Npoints = 20000;
+    mt19937 engine(42);
+    normal_distribution<> normal(0.0, 1.0);
+    ArrayXXd points(2, Npoints);
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        points(0, n) =  9.5 + 0.5 * normal(engine);
+        points(1, n) = 20.0 + 0.5 * normal(engine);
+    }
+
+    CachedLikelihood forwardCache(likelihood, quantizationSteps);
+    CachedLikelihood backwardCache(likelihood, quantizationSteps);
+    ArrayXd forwardLogLikelihoods(Npoints);
+    ArrayXd backwardLogLikelihoods(Npoints);
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        ArrayXd point = points.col(n);
+        forwardLogLikelihoods(n) = forwardCache.logValue(point);
+    }
+
+    for (int n = Npoints-1; n >= 0; --n)
+    {
+        ArrayXd point = points.col(n);
+        backwardLogLikelihoods(n) = backwardCache.logValue(point);
+    }
+
+    int Ndifferences = (forwardLogLikelihoods != backwardLogLikelihoods).count();
+
+    cerr << setprecision(6);
+    cerr << Npoints << " points, " << forwardCache.getNentries() << " nodes of the grid" << endl;
+    cerr << "Cache hits / misses:                         " << forwardCache.getNhits() << " / " 
+         << forwardCache.getNmisses() << endl;
+    cerr << "Values that depend on the evaluation order:  " << Ndifferences << endl;
+    cerr << endl;
+
+
+    // The nested sampler, without and with the cache
+
+    double logEvidenceWithoutCache = runNestedSampler(likelihood, "demoCachedLikelihood_");
+    CachedLikelihood cachedLikelihood(likelihood, quantizationSteps);
+    double logEvidenceWithCache = runNestedSampler(cachedLikelihood, "demoCachedLikelihood_cached_");
+
+    cerr << endl;
+    cerr << "log(E) without / with cache:  " << logEvidenceWithoutCache << " / " << logEvidenceWithCache << endl;
+    cerr << "Evaluations computed with cache: " << cachedLikelihood.getNmisses() << " of " 
+         << cachedLikelihood.getNhits() + cachedLikelihood.getNmisses() << endl;
+
+    return EXIT_SUCCESS;
+}
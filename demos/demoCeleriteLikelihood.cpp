@@ -0,0 +1,169 @@
+// Computes the likelihood of a light curve with correlated (granulation-like) noise,
+// with a constant mean and a kernel made of an exponential term and a stochastically
+// driven, damped harmonic oscillator term. The O(N) semiseparable computation of the
+// CeleriteLikelihood is compared with a dense O(N^3) Cholesky decomposition for a
+// short light curve, and is then timed on a long light curve.
+//
+// Compile with:
+// clang++ -o demoCeleriteLikelihood demoCeleriteLikelihood.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <algorithm>
+#include <Eigen/Dense>
+#include "Functions.h"
+#include "Model.h"
+#include "CeleriteLikelihood.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Constant mean, the only parameter being its value
+
+class ConstantModel : public Model
+{
+    public:
+
+        ConstantModel(const RefArrayXd covariates)
+        : Model(covariates)
+        {
+            Nparameters = 1;
+        }
+
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) override
+        {
+            predictions += modelParameters(0);
+        }
+};
+
+
+
+// Kernel of the exponential and oscillator terms, for the dense computation
+
+double kernel(double tau, const RefArrayXd kernelParameters)
+{
+    double a1 = kernelParameters(0), c1 = kernelParameters(1);
+    double a2 = kernelParameters(2), b2 = kernelParameters(3), c2 = kernelParameters(4), d2 = kernelParameters(5);
+
+    return a1 * exp(-c1 * tau) + exp(-c2 * tau) * (a2 * cos(d2 * tau) + b2 * sin(d2 * tau));
+}
+
+
+
+// Dense computation of the log-likelihood with a Cholesky decomposition
+
+double denseLogLikelihood(const RefArrayXd times, const RefArrayXd observations, const RefArrayXd uncertainties,
+                          const RefArrayXd modelParameters)
+{
+    int N = times.size();
+    ArrayXd kernelParameters = modelParameters.tail(6);
+    MatrixXd covariance(N, N);
+
+    for (int n = 0; n < N; ++n)
+        for (int m = 0; m < N; ++m)
+            covariance(n,m) = kernel(fabs(times(n) - times(m)), kernelParameters) + (n == m ? uncertainties(n)*uncertainties(n) : 0.0);
+
+    LLT<MatrixXd> cholesky(covariance);
+    VectorXd residuals = (observations - modelParameters(0)).matrix();
+    VectorXd z = cholesky.matrixL().solve(residuals);
+    double logDeterminant = 2.0 * cholesky.matrixL().toDenseMatrix().diagonal().array().log().sum();
+
+    return -0.5 * (z.squaredNorm() + logDeterminant + N * log(2.0*Functions::PI));
+}
+
+
+
+// Draw a light curve from the Gaussian process, with irregular sampling
+
+void simulateLightCurve(int N, const RefArrayXd modelParameters, mt19937 &engine, ArrayXd &times,
+                        ArrayXd &observations, ArrayXd &uncertainties)
+{
+    uniform_real_distribution<> uniform(0.0, 1.0);
+    normal_distribution<> normal(0.0, 1.0);
+
+    times.resize(N);
+    for (int n = 0; n < N; ++n) times(n) = n + 0.8 * uniform(engine);
+
+    uncertainties = ArrayXd::Constant(N, 0.3);
+
+
+    // An AR(1) process and a damped oscillator, driven by white noise, approximate the kernel.
+    // The exact realization does not matter for the comparison of the likelihoods.
+
+    observations.resize(N);
+    double x1 = 0.0, x2 = 0.0, v2 = 0.0;
+
+    for (int n = 0; n < N; ++n)
+    {
+        x1 = 0.9 * x1 + 0.4 * normal(engine);
+        v2 = 0.95 * v2 - 0.05 * x2 + 0.1 * normal(engine);
+        x2 += v2;
+        observations(n) = modelParameters(0) + x1 + x2 + uncertainties(n) * normal(engine);
+    }
+}
+
+
+
+int main()
+{
+    // Oscillator term with frequency omega0, quality factor Q and power S0 (Foreman-Mackey et al. 2017, Eq. 23)
+
+    double S0 = 0.5, omega0 = 0.3, Q = 2.0;
+    double f = sqrt(4.0*Q*Q - 1.0);
+
+    ArrayXd modelParameters(7);
+    modelParameters << 10.0,                                                            // Constant mean
+                       1.0, 0.1,                                                        // Exponential term: a, c
+                       S0*omega0*Q, S0*omega0*Q/f, omega0/(2.0*Q), omega0*f/(2.0*Q);    // Oscillator term: a, b, c, d
+
+    mt19937 engine(42);
+    ArrayXd times, observations, uncertainties;
+
+
+    // Comparison with the dense computation
+
+    simulateLightCurve(1000, modelParameters, engine, times, observations, uncertainties);
+
+    ConstantModel model(times);
+    CeleriteLikelihood likelihood(observations, uncertainties, model, 1, 1);
+
+    clock_t startTime = clock();
+    double logLikelihood = likelihood.logValue(modelParameters);
+    double time = double(clock() - startTime) / CLOCKS_PER_SEC;
+
+    startTime = clock();
+    double denseLogLikelihoodValue = denseLogLikelihood(times, observations, uncertainties, modelParameters);
+    double denseTime = double(clock() - startTime) / CLOCKS_PER_SEC;
+
+    cerr << setprecision(12);
+    cerr << "N = 1000" << endl;
+    cerr << "    Semiseparable log-likelihood: " << logLikelihood << "   time = " << time << " s" << endl;
+    cerr << "    Dense log-likelihood:         " << denseLogLikelihoodValue << "   time = " << denseTime << " s" << endl;
+    cerr << "    Relative difference: " << fabs(logLikelihood - denseLogLikelihoodValue) / fabs(denseLogLikelihoodValue) << endl;
+    cerr << endl;
+
+
+    // Long light curve
+
+    simulateLightCurve(100000, modelParameters, engine, times, observations, uncertainties);
+
+    ConstantModel longModel(times);
+    CeleriteLikelihood longLikelihood(observations, uncertainties, longModel, 1, 1);
+
+    int Nevaluations = 20;
+    startTime = clock();
+    for (int n = 0; n < Nevaluations; ++n) logLikelihood = longLikelihood.logValue(modelParameters);
+    time = double(clock() - startTime) / CLOCKS_PER_SEC / Nevaluations;
+
+    cerr << "N = 100000" << endl;
+    cerr << "    Semiseparable log-likelihood: " << logLikelihood << "   time = " << time << " s" << endl;
+
+    return EXIT_SUCCESS;
+}
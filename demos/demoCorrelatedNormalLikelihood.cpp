@@ -0,0 +1,136 @@
+// Computes a normal likelihood with correlated errors, for a banded covariance matrix
+// and for a stationary (Toeplitz) covariance matrix. The covariance matrix is factorized
+// once, and the log-likelihood is compared with a dense Cholesky decomposition of the
+// full covariance matrix, which is redone for each evaluation.
+//
+// Compile with:
+// clang++ -o demoCorrelatedNormalLikelihood demoCorrelatedNormalLikelihood.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <Eigen/Dense>
+#include "Functions.h"
+#include "Model.h"
+#include "CorrelatedNormalLikelihood.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Straight line, with parameters the intercept and the slope
+
+class LineModel : public Model
+{
+    public:
+
+        LineModel(const RefArrayXd covariates)
+        : Model(covariates)
+        {
+            Nparameters = 2;
+        }
+
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) override
+        {
+            predictions += modelParameters(0) + modelParameters(1) * covariates;
+        }
+};
+
+
+
+// Dense computation of the log-likelihood with a Cholesky decomposition
+
+double denseLogLikelihood(const MatrixXd &covariance, const RefArrayXd observations, Model &model, const RefArrayXd modelParameters)
+{
+    ArrayXd predictions = ArrayXd::Zero(observations.size());
+    model.predict(predictions, modelParameters);
+
+    LLT<MatrixXd> cholesky(covariance);
+    VectorXd z = cholesky.matrixL().solve((observations - predictions).matrix());
+    double logDeterminant = 2.0 * cholesky.matrixL().toDenseMatrix().diagonal().array().log().sum();
+
+    return -0.5 * (z.squaredNorm() + logDeterminant + observations.size() * log(2.0*Functions::PI));
+}
+
+
+
+int main()
+{
+    int N = 2000;
+    ArrayXd covariates = ArrayXd::LinSpaced(N, 0.0, 100.0);
+    ArrayXd modelParameters(2);
+    modelParameters << 1.0, 0.05;
+
+    LineModel model(covariates);
+    mt19937 engine(42);
+    normal_distribution<> normal(0.0, 1.0);
+
+
+    // Moving-average errors e(n) = w(n) + 0.6 w(n-1) + 0.3 w(n-2) with white noise w,
+    // whose autocovariance vanishes beyond lag 2
+
+    ArrayXd autocovariance(3);
+    autocovariance << 1.0 + 0.36 + 0.09, 0.6 + 0.18, 0.3;
+
+    ArrayXd whiteNoise(N + 2);
+    for (int n = 0; n < N + 2; ++n) whiteNoise(n) = normal(engine);
+
+    ArrayXd observations(N);
+    model.predict(observations.setZero(), modelParameters);
+    for (int n = 0; n < N; ++n) observations(n) += whiteNoise(n+2) + 0.6 * whiteNoise(n+1) + 0.3 * whiteNoise(n);
+
+
+    // The same covariance matrix in banded, Toeplitz and dense form. For the banded form,
+    // the first 10 observations have larger errors, so that it is not Toeplitz.
+
+    ArrayXXd bandedCovariance(3, N);
+    for (int k = 0; k < 3; ++k) bandedCovariance.row(k).setConstant(autocovariance(k));
+    bandedCovariance.block(0, 0, 1, 10) += 4.0;
+
+    MatrixXd bandedDenseCovariance = MatrixXd::Zero(N, N);
+    MatrixXd toeplitzDenseCovariance = MatrixXd::Zero(N, N);
+
+    for (int n = 0; n < N; ++n)
+        for (int k = 0; k < 3 && k <= n; ++k)
+        {
+            bandedDenseCovariance(n, n-k) = bandedDenseCovariance(n-k, n) = bandedCovariance(k, n);
+            toeplitzDenseCovariance(n, n-k) = toeplitzDenseCovariance(n-k, n) = autocovariance(k);
+        }
+
+    CorrelatedNormalLikelihood bandedLikelihood(observations, bandedCovariance, model);
+    CorrelatedNormalLikelihood toeplitzLikelihood(observations, autocovariance, model, 1.e-12);
+
+    cerr << setprecision(12);
+
+    clock_t startTime = clock();
+    double logLikelihood = bandedLikelihood.logValue(modelParameters);
+    double time = double(clock() - startTime) / CLOCKS_PER_SEC;
+
+    startTime = clock();
+    double denseLogLikelihoodValue = denseLogLikelihood(bandedDenseCovariance, observations, model, modelParameters);
+    double denseTime = double(clock() - startTime) / CLOCKS_PER_SEC;
+
+    cerr << "Banded covariance (bandwidth " << bandedLikelihood.getBandwidth() << "), N = " << N << endl;
+    cerr << "    Factorized log-likelihood: " << logLikelihood << "   time = " << time << " s" << endl;
+    cerr << "    Dense log-likelihood:      " << denseLogLikelihoodValue << "   time = " << denseTime << " s" << endl;
+    cerr << endl;
+
+    startTime = clock();
+    logLikelihood = toeplitzLikelihood.logValue(modelParameters);
+    time = double(clock() - startTime) / CLOCKS_PER_SEC;
+
+    startTime = clock();
+    denseLogLikelihoodValue = denseLogLikelihood(toeplitzDenseCovariance, observations, model, modelParameters);
+    denseTime = double(clock() - startTime) / CLOCKS_PER_SEC;
+
+    cerr << "Toeplitz covariance (predictor order " << toeplitzLikelihood.getBandwidth() << "), N = " << N << endl;
+    cerr << "    Factorized log-likelihood: " << logLikelihood << "   time = " << time << " s" << endl;
+    cerr << "    Dense log-likelihood:      " << denseLogLikelihoodValue << "   time = " << denseTime << " s" << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+// Runs the nested sampler on the five 2D Gaussians with the fixed clustering
+// schedule (a new clustering every 20 iterations, after 100 iterations with a
+// single cluster), and with the clustering triggered by the drift of the live
+// sample, for a few run seeds. For each run, the number of calls to the clusterer
+// and the evidence are printed, so that both schedules can be compared.
+//
+// Compile with:
+// clang++ -o demoDriftTriggeredClustering demoDriftTriggeredClustering.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include "Functions.h"
+#include "MultiEllipsoidSampler.h"
+#include "KmeansClusterer.h"
+#include "EuclideanMetric.h"
+#include "UniformPrior.h"
+#include "ZeroModel.h"
+#include "PowerlawReducer.h"
+#include "RandomStreams.h"
+#include "demoFive2DGaussians.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Set up and run the nested sampler with the given run seed and clustering schedule
+
+void runWithSchedule(uint64_t runSeed, bool driftTriggeredClusteringIsEnabled,
+                     unsigned int &Nclusterings, double &logEvidence, double &logEvidenceError)
+{
+    RandomStreams::setRunSeed(runSeed);
+
+    ArrayXd covariates;
+    ArrayXd observations;
+    ZeroModel model(covariates);
+
+    int Ndimensions = 2;
+    vector<Prior*> ptrPriors(1);
+    ArrayXd parametersMinima(Ndimensions);
+    ArrayXd parametersMaxima(Ndimensions);
+    parametersMinima << -0.7, -0.7;
+    parametersMaxima << +1.0, +1.0;
+    UniformPrior uniformPrior(parametersMinima, parametersMaxima);
+    ptrPriors[0] = &uniformPrior;
+
+    Multiple2DGaussiansLikelihood likelihood(observations, model);
+    EuclideanMetric myMetric;
+    KmeansClusterer kmeans(myMetric, 1, 6, 10, 0.01);
+
+    bool printOnTheScreen = false;
+    int initialNobjects = 200;
+    int minNobjects = 200;
+    int maxNdrawAttempts = 20000;
+    int NinitialIterationsWithoutClustering = 100;
+    int NiterationsWithSameClustering = 20;
+    double initialEnlargementFraction = 10.0;
+    double shrinkingRate = 0.2;
+    double terminationFactor = 0.05;
+
+    MultiEllipsoidSampler nestedSampler(printOnTheScreen, ptrPriors, likelihood, myMetric, kmeans,
+                                        initialNobjects, minNobjects, initialEnlargementFraction, shrinkingRate);
+    PowerlawReducer livePointsReducer(nestedSampler, 1.e2, 0.4, terminationFactor);
+
+    nestedSampler.setDriftTriggeredClustering(driftTriggeredClusteringIsEnabled);
+    nestedSampler.run(livePointsReducer, NinitialIterationsWithoutClustering, NiterationsWithSameClustering,
+                      maxNdrawAttempts, terminationFactor, "demoDriftTriggeredClustering_");
+    nestedSampler.outputFile.close();
+
+    Nclusterings = nestedSampler.getNclusterings();
+    logEvidence = nestedSampler.getLogEvidence();
+    logEvidenceError = nestedSampler.getLogEvidenceError();
+}
+
+
+
+int main()
+{
+    uint64_t runSeeds[3] = {12345, 67890, 24680};
+    string scheduleNames[2] = {"fixed schedule ", "drift-triggered"};
+
+    cerr << fixed << setprecision(3);
+
+    for (int run = 0; run < 3; ++run)
+    {
+        for (int schedule = 0; schedule < 2; ++schedule)
+        {
+            unsigned int Nclusterings;
+            double logEvidence;
+            double logEvidenceError;
+
+            runWithSchedule(runSeeds[run], (schedule == 1), Nclusterings, logEvidence, logEvidenceError);
+
+            cerr << "Run seed " << runSeeds[run] << ", " << scheduleNames[schedule]
+                 << ":   clusterer calls = " << setw(4) << Nclusterings
+                 << "   log(E) = " << logEvidence << " +/- " << logEvidenceError << endl;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,150 @@
+// Writes a posterior-like sample of 10^6 points in 3 dimensions to ascii files,
+// once value by value through the stream (as File::arrayXXdToFile() used to do),
+// and once with File::arrayXXdToFile(), on an increasing number of threads.
+// The times needed are printed, and the files are compared byte by byte, for
+// several stream formats.
+//
+// Compile with:
+// clang++ -o demoFastTextWriter demoFastTextWriter.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register -pthread
+//
+
+#include <cstdlib>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <Eigen/Core>
+#include "File.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Write the array value by value through the stream, as a reference
+
+void writeValueByValue(ofstream &outputFile, const ArrayXXd &array, string separator, string terminator)
+{
+    for (ptrdiff_t i = 0; i < array.rows(); ++i)
+    {
+        for (ptrdiff_t j = 0; j < array.cols()-1; ++j)
+        {
+            outputFile << array(i,j) << separator;
+        }
+        outputFile << array(i,array.cols()-1) << terminator;
+    }
+}
+
+
+
+// Read a whole file into a string
+
+string fileContents(string fileName)
+{
+    ifstream inputFile(fileName.c_str(), ios::binary);
+    ostringstream contents;
+    contents << inputFile.rdbuf();
+    return contents.str();
+}
+
+
+
+int main()
+{
+    // Draw a sample with values of very different magnitudes, and a few special values
+
+    const int Npoints = 1000000;
+    mt19937 engine(1);
+    normal_distribution<> normal(0.0, 1.0);
+    ArrayXXd sample(Npoints, 3);
+
+    for (int i = 0; i < Npoints; ++i)
+    {
+        sample(i, 0) = 3090.0 + 0.5 * normal(engine);
+        sample(i, 1) = exp(20.0 * normal(engine));
+        sample(i, 2) = -1.e-3 * normal(engine);
+    }
+
+    sample(0, 0) = 0.0;
+    sample(1, 0) = -0.0;
+    sample(2, 0) = numeric_limits<double>::infinity();
+    sample(3, 0) = numeric_limits<double>::denorm_min();
+    sample(4, 0) = numeric_limits<double>::max();
+    sample(5, 0) = 0.5;
+
+
+    // Time the usual scientific format of the output files
+
+    auto startTime = chrono::steady_clock::now();
+
+    ofstream outputFile;
+    File::openOutputFile(outputFile, "demoFastTextWriter_reference.txt");
+    outputFile << setiosflags(ios::scientific) << setprecision(9);
+    writeValueByValue(outputFile, sample, "  ", "\n");
+    outputFile.close();
+
+    chrono::duration<double> referenceTime = chrono::steady_clock::now() - startTime;
+    cerr << setprecision(4);
+    cerr << "Value by value:                 " << referenceTime.count() << " s" << endl;
+
+    string referenceContents = fileContents("demoFastTextWriter_reference.txt");
+
+    for (int Nthreads = 1; Nthreads <= 4; Nthreads *= 2)
+    {
+        startTime = chrono::steady_clock::now();
+
+        File::openOutputFile(outputFile, "demoFastTextWriter_fast.txt");
+        outputFile << setiosflags(ios::scientific) << setprecision(9);
+        File::arrayXXdToFile(outputFile, sample, "  ", "\n", Nthreads);
+        outputFile.close();
+
+        chrono::duration<double> fastTime = chrono::steady_clock::now() - startTime;
+        bool filesAreIdentical = (fileContents("demoFastTextWriter_fast.txt") == referenceContents);
+
+        cerr << "File::arrayXXdToFile (" << Nthreads << " threads): " << fastTime.count() << " s   "
+             << (filesAreIdentical ? "identical" : "DIFFERENT") << endl;
+    }
+
+
+    // Compare the files for other stream formats, on a part of the sample
+
+    ArrayXXd head = sample.topRows(20000);
+    string formatNames[5] = {"default", "fixed, precision 3", "scientific, uppercase, showpos",
+                             "scientific, precision 15", "general, showpoint"};
+    cerr << endl;
+
+    for (int format = 0; format < 5; ++format)
+    {
+        string contents[2];
+
+        for (int writer = 0; writer < 2; ++writer)
+        {
+            File::openOutputFile(outputFile, "demoFastTextWriter_format.txt");
+
+            if (format == 1) outputFile << fixed << setprecision(3);
+            if (format == 2) outputFile << scientific << uppercase << showpos << setprecision(6);
+            if (format == 3) outputFile << scientific << setprecision(15);
+            if (format == 4) outputFile << showpoint << setprecision(4);
+
+            if (writer == 0)
+            {
+                writeValueByValue(outputFile, head, ",", "\n");
+            }
+            else
+            {
+                File::arrayXXdToFile(outputFile, head, ",", "\n", 2);
+            }
+
+            outputFile.close();
+            contents[writer] = fileContents("demoFastTextWriter_format.txt");
+        }
+
+        cerr << "Format " << formatNames[format] << ": " << (contents[0] == contents[1] ? "identical" : "DIFFERENT") << endl;
+    }
+
+    return EXIT_SUCCESS;
+}
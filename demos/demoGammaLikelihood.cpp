@@ -0,0 +1,121 @@
+// Fits the amplitude of a Harvey-like background to a simulated power spectrum of
+// 10^6 frequency bins, once with the ExponentialLikelihood on the full spectrum, and
+// once with the GammaLikelihood on the spectrum averaged over 10 bins. The maximum
+// likelihood amplitudes and their uncertainties, as well as the time needed per
+// likelihood evaluation, are compared.
+//
+// Compile with:
+// clang++ -o demoGammaLikelihood demoGammaLikelihood.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <Eigen/Core>
+#include "Functions.h"
+#include "Model.h"
+#include "ExponentialLikelihood.h"
+#include "GammaLikelihood.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Harvey-like background plus white noise, the only free parameter being the amplitude
+// of the background. The characteristic frequency and the white noise are fixed.
+
+class BackgroundModel : public Model
+{
+    public:
+
+        BackgroundModel(const RefArrayXd covariates)
+        : Model(covariates)
+        {
+            Nparameters = 1;
+        }
+
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) override
+        {
+            predictions += modelParameters(0) / (1.0 + (covariates / 100.0).square()) + 1.0;
+        }
+};
+
+
+
+// Scan the amplitude, and fit a parabola to the log-likelihood around its maximum
+// to obtain the maximum likelihood amplitude and its uncertainty.
+
+void fitAmplitude(string name, Likelihood &likelihood)
+{
+    int Namplitudes = 201;
+    ArrayXd amplitudes = ArrayXd::LinSpaced(Namplitudes, 9.9, 10.1);
+    ArrayXd logLikelihoods(Namplitudes);
+    ArrayXd amplitude(1);
+
+    clock_t startTime = clock();
+
+    for (int n = 0; n < Namplitudes; ++n)
+    {
+        amplitude << amplitudes(n);
+        logLikelihoods(n) = likelihood.logValue(amplitude);
+    }
+
+    double time = double(clock() - startTime) / CLOCKS_PER_SEC / Namplitudes;
+
+    int best;
+    logLikelihoods.maxCoeff(&best);
+    best = max(1, min(Namplitudes-2, best));
+
+    double step = amplitudes(1) - amplitudes(0);
+    double curvature = (logLikelihoods(best+1) - 2.0*logLikelihoods(best) + logLikelihoods(best-1)) / (step*step);
+    double slope = (logLikelihoods(best+1) - logLikelihoods(best-1)) / (2.0*step);
+
+    cerr << name << endl;
+    cerr << "    Amplitude = " << amplitudes(best) - slope/curvature << " +/- " << 1.0/sqrt(-curvature)
+         << "   time per evaluation = " << time << " s" << endl;
+}
+
+
+
+int main()
+{
+    int Nfrequencies = 1000000;
+    int Nbins = 10;
+    double trueAmplitude = 10.0;
+
+    ArrayXd frequencies = ArrayXd::LinSpaced(Nfrequencies, 0.01, 1000.0);
+    ArrayXd spectrum = ArrayXd::Zero(Nfrequencies);
+    ArrayXd amplitude(1);
+    amplitude << trueAmplitude;
+
+
+    // Each bin of the spectrum is exponentially distributed around the model
+
+    BackgroundModel model(frequencies);
+    model.predict(spectrum, amplitude);
+
+    mt19937 engine(42);
+    exponential_distribution<> exponential(1.0);
+    for (int n = 0; n < Nfrequencies; ++n) spectrum(n) *= exponential(engine);
+
+    ExponentialLikelihood exponentialLikelihood(spectrum, model);
+    fitAmplitude("Exponential likelihood, 1000000 bins", exponentialLikelihood);
+
+
+    // Average the spectrum over Nbins bins
+
+    ArrayXd rebinnedFrequencies, rebinnedSpectrum;
+    Functions::rebinSpectrum(frequencies, spectrum, Nbins, rebinnedFrequencies, rebinnedSpectrum);
+
+    BackgroundModel rebinnedModel(rebinnedFrequencies);
+    GammaLikelihood gammaLikelihood(rebinnedSpectrum, rebinnedModel, Nbins);
+    fitAmplitude("Gamma likelihood, 100000 bins averaged over 10", gammaLikelihood);
+
+    cerr << "True amplitude = " << trueAmplitude << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+// Checks the contract of logValue(modelParameters, logLikelihoodThreshold) for the
+// normal, mean normal and exponential likelihoods, on a spectrum of Lorentzian
+// profiles with 10^5 bins: when the log-likelihood is at least the threshold, the
+// returned value has to be exactly (bit for bit) the value of logValue(modelParameters),
+// and otherwise it has to be an upper bound of it, still below the threshold.
+// The thresholds are chosen just below, at, and just above the log-likelihood of
+// each point, and far away from it, for models that can and cannot predict segments
+// of the covariates. The demo also counts how many evaluations stopped early.
+//
+// Compile with:
+// clang++ -o demoLikelihoodThreshold demoLikelihoodThreshold.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <Eigen/Core>
+#include "Model.h"
+#include "NormalLikelihood.h"
+#include "MeanNormalLikelihood.h"
+#include "ExponentialLikelihood.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Flat background with Lorentzian modes. The model parameters are the background
+// followed by (centroid, height, linewidth) for each mode.
+
+class LorentzianModel : public Model
+{
+    public:
+
+        LorentzianModel(const RefArrayXd covariates, int Nmodes, bool segmentsArePredicted)
+        : Model(covariates), Nmodes(Nmodes), segmentsArePredicted(segmentsArePredicted)
+        {
+            Nparameters = 1 + 3 * Nmodes;
+        }
+
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) override
+        {
+            addProfiles(predictions, modelParameters, 0);
+        }
+
+        virtual void predictSegment(RefArrayXd predictions, const RefArrayXd modelParameters, const int beginIndex) override
+        {
+            addProfiles(predictions, modelParameters, beginIndex);
+        }
+
+        virtual bool canPredictSegments() override
+        {
+            return segmentsArePredicted;
+        }
+
+    private:
+
+        int Nmodes;
+        bool segmentsArePredicted;
+
+        void addProfiles(RefArrayXd predictions, const RefArrayXd modelParameters, const int beginIndex)
+        {
+            predictions += modelParameters(0);
+
+            for (int mode = 0; mode < Nmodes; ++mode)
+            {
+                double centroid = modelParameters(1 + 3*mode);
+                double height = modelParameters(2 + 3*mode);
+                double halfWidth = modelParameters(3 + 3*mode) / 2.0;
+                predictions += height / (1.0 + ((covariates.segment(beginIndex, predictions.size()) - centroid) / halfWidth).square());
+            }
+        }
+};
+
+
+
+// Check the contract for a set of parameters and thresholds around each log-likelihood.
+// Returns the number of violations, and adds the number of early stops to NstoppedEarly.
+
+int checkThresholds(Likelihood &likelihood, ArrayXXd &parameters, int &NstoppedEarly, int &Nevaluations)
+{
+    int Nviolations = 0;
+
+    for (int n = 0; n < parameters.cols(); ++n)
+    {
+        ArrayXd modelParameters = parameters.col(n);
+        const double logLikelihood = likelihood.logValue(modelParameters);
+        const double thresholds[] = {logLikelihood - 1e6, logLikelihood - 1.0, nextafter(logLikelihood, -INFINITY),
+                                     logLikelihood, nextafter(logLikelihood, INFINITY), logLikelihood + 1.0,
+                                     logLikelihood + 1e6};
+
+        for (double threshold : thresholds)
+        {
+            const double value = likelihood.logValue(modelParameters, threshold);
+            ++Nevaluations;
+
+            if (logLikelihood >= threshold)
+            {
+                // The exact value is needed
+
+                if (value != logLikelihood) ++Nviolations;
+            }
+            else
+            {
+                // An upper bound below the threshold is enough
+
+                if (!((value >= logLikelihood) && (value < threshold))) ++Nviolations;
+                if (value != logLikelihood) ++NstoppedEarly;
+            }
+        }
+    }
+
+    return Nviolations;
+}
+
+
+
+int main()
+{
+    const int Nbins = 100000;
+    const int Nmodes = 10;
+    const int Npoints = 50;
+
+    mt19937 engine(2024);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    exponential_distribution<double> exponential(1.0);
+    normal_distribution<double> normal(0.0, 1.0);
+
+
+    // The true parameters, and the simulated spectra
+
+    ArrayXd frequencies = ArrayXd::LinSpaced(Nbins, 100.0, 1100.0);
+    ArrayXd trueParameters(1 + 3 * Nmodes);
+    trueParameters(0) = 5.0;
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        trueParameters(1 + 3*mode) = 150.0 + 90.0 * mode;
+        trueParameters(2 + 3*mode) = 50.0 + 100.0 * uniform(engine);
+        trueParameters(3 + 3*mode) = 1.0 + 2.0 * uniform(engine);
+    }
+
+    LorentzianModel trueModel(frequencies, Nmodes, true);
+    ArrayXd truth = ArrayXd::Zero(Nbins);
+    trueModel.predict(truth, trueParameters);
+
+    ArrayXd uncertainties = 0.1 * truth;
+    ArrayXd powerSpectrum(Nbins);
+    ArrayXd normalSpectrum(Nbins);
+
+    for (int i = 0; i < Nbins; ++i)
+    {
+        powerSpectrum(i) = truth(i) * exponential(engine);
+        normalSpectrum(i) = truth(i) + uncertainties(i) * normal(engine);
+    }
+
+
+    // Points close to and far from the true parameters
+
+    ArrayXXd parameters(trueParameters.size(), Npoints);
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        const double spread = (n < Npoints/2) ? 0.001 : 0.1;
+
+        for (int k = 0; k < trueParameters.size(); ++k)
+        {
+            parameters(k, n) = trueParameters(k) * (1.0 + spread * (2.0 * uniform(engine) - 1.0));
+        }
+    }
+
+    bool contractHolds = true;
+
+    for (int segments = 0; segments < 2; ++segments)
+    {
+        LorentzianModel model(frequencies, Nmodes, segments == 1);
+        NormalLikelihood normalLikelihood(normalSpectrum, uncertainties, model);
+        MeanNormalLikelihood meanNormalLikelihood(normalSpectrum, uncertainties, model);
+        ExponentialLikelihood exponentialLikelihood(powerSpectrum, model);
+
+        Likelihood *likelihoods[] = {&normalLikelihood, &meanNormalLikelihood, &exponentialLikelihood};
+        const string names[] = {"NormalLikelihood", "MeanNormalLikelihood", "ExponentialLikelihood"};
+
+        cout << ((segments == 1) ? "Model predicting segments of the covariates" : "Model predicting all covariates at once") << endl;
+
+        for (int k = 0; k < 3; ++k)
+        {
+            int NstoppedEarly = 0;
+            int Nevaluations = 0;
+            const int Nviolations = checkThresholds(*likelihoods[k], parameters, NstoppedEarly, Nevaluations);
+
+            contractHolds = contractHolds && (Nviolations == 0);
+
+            cout << "    " << left << setw(24) << names[k] << right << Nviolations << " violations in " << Nevaluations
+                 << " evaluations, " << NstoppedEarly << " stopped early" << endl;
+        }
+    }
+
+    cout << (contractHolds ? "The threshold contract holds." : "The threshold contract is violated!") << endl;
+
+    return contractHolds ? EXIT_SUCCESS : EXIT_FAILURE;
+}
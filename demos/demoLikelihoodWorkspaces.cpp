@@ -0,0 +1,222 @@
+// Checks that the per-thread workspaces of the likelihoods give bit-identical
+// log-likelihoods, whatever the number of threads. The normal, mean normal and
+// exponential likelihoods of a spectrum of Lorentzian profiles are evaluated
+//   - by a single caller, with the observations split over 1, 2 and 4 threads,
+//   - by 4 callers sharing the same likelihood object concurrently, each with its
+//     own prediction buffers, with the observations split over 1 and 2 threads,
+// both for a model that predicts all covariates at once (the predictions are stored
+// in the workspace of the caller) and for a model that predicts segments of them
+// (each thread of the pool uses its own segment buffer). Every evaluation is done
+// twice, so that the buffers are reused, and compared with a serial evaluation.
+//
+// Compile with:
+// clang++ -o demoLikelihoodWorkspaces demoLikelihoodWorkspaces.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register -pthread
+//
+
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Eigen/Core>
+#include "Model.h"
+#include "NormalLikelihood.h"
+#include "MeanNormalLikelihood.h"
+#include "ExponentialLikelihood.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Flat background with Lorentzian modes. The model parameters are the background
+// followed by (centroid, height, linewidth) for each mode.
+
+class LorentzianModel : public Model
+{
+    public:
+
+        LorentzianModel(const RefArrayXd covariates, int Nmodes, bool segmentsArePredicted)
+        : Model(covariates), Nmodes(Nmodes), segmentsArePredicted(segmentsArePredicted)
+        {
+            Nparameters = 1 + 3 * Nmodes;
+        }
+
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) override
+        {
+            addProfiles(predictions, modelParameters, 0);
+        }
+
+        virtual void predictSegment(RefArrayXd predictions, const RefArrayXd modelParameters, const int beginIndex) override
+        {
+            addProfiles(predictions, modelParameters, beginIndex);
+        }
+
+        virtual bool canPredictSegments() override
+        {
+            return segmentsArePredicted;
+        }
+
+    private:
+
+        int Nmodes;
+        bool segmentsArePredicted;
+
+        void addProfiles(RefArrayXd predictions, const RefArrayXd modelParameters, const int beginIndex)
+        {
+            predictions += modelParameters(0);
+
+            for (int mode = 0; mode < Nmodes; ++mode)
+            {
+                double centroid = modelParameters(1 + 3*mode);
+                double height = modelParameters(2 + 3*mode);
+                double halfWidth = modelParameters(3 + 3*mode) / 2.0;
+                predictions += height / (1.0 + ((covariates.segment(beginIndex, predictions.size()) - centroid) / halfWidth).square());
+            }
+        }
+};
+
+
+
+// Evaluate the points firstPoint, firstPoint + step, ... twice, and store the results of the second pass
+
+void evaluate(Likelihood &likelihood, ArrayXXd &parameters, ArrayXd &logLikelihoods, int firstPoint, int step)
+{
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int n = firstPoint; n < parameters.cols(); n += step)
+        {
+            ArrayXd modelParameters = parameters.col(n);
+            logLikelihoods(n) = likelihood.logValue(modelParameters);
+        }
+    }
+}
+
+
+
+// Evaluate all points with Ncallers threads calling the same likelihood concurrently
+
+void evaluateConcurrently(Likelihood &likelihood, ArrayXXd &parameters, ArrayXd &logLikelihoods, int Ncallers)
+{
+    vector<thread> callers;
+
+    for (int caller = 0; caller < Ncallers; ++caller)
+    {
+        callers.push_back(thread(evaluate, ref(likelihood), ref(parameters), ref(logLikelihoods), caller, Ncallers));
+    }
+
+    for (thread &caller : callers)
+    {
+        caller.join();
+    }
+}
+
+
+
+int main()
+{
+    const int Nbins = 200000;
+    const int Nmodes = 5;
+    const int Npoints = 16;
+    const int Ncallers = 4;
+
+    mt19937 engine(7);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    exponential_distribution<double> exponential(1.0);
+    normal_distribution<double> normal(0.0, 1.0);
+
+
+    // The true parameters, and the simulated spectra
+
+    ArrayXd frequencies = ArrayXd::LinSpaced(Nbins, 100.0, 1100.0);
+    ArrayXd trueParameters(1 + 3 * Nmodes);
+    trueParameters(0) = 5.0;
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        trueParameters(1 + 3*mode) = 200.0 + 180.0 * mode;
+        trueParameters(2 + 3*mode) = 50.0 + 100.0 * uniform(engine);
+        trueParameters(3 + 3*mode) = 1.0 + 2.0 * uniform(engine);
+    }
+
+    LorentzianModel trueModel(frequencies, Nmodes, true);
+    ArrayXd truth = ArrayXd::Zero(Nbins);
+    trueModel.predict(truth, trueParameters);
+
+    ArrayXd uncertainties = 0.1 * truth;
+    ArrayXd powerSpectrum(Nbins);
+    ArrayXd normalSpectrum(Nbins);
+
+    for (int i = 0; i < Nbins; ++i)
+    {
+        powerSpectrum(i) = truth(i) * exponential(engine);
+        normalSpectrum(i) = truth(i) + uncertainties(i) * normal(engine);
+    }
+
+    ArrayXXd parameters(trueParameters.size(), Npoints);
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        for (int k = 0; k < trueParameters.size(); ++k)
+        {
+            parameters(k, n) = trueParameters(k) * (1.0 + 0.01 * (2.0 * uniform(engine) - 1.0));
+        }
+    }
+
+    bool allIdentical = true;
+
+    for (int segments = 0; segments < 2; ++segments)
+    {
+        LorentzianModel model(frequencies, Nmodes, segments == 1);
+        NormalLikelihood normalLikelihood(normalSpectrum, uncertainties, model);
+        MeanNormalLikelihood meanNormalLikelihood(normalSpectrum, uncertainties, model);
+        ExponentialLikelihood exponentialLikelihood(powerSpectrum, model);
+
+        Likelihood *likelihoods[] = {&normalLikelihood, &meanNormalLikelihood, &exponentialLikelihood};
+        const string names[] = {"NormalLikelihood", "MeanNormalLikelihood", "ExponentialLikelihood"};
+
+        cout << ((segments == 1) ? "Model predicting segments of the covariates" : "Model predicting all covariates at once") << endl;
+
+        for (int k = 0; k < 3; ++k)
+        {
+            Likelihood &likelihood = *likelihoods[k];
+            ArrayXd serialLogLikelihoods(Npoints);
+            ArrayXd logLikelihoods(Npoints);
+
+            likelihood.setNthreads(1);
+            evaluate(likelihood, parameters, serialLogLikelihoods, 0, 1);
+
+            cout << "    " << names[k] << endl;
+
+            for (int Nthreads = 2; Nthreads <= 4; Nthreads *= 2)
+            {
+                likelihood.setNthreads(Nthreads);
+                evaluate(likelihood, parameters, logLikelihoods, 0, 1);
+
+                const bool identical = (logLikelihoods == serialLogLikelihoods).all();
+                allIdentical = allIdentical && identical;
+
+                cout << "        1 caller,  " << Nthreads << " threads: identical to 1 thread: " << identical << endl;
+            }
+
+            for (int Nthreads = 1; Nthreads <= 2; ++Nthreads)
+            {
+                likelihood.setNthreads(Nthreads);
+                logLikelihoods.setZero();
+                evaluateConcurrently(likelihood, parameters, logLikelihoods, Ncallers);
+
+                const bool identical = (logLikelihoods == serialLogLikelihoods).all();
+                allIdentical = allIdentical && identical;
+
+                cout << "        " << Ncallers << " callers, " << Nthreads << " thread(s): identical to 1 thread: " << identical << endl;
+            }
+        }
+    }
+
+    cout << (allIdentical ? "All log-likelihoods are bit-identical." : "Some log-likelihoods differ!") << endl;
+
+    return allIdentical ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,157 @@
+// Fits a sinusoid with unknown frequency, offset, and cosine and sine amplitudes
+// to noisy data. Only the frequency is a free parameter: the offset and both
+// amplitudes enter the model linearly and are marginalized analytically by the
+// normal likelihood. The marginalized likelihood is compared with a brute-force
+// numerical integration over the linear parameters, and the best-fitting linear
+// parameters are recovered at the peak of the frequency scan.
+//
+// Compile with:
+// clang++ -o demoLinearParameterMarginalization demoLinearParameterMarginalization.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <Eigen/Core>
+#include "Functions.h"
+#include "Model.h"
+#include "NormalLikelihood.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// y(t) = offset + a * cos(2 pi f t) + b * sin(2 pi f t)
+// The free parameter is the frequency f, the linear parameters are (offset, a, b).
+
+class SinusoidModel : public Model
+{
+    public:
+
+        SinusoidModel(const RefArrayXd covariates)
+        : Model(covariates)
+        {
+            Nparameters = 1;
+        }
+
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) override
+        {
+            // The model has no non-linear part besides the design matrix
+        }
+
+        virtual int getNlinearParameters() override
+        {
+            return 3;
+        }
+
+        virtual void predictDesignMatrix(RefArrayXXd designMatrix, const RefArrayXd modelParameters) override
+        {
+            ArrayXd phases = 2.0 * Functions::PI * modelParameters(0) * covariates;
+
+            designMatrix.col(0) += 1.0;
+            designMatrix.col(1) += phases.cos();
+            designMatrix.col(2) += phases.sin();
+        }
+};
+
+
+
+int main()
+{
+    // Simulate the data
+
+    int Nobservations = 40;
+    double trueFrequency = 0.3;
+    ArrayXd trueLinearParameters(3);
+    trueLinearParameters << 1.0, 2.0, -1.0;
+
+    mt19937 engine(3);
+    normal_distribution<> normal(0.0, 1.0);
+    ArrayXd covariates = ArrayXd::LinSpaced(Nobservations, 0.0, 10.0);
+    ArrayXd uncertainties = ArrayXd::Constant(Nobservations, 0.5);
+    ArrayXd observations(Nobservations);
+
+    for (int n = 0; n < Nobservations; ++n)
+    {
+        double phase = 2.0 * Functions::PI * trueFrequency * covariates(n);
+        observations(n) = trueLinearParameters(0) + trueLinearParameters(1) * cos(phase)
+                          + trueLinearParameters(2) * sin(phase) + uncertainties(n) * normal(engine);
+    }
+
+    SinusoidModel model(covariates);
+    NormalLikelihood likelihood(observations, uncertainties, model);
+
+
+    // Uniform prior between minimum and maximum for each of the linear parameters
+
+    double minimum = -2.0;
+    double maximum = 5.0;
+    likelihood.setLinearParametersLogPriorVolume(3.0 * log(maximum - minimum));
+
+
+    // Compare with a brute-force integration over the linear parameters at the true frequency
+
+    ArrayXd frequency(1);
+    frequency << trueFrequency;
+    double marginalizedLogLikelihood = likelihood.logValue(frequency);
+
+    ArrayXXd designMatrix = ArrayXXd::Zero(Nobservations, 3);
+    model.predictDesignMatrix(designMatrix, frequency);
+
+    int Nsteps = 140;
+    double step = (maximum - minimum) / Nsteps;
+    ArrayXd logLikelihoods(Nsteps * Nsteps * Nsteps);
+    ArrayXd linearParameters(3);
+    int index = 0;
+
+    for (int i = 0; i < Nsteps; ++i)
+        for (int j = 0; j < Nsteps; ++j)
+            for (int k = 0; k < Nsteps; ++k)
+            {
+                linearParameters << minimum + (i + 0.5) * step, minimum + (j + 0.5) * step, minimum + (k + 0.5) * step;
+                ArrayXd residuals = observations - (designMatrix.matrix() * linearParameters.matrix()).array();
+                logLikelihoods(index++) = -0.5 * Nobservations * Nobservations * log(2.0*Functions::PI)
+                                          - uncertainties.log().sum() - 0.5 * (residuals / uncertainties).square().sum();
+            }
+
+    double maxLogLikelihood = logLikelihoods.maxCoeff();
+    double bruteForceLogLikelihood = maxLogLikelihood + log((logLikelihoods - maxLogLikelihood).exp().sum())
+                                     + 3.0 * log(step) - 3.0 * log(maximum - minimum);
+
+    cerr << setprecision(8);
+    cerr << "Marginalized log-likelihood at the true frequency:  " << marginalizedLogLikelihood << endl;
+    cerr << "Brute-force integration on a " << Nsteps << "^3 grid:         " << bruteForceLogLikelihood << endl;
+    cerr << endl;
+
+
+    // Scan the frequency. A sampler only needs to explore this single parameter.
+
+    int Nfrequencies = 1000;
+    ArrayXd frequencies = ArrayXd::LinSpaced(Nfrequencies, 0.05, 1.0);
+    double bestFrequency = 0.0;
+    double bestLogLikelihood = -numeric_limits<double>::max();
+
+    for (int n = 0; n < Nfrequencies; ++n)
+    {
+        frequency << frequencies(n);
+        double logLikelihood = likelihood.logValue(frequency);
+
+        if (logLikelihood > bestLogLikelihood)
+        {
+            bestLogLikelihood = logLikelihood;
+            bestFrequency = frequencies(n);
+        }
+    }
+
+    frequency << bestFrequency;
+    ArrayXd bestLinearParameters = likelihood.getLinearParameters(frequency);
+
+    cerr << "Frequency scan:  best frequency = " << bestFrequency << "  (true: " << trueFrequency << ")" << endl;
+    cerr << "Best-fitting linear parameters:   " << bestLinearParameters.transpose() << endl;
+    cerr << "True linear parameters:           " << trueLinearParameters.transpose() << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+// Runs the nested sampler on the five 2D Gaussians with the k-d tree over the
+// live points enabled, and checks the tree against brute force at the end of 
+// the run: the tree has to contain the final live sample, after all the 
+// replacements and removals of live points, and its nearest-neighbour and 
+// radius queries have to return the same points as an exhaustive search.
+// The time of the run without the tree is printed too, since the sampler
+// itself does not query the tree.
+//
+// Compile with:
+// clang++ -o demoLivePointsTree demoLivePointsTree.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <algorithm>
+#include "Functions.h"
+#include "MultiEllipsoidSampler.h"
+#include "KmeansClusterer.h"
+#include "EuclideanMetric.h"
+#include "UniformPrior.h"
+#include "ZeroModel.h"
+#include "PowerlawReducer.h"
+#include "RandomStreams.h"
+#include "KdTree.h"
+#include "demoFive2DGaussians.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Indices of the Nneighbours points of the sample closest to the query point, by exhaustive search
+
+vector<int> bruteForceNearestNeighbours(ArrayXXd &sample, ArrayXd &queryPoint, int Nneighbours)
+{
+    vector<pair<double,int>> squaredDistances(sample.cols());
+
+    for (int i = 0; i < sample.cols(); ++i)
+    {
+        squaredDistances[i] = make_pair((sample.col(i) - queryPoint).square().sum(), i);
+    }
+
+    sort(squaredDistances.begin(), squaredDistances.end());
+
+    vector<int> neighbourIndices(Nneighbours);
+
+    for (int n = 0; n < Nneighbours; ++n)
+    {
+        neighbourIndices[n] = squaredDistances[n].second;
+    }
+
+    return neighbourIndices;
+}
+
+
+
+// Sorted indices of the points of the sample within the radius from the query point, by exhaustive search
+
+vector<int> bruteForcePointsWithinRadius(ArrayXXd &sample, ArrayXd &queryPoint, double radius)
+{
+    vector<int> pointIndices;
+
+    for (int i = 0; i < sample.cols(); ++i)
+    {
+        if ((sample.col(i) - queryPoint).square().sum() <= radius * radius)
+        {
+            pointIndices.push_back(i);
+        }
+    }
+
+    return pointIndices;
+}
+
+
+
+// Run the nested sampler with or without the tree, and return the time of the run in seconds
+
+double runNestedSampler(bool livePointsTreeIsEnabled, ArrayXXd &liveSample, ArrayXXd &treeSample, 
+                        int &NwrongNeighbours, int &NwrongRanges, int Nqueries)
+{
+    RandomStreams::setRunSeed(12345);
+
+    ArrayXd covariates;
+    ArrayXd observations;
+    ZeroModel model(covariates);
+
+    int Ndimensions = 2;
+    vector<Prior*> ptrPriors(1);
+    ArrayXd parametersMinima(Ndimensions);
+    ArrayXd parametersMaxima(Ndimensions);
+    parametersMinima << -0.7, -0.7;
+    parametersMaxima << +1.0, +1.0;
+    UniformPrior uniformPrior(parametersMinima, parametersMaxima);
+    ptrPriors[0] = &uniformPrior;
+
+    Multiple2DGaussiansLikelihood likelihood(observations, model);
+    EuclideanMetric myMetric;
+    KmeansClusterer kmeans(myMetric, 1, 6, 10, 0.01);
+
+    bool printOnTheScreen = false;
+    int initialNobjects = 500;
+    int minNobjects = 200;
+    int maxNdrawAttempts = 20000;
+    int NinitialIterationsWithoutClustering = 100;
+    int NiterationsWithSameClustering = 20;
+    double initialEnlargementFraction = 10.0;
+    double shrinkingRate = 0.2;
+    double terminationFactor = 0.05;
+
+    MultiEllipsoidSampler nestedSampler(printOnTheScreen, ptrPriors, likelihood, myMetric, kmeans,
+                                        initialNobjects, minNobjects, initialEnlargementFraction, shrinkingRate);
+    PowerlawReducer livePointsReducer(nestedSampler, 1.e2, 0.4, terminationFactor);
+
+    nestedSampler.setLivePointsTreeEnabled(livePointsTreeIsEnabled);
+
+    clock_t startTime = clock();
+    nestedSampler.run(livePointsReducer, NinitialIterationsWithoutClustering, NiterationsWithSameClustering,
+                      maxNdrawAttempts, terminationFactor, "demoLivePointsTree_");
+    double time = double(clock() - startTime) / CLOCKS_PER_SEC;
+    nestedSampler.outputFile.close();
+
+    if (!livePointsTreeIsEnabled) return time;
+
+
+    // Compare the tree with the final live sample, and its queries with brute force
+
+    KdTree &livePointsTree = nestedSampler.getLivePointsTree();
+    liveSample = nestedSampler.getNestedSample();
+    treeSample = livePointsTree.getSample();
+
+    mt19937 engine(42);
+    uniform_real_distribution<> uniform(-0.7, 1.0);
+    int Nneighbours = 10;
+    double radius = 0.1;
+    NwrongNeighbours = 0;
+    NwrongRanges = 0;
+
+    for (int n = 0; n < Nqueries; ++n)
+    {
+        ArrayXd queryPoint(Ndimensions);
+        queryPoint << uniform(engine), uniform(engine);
+
+        vector<int> neighbourIndices;
+        vector<double> neighbourDistances;
+        livePointsTree.findNearestNeighbours(queryPoint, Nneighbours, neighbourIndices, neighbourDistances);
+
+        if (neighbourIndices != bruteForceNearestNeighbours(liveSample, queryPoint, Nneighbours)) NwrongNeighbours++;
+
+        vector<int> pointIndices = livePointsTree.findPointsWithinRadius(queryPoint, radius);
+        sort(pointIndices.begin(), pointIndices.end());
+
+        if (pointIndices != bruteForcePointsWithinRadius(liveSample, queryPoint, radius)) NwrongRanges++;
+    }
+
+    return time;
+}
+
+
+
+int main()
+{
+    ArrayXXd liveSample;
+    ArrayXXd treeSample;
+    int NwrongNeighbours;
+    int NwrongRanges;
+    int Nqueries = 1000;
+
+    double timeWithTree = runNestedSampler(true, liveSample, treeSample, NwrongNeighbours, NwrongRanges, Nqueries);
+    double timeWithoutTree = runNestedSampler(false, liveSample, treeSample, NwrongNeighbours, NwrongRanges, Nqueries);
+
+    bool treeHoldsLiveSample = (treeSample.rows() == liveSample.rows()) && (treeSample.cols() == liveSample.cols())
+                               && (treeSample == liveSample).all();
+
+    cerr << "Final live points:                                  " << liveSample.cols() << endl;
+    cerr << "Tree holds the final live sample:                   " << treeHoldsLiveSample << endl;
+    cerr << "Wrong 10-nearest-neighbour queries:                 " << NwrongNeighbours << " of " << Nqueries << endl;
+    cerr << "Wrong radius queries:                               " << NwrongRanges << " of " << Nqueries << endl;
+    cerr << "Time of the run with / without the tree:            " << timeWithTree << " s / " << timeWithoutTree << " s" << endl;
+
+    return EXIT_SUCCESS;
+}
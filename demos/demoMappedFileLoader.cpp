@@ -0,0 +1,102 @@
+// Writes a power spectrum of 10^6 rows to an ascii file, and reads it back once
+// with File::sniffFile() and File::arrayXXdFromFile(), and once with the single-pass
+// File::arrayXXdFromMappedFile() on an increasing number of threads. The times
+// needed and the largest difference between the arrays are printed. A small file
+// with comments, blank lines and numbers in various formats is read as well.
+//
+// Compile with:
+// clang++ -o demoMappedFileLoader demoMappedFileLoader.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register -pthread
+//
+
+#include <cstdlib>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <Eigen/Core>
+#include "File.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+int main()
+{
+    // Write a spectrum with frequencies, power densities and uncertainties
+
+    const int Nrows = 1000000;
+    string fileName = "demoMappedFileLoader_spectrum.txt";
+    mt19937 engine(42);
+    exponential_distribution<> exponential(1.0);
+
+    ArrayXXd spectrum(Nrows, 3);
+
+    for (int i = 0; i < Nrows; ++i)
+    {
+        spectrum(i, 0) = 0.01 * (i + 1);
+        spectrum(i, 1) = 3.5e3 / (1.0 + pow(spectrum(i, 0) / 120.0, 2)) * exponential(engine);
+        spectrum(i, 2) = 0.1 * spectrum(i, 1);
+    }
+
+    ofstream outputFile;
+    File::openOutputFile(outputFile, fileName);
+    outputFile << "# Frequency [muHz]   PSD [ppm^2/muHz]   Uncertainty [ppm^2/muHz]" << endl;
+    outputFile << setiosflags(ios::scientific) << setprecision(9);
+    File::arrayXXdToFile(outputFile, spectrum);
+    outputFile.close();
+
+
+    // Read it with the stream-based functions
+
+    auto startTime = chrono::steady_clock::now();
+
+    ifstream inputFile;
+    unsigned long NrowsInFile;
+    int NcolsInFile;
+    File::openInputFile(inputFile, fileName);
+    File::sniffFile(inputFile, NrowsInFile, NcolsInFile);
+    ArrayXXd streamArray = File::arrayXXdFromFile(inputFile, NrowsInFile, NcolsInFile);
+    inputFile.close();
+
+    chrono::duration<double> streamTime = chrono::steady_clock::now() - startTime;
+
+    cerr << setprecision(4);
+    cerr << "sniffFile + arrayXXdFromFile:           " << streamTime.count() << " s" << endl;
+
+
+    // Read it with the memory-mapped loader
+
+    for (int Nthreads = 1; Nthreads <= 4; Nthreads *= 2)
+    {
+        startTime = chrono::steady_clock::now();
+
+        ArrayXXd mappedArray = File::arrayXXdFromMappedFile(fileName, ' ', '#', Nthreads);
+
+        chrono::duration<double> mappedTime = chrono::steady_clock::now() - startTime;
+
+        cerr << "arrayXXdFromMappedFile (" << Nthreads << " threads):   " << mappedTime.count() << " s   "
+             << "size " << mappedArray.rows() << " x " << mappedArray.cols() << "   "
+             << "max difference: " << (mappedArray - streamArray).abs().maxCoeff() << endl;
+    }
+
+
+    // A small file with comments, blank lines, tabs and numbers in various formats
+
+    string smallFileName = "demoMappedFileLoader_formats.txt";
+    File::openOutputFile(outputFile, smallFileName);
+    outputFile << "# Comment line" << endl
+               << "1  -2.5  +3e2" << endl
+               << endl
+               << "  \t " << endl
+               << "0.1\t1.7976931348623157e308  -4.9406564584124654e-324" << endl
+               << "123456789012345678901234567890  .5  5." << endl
+               << "3.14159265358979323846264338327950288  -0.0  1E-5";
+    outputFile.close();
+
+    ArrayXXd smallArray = File::arrayXXdFromMappedFile(smallFileName);
+    cerr << endl << setprecision(17) << smallArray << endl;
+
+    return EXIT_SUCCESS;
+}
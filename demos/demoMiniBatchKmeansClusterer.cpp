@@ -0,0 +1,163 @@
+// Compares the mini-batch k-means clusterer with the full k-means clusterer
+// on the k-means test samples, and on a large (20000 points) sample obtained
+// by resampling them.
+//
+// Compile with:
+// clang++ -o demoMiniBatchKmeansClusterer demoMiniBatchKmeansClusterer.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <random>
+#include <vector>
+#include <Eigen/Core>
+#include "File.h"
+#include "EuclideanMetric.h"
+#include "KmeansClusterer.h"
+#include "MiniBatchKmeansClusterer.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Sum over all points of the distance to the barycenter of their cluster
+
+double sumOfDistancesToBarycenters(ArrayXXd &sample, vector<int> &clusterIndices, int Nclusters, Metric &metric)
+{
+    ArrayXXd barycenters = ArrayXXd::Zero(sample.rows(), Nclusters);
+    ArrayXd clusterSizes = ArrayXd::Zero(Nclusters);
+
+    for (int n = 0; n < sample.cols(); ++n)
+    {
+        barycenters.col(clusterIndices[n]) += sample.col(n);
+        clusterSizes(clusterIndices[n]) += 1;
+    }
+
+    barycenters.rowwise() /= clusterSizes.transpose();
+
+    double sumOfDistances = 0.0;
+
+    for (int n = 0; n < sample.cols(); ++n)
+    {
+        sumOfDistances += metric.distance(sample.col(n), barycenters.col(clusterIndices[n]));
+    }
+
+    return sumOfDistances;
+}
+
+
+
+// Rand index: the fraction of pairs of points on which both clusterings agree
+// (either both in the same cluster, or both in different clusters).
+// Estimated from a random subset of pairs for large samples.
+
+double randIndex(vector<int> &clusterIndices1, vector<int> &clusterIndices2, mt19937 &engine)
+{
+    int Npoints = clusterIndices1.size();
+    int Npairs = 200000;
+    uniform_int_distribution<> uniform(0, Npoints-1);
+    int Nagreements = 0;
+
+    for (int m = 0; m < Npairs; ++m)
+    {
+        int i = uniform(engine);
+        int j = uniform(engine);
+        bool sameCluster1 = (clusterIndices1[i] == clusterIndices1[j]);
+        bool sameCluster2 = (clusterIndices2[i] == clusterIndices2[j]);
+        if (sameCluster1 == sameCluster2) Nagreements++;
+    }
+
+    return Nagreements / double(Npairs);
+}
+
+
+
+// Cluster the sample with both clusterers and print the comparison
+
+void compareClusterers(string sampleName, ArrayXXd &sample, KmeansClusterer &kmeans,
+                       MiniBatchKmeansClusterer &miniBatchKmeans, Metric &metric, mt19937 &engine)
+{
+    int Npoints = sample.cols();
+    vector<int> clusterIndices(Npoints);
+    vector<int> miniBatchClusterIndices(Npoints);
+    vector<int> clusterSizes;
+
+    clock_t startTime = clock();
+    int Nclusters = kmeans.cluster(sample, clusterIndices, clusterSizes);
+    double time = double(clock() - startTime) / CLOCKS_PER_SEC;
+
+    startTime = clock();
+    int miniBatchNclusters = miniBatchKmeans.cluster(sample, miniBatchClusterIndices, clusterSizes);
+    double miniBatchTime = double(clock() - startTime) / CLOCKS_PER_SEC;
+
+    double sumOfDistances = sumOfDistancesToBarycenters(sample, clusterIndices, Nclusters, metric);
+    double miniBatchSumOfDistances = sumOfDistancesToBarycenters(sample, miniBatchClusterIndices, miniBatchNclusters, metric);
+
+    cerr << sampleName << " (" << Npoints << " points)" << endl;
+    cerr << "    Full k-means:       Nclusters = " << setw(2) << Nclusters
+         << "   sum of distances = " << setw(12) << sumOfDistances
+         << "   time = " << time << " s" << endl;
+    cerr << "    Mini-batch k-means: Nclusters = " << setw(2) << miniBatchNclusters
+         << "   sum of distances = " << setw(12) << miniBatchSumOfDistances
+         << "   time = " << miniBatchTime << " s" << endl;
+    cerr << "    Relative increase of sum of distances: " << (miniBatchSumOfDistances - sumOfDistances) / sumOfDistances << endl;
+    cerr << "    Rand index between both clusterings:   " << randIndex(clusterIndices, miniBatchClusterIndices, engine) << endl;
+    cerr << endl;
+}
+
+
+
+int main()
+{
+    EuclideanMetric myMetric;
+    int minNclusters = 2;
+    int maxNclusters = 10;
+    int Ntrials = 10;
+    double relTolerance = 0.01;
+    int batchSize = 256;
+    int maxNepochs = 100;
+
+    KmeansClusterer kmeans(myMetric, minNclusters, maxNclusters, Ntrials, relTolerance);
+    MiniBatchKmeansClusterer miniBatchKmeans(myMetric, minNclusters, maxNclusters, Ntrials, relTolerance, batchSize, maxNepochs);
+
+    mt19937 engine(42);
+    normal_distribution<> normal(0.0, 0.02);
+    vector<string> fileNames = {"kmeans_testsample2D.txt", "kmeans_testsample5D.txt"};
+
+    for (auto fileName : fileNames)
+    {
+        // Read the test sample
+
+        ifstream inputFile;
+        File::openInputFile(inputFile, fileName);
+        unsigned long Nrows;
+        int Ncols;
+        File::sniffFile(inputFile, Nrows, Ncols);
+        ArrayXXd data = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
+        ArrayXXd sample = data.transpose();
+        inputFile.close();
+
+        compareClusterers(fileName, sample, kmeans, miniBatchKmeans, myMetric, engine);
+
+
+        // Build a large sample by resampling the test sample with a small jitter
+
+        int NlargeSample = 20000;
+        uniform_int_distribution<> uniform(0, Nrows-1);
+        ArrayXXd largeSample(Ncols, NlargeSample);
+
+        for (int n = 0; n < NlargeSample; ++n)
+        {
+            largeSample.col(n) = sample.col(uniform(engine));
+            for (int i = 0; i < Ncols; ++i) largeSample(i,n) += normal(engine);
+        }
+
+        compareClusterers(fileName + ", resampled", largeSample, kmeans, miniBatchKmeans, myMetric, engine);
+    }
+
+    return EXIT_SUCCESS;
+}
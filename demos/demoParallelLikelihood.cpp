@@ -0,0 +1,183 @@
+// Computes the log-likelihood of a power spectrum of Lorentzian profiles
+// with the observations split over an increasing number of threads, and
+// compares the results and the time needed for one evaluation. The results
+// are identical for any number of threads, since the observations are summed
+// in the same segments and in the same order.
+//
+// Compile with:
+// clang++ -o demoParallelLikelihood demoParallelLikelihood.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register -pthread
+//
+
+#include <cstdlib>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <Eigen/Core>
+#include "Model.h"
+#include "NormalLikelihood.h"
+#include "ExponentialLikelihood.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Flat background with Lorentzian modes. The model parameters are the background
+// followed by (centroid, height, linewidth) for each mode.
+
+class LorentzianModel : public Model
+{
+    public:
+
+        LorentzianModel(const RefArrayXd covariates, int Nmodes)
+        : Model(covariates), Nmodes(Nmodes)
+        {
+            Nparameters = 1 + 3 * Nmodes;
+        }
+
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) override
+        {
+            predictSegment(predictions, modelParameters, 0);
+        }
+
+        virtual void predictSegment(RefArrayXd predictions, const RefArrayXd modelParameters, const int beginIndex) override
+        {
+            predictions += modelParameters(0);
+
+            for (int mode = 0; mode < Nmodes; ++mode)
+            {
+                double centroid = modelParameters(1 + 3*mode);
+                double height = modelParameters(2 + 3*mode);
+                double halfWidth = modelParameters(3 + 3*mode) / 2.0;
+                predictions += height / (1.0 + ((covariates.segment(beginIndex, predictions.size()) - centroid) / halfWidth).square());
+            }
+        }
+
+        virtual bool canPredictSegments() override
+        {
+            return true;
+        }
+
+    private:
+
+        int Nmodes;
+};
+
+
+
+// Evaluate the log-likelihood for each set of parameters, and return the wall-clock time per evaluation
+
+double evaluate(Likelihood &likelihood, ArrayXXd &parameters, ArrayXd &logLikelihoods)
+{
+    auto startTime = chrono::steady_clock::now();
+
+    for (int n = 0; n < parameters.cols(); ++n)
+    {
+        ArrayXd modelParameters = parameters.col(n);
+        logLikelihoods(n) = likelihood.logValue(modelParameters);
+    }
+
+    chrono::duration<double> time = chrono::steady_clock::now() - startTime;
+
+    return time.count() / parameters.cols();
+}
+
+
+
+void compare(string likelihoodName, Likelihood &likelihood, ArrayXXd &parameters)
+{
+    ArrayXd serialLogLikelihoods(parameters.cols());
+    ArrayXd parallelLogLikelihoods(parameters.cols());
+
+    likelihood.setNthreads(1);
+    double serialTime = evaluate(likelihood, parameters, serialLogLikelihoods);
+
+    cerr << likelihoodName << endl;
+    cerr << "    1 thread:   time per evaluation = " << serialTime << " s" << endl;
+
+    int maxNthreads = max(2u, thread::hardware_concurrency());
+
+    for (int Nthreads = 2; Nthreads <= maxNthreads; Nthreads *= 2)
+    {
+        likelihood.setNthreads(Nthreads);
+        double parallelTime = evaluate(likelihood, parameters, parallelLogLikelihoods);
+
+        cerr << "    " << setw(2) << Nthreads << " threads: time per evaluation = " << parallelTime << " s"
+             << "   speedup = " << serialTime / parallelTime
+             << "   identical to 1 thread: " << (parallelLogLikelihoods == serialLogLikelihoods).all() << endl;
+    }
+
+    likelihood.setNthreads(1);
+    cerr << endl;
+}
+
+
+
+int main()
+{
+    int Nbins = 4000000;
+    int Nmodes = 20;
+    int Nevaluations = 20;
+
+    mt19937 engine(42);
+    uniform_real_distribution<> uniform(0.0, 1.0);
+    normal_distribution<> normal(0.0, 1.0);
+
+
+    // Frequency grid, and the true parameters
+
+    ArrayXd covariates = ArrayXd::LinSpaced(Nbins, 100.0, 5000.0);
+    ArrayXd trueParameters(1 + 3*Nmodes);
+    trueParameters(0) = 2.0;
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        trueParameters(1 + 3*mode) = 1000.0 + 135.0 * mode;
+        trueParameters(2 + 3*mode) = 10.0 + 40.0 * uniform(engine);
+        trueParameters(3 + 3*mode) = 0.5 + 1.5 * uniform(engine);
+    }
+
+    LorentzianModel model(covariates, Nmodes);
+    ArrayXd truePredictions = ArrayXd::Zero(Nbins);
+    model.predict(truePredictions, trueParameters);
+
+
+    // A power spectrum (chi-square with 2 d.o.f. noise), and a spectrum with normal noise
+
+    ArrayXd powerSpectrum(Nbins);
+    ArrayXd normalObservations(Nbins);
+    ArrayXd uncertainties = ArrayXd::Constant(Nbins, 0.5);
+
+    for (int n = 0; n < Nbins; ++n)
+    {
+        powerSpectrum(n) = -truePredictions(n) * log(uniform(engine));
+        normalObservations(n) = truePredictions(n) + uncertainties(n) * normal(engine);
+    }
+
+
+    // Perturbed sets of parameters around the true ones
+
+    ArrayXXd parameters(trueParameters.size(), Nevaluations);
+
+    for (int n = 0; n < Nevaluations; ++n)
+    {
+        for (int i = 0; i < trueParameters.size(); ++i)
+        {
+            parameters(i, n) = trueParameters(i) * (1.0 + 0.0001 * normal(engine));
+        }
+    }
+
+    ExponentialLikelihood exponentialLikelihood(powerSpectrum, model);
+    NormalLikelihood normalLikelihood(normalObservations, uncertainties, model);
+
+    cerr << setprecision(6);
+    cerr << Nbins << " bins, " << Nmodes << " modes, " << Nevaluations << " evaluations" << endl << endl;
+
+    compare("ExponentialLikelihood", exponentialLikelihood, parameters);
+    compare("NormalLikelihood", normalLikelihood, parameters);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+// Shows several processes storing evaluations in the same file of a
+// PersistentLikelihood at the same time. Four processes evaluate different
+// points of the single 2D Gaussian likelihood, while a fifth process is killed
+// in the middle of writing a record, leaving an incomplete record at the end
+// of the file. Since the records are appended under an advisory lock of the
+// file, the incomplete record is discarded before the next record is appended,
+// and no record of the other processes is lost or shifted. Finally, the file
+// is opened again, and all evaluations have to be replayed with their exact
+// values.
+//
+// Compile with:
+// clang++ -o demoPersistentLikelihoodProcesses demoPersistentLikelihoodProcesses.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "ZeroModel.h"
+#include "PersistentLikelihood.h"
+#include "demoSingle2DGaussian.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// The n-th point evaluated by a process. The points of different processes differ.
+
+ArrayXd point(int process, int n)
+{
+    ArrayXd parameters(2);
+    parameters << 9.0 + 0.01 * n, 19.0 + 0.5 * process;
+
+    return parameters;
+}
+
+
+
+// Store the evaluations of Npoints points, pausing between them so that the processes interleave
+
+void storeEvaluations(Likelihood &likelihood, const string fileName, int process, int Npoints)
+{
+    PersistentLikelihood persistentLikelihood(likelihood, 2, fileName);
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        ArrayXd parameters = point(process, n);
+        persistentLikelihood.logValue(parameters);
+        usleep(200);
+    }
+}
+
+
+
+// Write half a record under the lock of the file, and wait to be killed, as a process
+// that is interrupted while it appends a record
+
+void writeIncompleteRecord(const string fileName)
+{
+    int fileDescriptor = open(fileName.c_str(), O_WRONLY | O_APPEND);
+    char halfRecord[16] = {0};
+
+    flock(fileDescriptor, LOCK_EX);
+
+    if (write(fileDescriptor, halfRecord, sizeof(halfRecord)) != sizeof(halfRecord))
+    {
+        _exit(EXIT_FAILURE);
+    }
+
+    pause();
+}
+
+
+
+int main()
+{
+    ArrayXd covariates;
+    ArrayXd observations;
+    ZeroModel model(covariates);
+    Single2DGaussianLikelihood likelihood(observations, model);
+
+    const string fileName = "demoPersistentLikelihoodProcesses.bin";
+    const int Nprocesses = 4;
+    const int Npoints = 500;
+
+    remove(fileName.c_str());
+
+
+    // The file is created before the processes start, so that the interrupted process can open it
+
+    {
+        PersistentLikelihood persistentLikelihood(likelihood, 2, fileName);
+    }
+
+    vector<pid_t> processes;
+
+    for (int process = 0; process < Nprocesses; ++process)
+    {
+        pid_t pid = fork();
+
+        if (pid == 0)
+        {
+            storeEvaluations(likelihood, fileName, process, Npoints);
+            _exit(EXIT_SUCCESS);
+        }
+
+        processes.push_back(pid);
+    }
+
+
+    // Interrupt a writer in the middle of a record, while the other processes are running
+
+    usleep(50000);
+
+    pid_t interruptedProcess = fork();
+
+    if (interruptedProcess == 0)
+    {
+        writeIncompleteRecord(fileName);
+        _exit(EXIT_SUCCESS);
+    }
+
+    usleep(10000);
+
+
+    // While the interrupted process holds the lock, nothing else is appended: check that 
+    // the file ends with the incomplete record, and count the processes that are still running
+
+    const size_t headerSize = 16;
+    const size_t recordSize = sizeof(uint64_t) + 3 * sizeof(double);
+    struct stat fileStatus;
+    stat(fileName.c_str(), &fileStatus);
+    const bool recordIsIncomplete = ((fileStatus.st_size - headerSize) % recordSize != 0);
+    int NrunningProcesses = 0;
+
+    for (pid_t pid : processes)
+    {
+        if (waitpid(pid, nullptr, WNOHANG) == 0) NrunningProcesses++;
+    }
+
+    kill(interruptedProcess, SIGKILL);
+    waitpid(interruptedProcess, nullptr, 0);
+
+    bool processesSucceeded = true;
+
+    for (pid_t pid : processes)
+    {
+        int status;
+        waitpid(pid, &status, 0);
+        processesSucceeded = processesSucceeded && WIFEXITED(status) && (WEXITSTATUS(status) == EXIT_SUCCESS);
+    }
+
+
+    // Open the file again, and replay all evaluations
+
+    stat(fileName.c_str(), &fileStatus);
+
+    PersistentLikelihood persistentLikelihood(likelihood, 2, fileName);
+    int NwrongValues = 0;
+
+    for (int process = 0; process < Nprocesses; ++process)
+    {
+        for (int n = 0; n < Npoints; ++n)
+        {
+            ArrayXd parameters = point(process, n);
+
+            if (persistentLikelihood.logValue(parameters) != likelihood.logValue(parameters)) NwrongValues++;
+        }
+    }
+
+    const unsigned long Nexpected = Nprocesses * Npoints;
+    const bool fileIsAligned = ((fileStatus.st_size - headerSize) % recordSize == 0);
+
+    cerr << "Processes that stored evaluations:       " << Nprocesses << " x " << Npoints << " points" << endl;
+    cerr << "Incomplete record of the killed process:  " << recordIsIncomplete 
+         << ", while " << NrunningProcesses << " processes were storing" << endl;
+    cerr << "File size is a whole number of records:  " << fileIsAligned << endl;
+    cerr << "Evaluations loaded from the file:        " << persistentLikelihood.getNloadedEvaluations()
+         << " of " << Nexpected << endl;
+    cerr << "Evaluations replayed / stored again:     " << persistentLikelihood.getNreplayedEvaluations()
+         << " / " << persistentLikelihood.getNstoredEvaluations() << endl;
+    cerr << "Replayed values that differ:             " << NwrongValues << endl;
+
+    remove(fileName.c_str());
+
+    const bool success = processesSucceeded && fileIsAligned && (persistentLikelihood.getNloadedEvaluations() == Nexpected)
+                         && (persistentLikelihood.getNstoredEvaluations() == 0) && (NwrongValues == 0);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,132 @@
+// Computes the 16%, 50% and 84% posterior predictive bands of a damped sinusoid,
+// from a weighted sample of its parameters, as a nested sampler would return it.
+// The bands estimated on the fly are compared with the exact quantiles of the
+// predictions of all resampled samples, which need to be kept in memory.
+//
+// Compile with:
+// clang++ -o demoPosteriorPredictiveBands demoPosteriorPredictiveBands.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <Eigen/Core>
+#include "Functions.h"
+#include "Model.h"
+#include "PosteriorPredictiveBands.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Damped sinusoid with amplitude, frequency and damping rate as parameters
+
+class DampedSinusoidModel : public Model
+{
+    public:
+
+        DampedSinusoidModel(const RefArrayXd covariates)
+        : Model(covariates)
+        {
+            Nparameters = 3;
+        }
+
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) override
+        {
+            predictions += modelParameters(0) * (2.0 * Functions::PI * modelParameters(1) * covariates).sin()
+                                              * (-modelParameters(2) * covariates).exp();
+        }
+};
+
+
+
+int main()
+{
+    int Ncovariates = 1000;
+    ArrayXd covariates = ArrayXd::LinSpaced(Ncovariates, 0.0, 10.0);
+    DampedSinusoidModel model(covariates);
+
+
+    // Weighted posterior sample: uniformly drawn parameters, weighted by a Gaussian posterior
+
+    int NposteriorSamples = 50000;
+    ArrayXd means(3), sigmas(3);
+    means << 1.0, 0.5, 0.2;
+    sigmas << 0.1, 0.01, 0.02;
+
+    mt19937 engine(42);
+    uniform_real_distribution<> uniform(-4.0, 4.0);
+    ArrayXXd posteriorSample(3, NposteriorSamples);
+    ArrayXd posteriorProbability(NposteriorSamples);
+
+    for (int n = 0; n < NposteriorSamples; ++n)
+    {
+        ArrayXd z(3);
+        for (int i = 0; i < 3; ++i) z(i) = uniform(engine);
+        posteriorSample.col(n) = means + sigmas * z;
+        posteriorProbability(n) = exp(-0.5 * z.square().sum());
+    }
+
+
+    // Posterior predictive bands estimated on the fly
+
+    ArrayXd quantileLevels(3);
+    quantileLevels << 0.16, 0.5, 0.84;
+    int Nsamples = 20000;
+
+    PosteriorPredictiveBands predictiveBands(model, quantileLevels);
+
+    clock_t startTime = clock();
+    predictiveBands.compute(posteriorSample, posteriorProbability, Nsamples);
+    double time = double(clock() - startTime) / CLOCKS_PER_SEC;
+
+    ArrayXXd bands = predictiveBands.getBands();
+    predictiveBands.writeBandsToFile("demoPosteriorPredictiveBands_bands.txt");
+
+
+    // Exact quantiles, from the predictions of the same number of samples drawn from the
+    // weights, which are all kept in memory.
+
+    discrete_distribution<> weightedIndex(posteriorProbability.data(), posteriorProbability.data() + NposteriorSamples);
+    ArrayXXd allPredictions = ArrayXXd::Zero(Ncovariates, Nsamples);
+    ArrayXd parameters(3);
+
+    for (int n = 0; n < Nsamples; ++n)
+    {
+        parameters = posteriorSample.col(weightedIndex(engine));
+        model.predict(allPredictions.col(n), parameters);
+    }
+
+    double maxDifference = 0.0;
+    double maxBandWidth = 0.0;
+    vector<double> predictions(Nsamples);
+
+    for (int covariate = 0; covariate < Ncovariates; ++covariate)
+    {
+        for (int n = 0; n < Nsamples; ++n) predictions[n] = allPredictions(covariate, n);
+        sort(predictions.begin(), predictions.end());
+
+        for (int quantile = 0; quantile < 3; ++quantile)
+        {
+            double exactQuantile = predictions[int(quantileLevels(quantile) * (Nsamples - 1))];
+            maxDifference = max(maxDifference, fabs(bands(covariate, quantile) - exactQuantile));
+        }
+
+        maxBandWidth = max(maxBandWidth, bands(covariate, 2) - bands(covariate, 0));
+    }
+
+    cerr << "Bands of " << Ncovariates << " covariates from " << Nsamples << " resampled posterior samples" << endl;
+    cerr << "    Time = " << time << " s" << endl;
+    cerr << "    Maximum width of the 16-84% band:                 " << maxBandWidth << endl;
+    cerr << "    Maximum difference with the exact quantiles:       " << maxDifference << endl;
+    cerr << "    Memory for the predictions: on the fly " << Ncovariates * 64 * 8 / 1024 << " kB, exact "
+         << Ncovariates * Nsamples * 8 / 1024 << " kB" << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+// Compares the k-means clusterer applied in the full parameter space with the
+// same clusterer applied in the principal-component subspace, on the k-means
+// test samples embedded in a higher-dimensional space: the sample is extended
+// with coordinates that only contain a small noise, and randomly rotated, so that
+// the clusters lie close to a low-dimensional subspace, as for correlated parameters.
+//
+// Compile with:
+// clang++ -o demoPrincipalComponentsClusterer demoPrincipalComponentsClusterer.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <random>
+#include <vector>
+#include <Eigen/Dense>
+#include "File.h"
+#include "EuclideanMetric.h"
+#include "KmeansClusterer.h"
+#include "PrincipalComponentsClusterer.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Rand index: the fraction of pairs of points on which both clusterings agree
+// (either both in the same cluster, or both in different clusters).
+
+double randIndex(vector<int> &clusterIndices1, vector<int> &clusterIndices2)
+{
+    int Npoints = clusterIndices1.size();
+    long Npairs = 0;
+    long Nagreements = 0;
+
+    for (int i = 0; i < Npoints; ++i)
+    {
+        for (int j = i+1; j < Npoints; ++j)
+        {
+            bool sameCluster1 = (clusterIndices1[i] == clusterIndices1[j]);
+            bool sameCluster2 = (clusterIndices2[i] == clusterIndices2[j]);
+            if (sameCluster1 == sameCluster2) Nagreements++;
+            Npairs++;
+        }
+    }
+
+    return Nagreements / double(Npairs);
+}
+
+
+
+// Extend the sample with Nextra coordinates of small noise, and rotate it randomly
+
+ArrayXXd embedSample(ArrayXXd &sample, int Nextra, double noiseLevel, mt19937 &engine)
+{
+    int Ndimensions = sample.rows() + Nextra;
+    int Npoints = sample.cols();
+    normal_distribution<> normal(0.0, 1.0);
+
+    ArrayXXd extendedSample(Ndimensions, Npoints);
+    extendedSample.topRows(sample.rows()) = sample;
+
+    for (int n = 0; n < Npoints; ++n)
+    {
+        for (int i = sample.rows(); i < Ndimensions; ++i) extendedSample(i,n) = noiseLevel * normal(engine);
+    }
+
+    MatrixXd randomMatrix(Ndimensions, Ndimensions);
+
+    for (int i = 0; i < Ndimensions; ++i)
+    {
+        for (int j = 0; j < Ndimensions; ++j) randomMatrix(i,j) = normal(engine);
+    }
+
+    MatrixXd rotation = HouseholderQR<MatrixXd>(randomMatrix).householderQ();
+
+    return (rotation * extendedSample.matrix()).array();
+}
+
+
+
+// Cluster the sample with both clusterers and print the comparison
+
+void compareClusterers(string sampleName, ArrayXXd &sample, vector<int> &trueClusterIndices,
+                       KmeansClusterer &kmeans, PrincipalComponentsClusterer &principalComponentsKmeans)
+{
+    int Npoints = sample.cols();
+    vector<int> clusterIndices(Npoints);
+    vector<int> projectedClusterIndices(Npoints);
+    vector<int> clusterSizes;
+
+    clock_t startTime = clock();
+    int Nclusters = kmeans.cluster(sample, clusterIndices, clusterSizes);
+    double time = double(clock() - startTime) / CLOCKS_PER_SEC;
+
+    startTime = clock();
+    int projectedNclusters = principalComponentsKmeans.cluster(sample, projectedClusterIndices, clusterSizes);
+    double projectedTime = double(clock() - startTime) / CLOCKS_PER_SEC;
+
+    cerr << sampleName << " (" << sample.rows() << " dimensions, " << Npoints << " points)" << endl;
+    cerr << "    Full space k-means:          Nclusters = " << setw(2) << Nclusters
+         << "   Rand index with the original clustering = " << randIndex(clusterIndices, trueClusterIndices)
+         << "   time = " << time << " s" << endl;
+    cerr << "    Principal components k-means: Nclusters = " << setw(2) << projectedNclusters
+         << "   Rand index with the original clustering = " << randIndex(projectedClusterIndices, trueClusterIndices)
+         << "   time = " << projectedTime << " s"
+         << "   (" << principalComponentsKmeans.getNprojectedDimensions() << " principal components)" << endl;
+    cerr << endl;
+}
+
+
+
+int main()
+{
+    EuclideanMetric myMetric;
+    int minNclusters = 2;
+    int maxNclusters = 10;
+    int Ntrials = 10;
+    double relTolerance = 0.01;
+    double retainedVarianceFraction = 0.95;
+
+    KmeansClusterer kmeans(myMetric, minNclusters, maxNclusters, Ntrials, relTolerance);
+    PrincipalComponentsClusterer principalComponentsKmeans(kmeans, retainedVarianceFraction);
+
+    mt19937 engine(42);
+    vector<string> fileNames = {"kmeans_testsample2D.txt", "kmeans_testsample5D.txt"};
+    int Nextra = 15;
+    double noiseLevel = 0.05;
+
+    for (auto fileName : fileNames)
+    {
+        // Read the test sample, and cluster it in its own space, as a reference
+
+        ifstream inputFile;
+        File::openInputFile(inputFile, fileName);
+        unsigned long Nrows;
+        int Ncols;
+        File::sniffFile(inputFile, Nrows, Ncols);
+        ArrayXXd data = File::arrayXXdFromFile(inputFile, Nrows, Ncols);
+        ArrayXXd sample = data.transpose();
+        inputFile.close();
+
+        vector<int> trueClusterIndices(sample.cols());
+        vector<int> clusterSizes;
+        kmeans.cluster(sample, trueClusterIndices, clusterSizes);
+
+
+        // Embed it in a space with Nextra more dimensions, and compare both clusterers
+
+        ArrayXXd embeddedSample = embedSample(sample, Nextra, noiseLevel, engine);
+
+        compareClusterers(fileName + ", embedded", embeddedSample, trueClusterIndices, kmeans, principalComponentsKmeans);
+    }
+
+    return EXIT_SUCCESS;
+}
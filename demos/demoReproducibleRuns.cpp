@@ -0,0 +1,95 @@
+// Runs the nested sampler on the five 2D Gaussians three times: twice with the
+// same run seed, and once with a different one. All random numbers of a run
+// (priors, sampler, clusterer, ellipsoids) are derived from the run seed, so
+// that the first two runs give identical results.
+//
+// Compile with:
+// clang++ -o demoReproducibleRuns demoReproducibleRuns.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include "Functions.h"
+#include "MultiEllipsoidSampler.h"
+#include "KmeansClusterer.h"
+#include "EuclideanMetric.h"
+#include "UniformPrior.h"
+#include "ZeroModel.h"
+#include "PowerlawReducer.h"
+#include "RandomStreams.h"
+#include "demoFive2DGaussians.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Set up and run the nested sampler, after setting the run seed. The components
+// are constructed after the seed is set, so that their streams derive from it.
+
+void runWithSeed(uint64_t runSeed, double &logEvidence, int &Niterations)
+{
+    RandomStreams::setRunSeed(runSeed);
+
+    ArrayXd covariates;
+    ArrayXd observations;
+    ZeroModel model(covariates);
+
+    int Ndimensions = 2;
+    vector<Prior*> ptrPriors(1);
+    ArrayXd parametersMinima(Ndimensions);
+    ArrayXd parametersMaxima(Ndimensions);
+    parametersMinima << -0.7, -0.7;
+    parametersMaxima << +1.0, +1.0;
+    UniformPrior uniformPrior(parametersMinima, parametersMaxima);
+    ptrPriors[0] = &uniformPrior;
+
+    Multiple2DGaussiansLikelihood likelihood(observations, model);
+    EuclideanMetric myMetric;
+    KmeansClusterer kmeans(myMetric, 1, 6, 10, 0.01);
+
+    bool printOnTheScreen = false;
+    int initialNobjects = 200;
+    int minNobjects = 200;
+    int maxNdrawAttempts = 20000;
+    int NinitialIterationsWithoutClustering = 100;
+    int NiterationsWithSameClustering = 20;
+    double initialEnlargementFraction = 10.0;
+    double shrinkingRate = 0.2;
+    double terminationFactor = 0.05;
+
+    MultiEllipsoidSampler nestedSampler(printOnTheScreen, ptrPriors, likelihood, myMetric, kmeans,
+                                        initialNobjects, minNobjects, initialEnlargementFraction, shrinkingRate);
+    PowerlawReducer livePointsReducer(nestedSampler, 1.e2, 0.4, terminationFactor);
+
+    nestedSampler.run(livePointsReducer, NinitialIterationsWithoutClustering, NiterationsWithSameClustering,
+                      maxNdrawAttempts, terminationFactor, "demoReproducibleRuns_");
+    nestedSampler.outputFile.close();
+
+    logEvidence = nestedSampler.getLogEvidence();
+    Niterations = nestedSampler.getNiterations();
+}
+
+
+
+int main()
+{
+    uint64_t runSeeds[3] = {12345, 12345, 67890};
+
+    cerr << setprecision(15);
+
+    for (int run = 0; run < 3; ++run)
+    {
+        double logEvidence;
+        int Niterations;
+
+        runWithSeed(runSeeds[run], logEvidence, Niterations);
+
+        cerr << "Run seed " << runSeeds[run] << ":   log(E) = " << logEvidence
+             << "   Niterations = " << Niterations << endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+// Compares the log-likelihood computed in single precision mode with the
+// log-likelihood computed in double precision, for a power spectrum of
+// Lorentzian profiles on a large frequency grid, together with the time
+// needed for one evaluation in both modes.
+// Nested sampling only compares log-likelihoods, so that the accuracy that matters 
+// is the error on the difference between the log-likelihoods of two points, rather 
+// than the relative error on a log-likelihood, which is dominated by its constant terms.
+// The frequencies are not rounded to single precision themselves (near 5000 microHz,
+// consecutive floats are 5e-4 microHz apart, which is not negligible compared to the
+// narrowest linewidths): the model computes the offset between each mode centroid 
+// and the origin of each block of covariates in double precision (see 
+// Model::prepareSinglePrecision()), and only the small remaining differences are in 
+// single precision.
+//
+// Compile with:
+// clang++ -o demoSinglePrecisionLikelihood demoSinglePrecisionLikelihood.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <Eigen/Core>
+#include "Model.h"
+#include "NormalLikelihood.h"
+#include "ExponentialLikelihood.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Flat background with Lorentzian modes. The model parameters are the background
+// followed by (centroid, height, linewidth) for each mode.
+
+class LorentzianModel : public Model
+{
+    public:
+
+        LorentzianModel(const RefArrayXd covariates, int Nmodes)
+        : Model(covariates), Nmodes(Nmodes)
+        {
+            Nparameters = 1 + 3 * Nmodes;
+        }
+
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) override
+        {
+            predictions += modelParameters(0);
+
+            for (int mode = 0; mode < Nmodes; ++mode)
+            {
+                double centroid = modelParameters(1 + 3*mode);
+                double height = modelParameters(2 + 3*mode);
+                double halfWidth = modelParameters(3 + 3*mode) / 2.0;
+                predictions += height / (1.0 + ((covariates - centroid) / halfWidth).square());
+            }
+        }
+
+        virtual void predictSinglePrecision(RefArrayXf predictions, const RefArrayXd modelParameters) override
+        {
+            const int Ncovariates = covariatesSinglePrecision.size();
+            const int blockSize = singlePrecisionBlockSize;
+
+            predictions += float(modelParameters(0));
+
+            for (int mode = 0; mode < Nmodes; ++mode)
+            {
+                double centroid = modelParameters(1 + 3*mode);
+                float height = modelParameters(2 + 3*mode);
+                float inverseHalfWidth = 2.0 / modelParameters(3 + 3*mode);
+
+                for (int block = 0; block < covariatesBlockOrigins.size(); ++block)
+                {
+                    const int beginIndex = block * blockSize;
+                    const int length = min(blockSize, Ncovariates - beginIndex);
+                    const float offset = covariatesBlockOrigins(block) - centroid;
+
+                    predictions.segment(beginIndex, length) += height 
+                        / (1.0f + ((covariatesSinglePrecision.segment(beginIndex, length) + offset) * inverseHalfWidth).square());
+                }
+            }
+        }
+
+        virtual bool canPredictSinglePrecision() override
+        {
+            return true;
+        }
+
+    private:
+
+        int Nmodes;
+};
+
+
+
+// Evaluate the log-likelihood for each set of parameters, and return the total time in seconds
+
+double evaluate(Likelihood &likelihood, ArrayXXd &parameters, ArrayXd &logLikelihoods)
+{
+    clock_t startTime = clock();
+
+    for (int n = 0; n < parameters.cols(); ++n)
+    {
+        ArrayXd modelParameters = parameters.col(n);
+        logLikelihoods(n) = likelihood.logValue(modelParameters);
+    }
+
+    return double(clock() - startTime) / CLOCKS_PER_SEC;
+}
+
+
+
+// Print the accuracy and speed of the single precision mode
+
+void compare(string likelihoodName, Likelihood &likelihood, ArrayXXd &parameters)
+{
+    int Nevaluations = parameters.cols();
+    ArrayXd doublePrecisionLogLikelihoods(Nevaluations);
+    ArrayXd singlePrecisionLogLikelihoods(Nevaluations);
+
+    likelihood.setSinglePrecision(false);
+    double doublePrecisionTime = evaluate(likelihood, parameters, doublePrecisionLogLikelihoods);
+    likelihood.setSinglePrecision(true);
+    double singlePrecisionTime = evaluate(likelihood, parameters, singlePrecisionLogLikelihoods);
+    likelihood.setSinglePrecision(false);
+
+    ArrayXd absoluteErrors = (singlePrecisionLogLikelihoods - doublePrecisionLogLikelihoods).abs();
+
+
+    // Nested sampling only compares log-likelihoods, so the error on the difference
+    // with a reference value is the accuracy that matters.
+
+    ArrayXd doublePrecisionDifferences = doublePrecisionLogLikelihoods.tail(Nevaluations-1) - doublePrecisionLogLikelihoods(0);
+    ArrayXd singlePrecisionDifferences = singlePrecisionLogLikelihoods.tail(Nevaluations-1) - singlePrecisionLogLikelihoods(0);
+    double maxDifferenceError = (singlePrecisionDifferences - doublePrecisionDifferences).abs().maxCoeff();
+
+    cerr << likelihoodName << endl;
+    cerr << "    Max error on log-likelihood differences:   " << maxDifferenceError << endl;
+    cerr << "    Spread of the log-likelihood differences:  " << doublePrecisionDifferences.abs().maxCoeff() << endl;
+    cerr << "    Max error on log-likelihood values:        " << absoluteErrors.maxCoeff() << endl;
+    cerr << "    Time per evaluation (double / single):     " << doublePrecisionTime / Nevaluations << " s / "
+         << singlePrecisionTime / Nevaluations << " s" << endl;
+    cerr << endl;
+}
+
+
+
+int main()
+{
+    int Nbins = 1000000;
+    int Nmodes = 20;
+    int Nevaluations = 50;
+
+    mt19937 engine(42);
+    uniform_real_distribution<> uniform(0.0, 1.0);
+    normal_distribution<> normal(0.0, 1.0);
+
+
+    // Frequency grid, and the true parameters
+
+    ArrayXd covariates = ArrayXd::LinSpaced(Nbins, 100.0, 5000.0);
+    ArrayXd trueParameters(1 + 3*Nmodes);
+    trueParameters(0) = 2.0;
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        trueParameters(1 + 3*mode) = 1000.0 + 135.0 * mode;
+        trueParameters(2 + 3*mode) = 10.0 + 40.0 * uniform(engine);
+        trueParameters(3 + 3*mode) = 0.5 + 1.5 * uniform(engine);
+    }
+
+    LorentzianModel model(covariates, Nmodes);
+    ArrayXd truePredictions = ArrayXd::Zero(Nbins);
+    model.predict(truePredictions, trueParameters);
+
+
+    // A power spectrum (chi-square with 2 d.o.f. noise), and a spectrum with normal noise
+
+    ArrayXd powerSpectrum(Nbins);
+    ArrayXd normalObservations(Nbins);
+    ArrayXd uncertainties = ArrayXd::Constant(Nbins, 0.5);
+
+    for (int n = 0; n < Nbins; ++n)
+    {
+        powerSpectrum(n) = -truePredictions(n) * log(uniform(engine));
+        normalObservations(n) = truePredictions(n) + uncertainties(n) * normal(engine);
+    }
+
+
+    // Perturbed sets of parameters around the true ones
+
+    ArrayXXd parameters(trueParameters.size(), Nevaluations);
+
+    for (int n = 0; n < Nevaluations; ++n)
+    {
+        for (int i = 0; i < trueParameters.size(); ++i)
+        {
+            parameters(i, n) = trueParameters(i) * (1.0 + 0.0001 * normal(engine));
+        }
+    }
+
+    ExponentialLikelihood exponentialLikelihood(powerSpectrum, model);
+    NormalLikelihood normalLikelihood(normalObservations, uncertainties, model);
+
+    cerr << setprecision(6);
+    cerr << Nbins << " bins, " << Nmodes << " modes, " << Nevaluations << " evaluations" << endl << endl;
+
+    compare("ExponentialLikelihood", exponentialLikelihood, parameters);
+    compare("NormalLikelihood", normalLikelihood, parameters);
+
+    return EXIT_SUCCESS;
+}
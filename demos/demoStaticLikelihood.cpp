@@ -0,0 +1,186 @@
+// Compares the statically dispatched StaticLikelihood with the virtual
+// NormalLikelihood and ExponentialLikelihood, for the same model of
+// Lorentzian profiles, in terms of the log-likelihood and the time needed
+// for one evaluation. The static normal likelihood is given its uncertainties
+// as a temporary array, and is then evaluated with the observations split over
+// 1, 2 and 4 threads, which gives identical results.
+//
+// Compile with:
+// clang++ -o demoStaticLikelihood demoStaticLikelihood.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <ctime>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <Eigen/Core>
+#include "StaticModel.h"
+#include "StaticLikelihood.h"
+#include "NormalLikelihood.h"
+#include "ExponentialLikelihood.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+// Flat background with Lorentzian modes. The model parameters are the background
+// followed by (centroid, height, linewidth) for each mode.
+
+class LorentzianModel : public StaticModel<LorentzianModel>
+{
+    public:
+
+        LorentzianModel(const RefArrayXd covariates, int Nmodes)
+        : StaticModel<LorentzianModel>(covariates), Nmodes(Nmodes)
+        {
+            Nparameters = 1 + 3 * Nmodes;
+        }
+
+        double evaluate(const double covariate, const RefArrayXd modelParameters) const
+        {
+            double prediction = modelParameters(0);
+
+            for (int mode = 0; mode < Nmodes; ++mode)
+            {
+                double x = 2.0 * (covariate - modelParameters(1 + 3*mode)) / modelParameters(3 + 3*mode);
+                prediction += modelParameters(2 + 3*mode) / (1.0 + x * x);
+            }
+
+            return prediction;
+        }
+
+    private:
+
+        int Nmodes;
+};
+
+
+
+// Evaluate the log-likelihood for each set of parameters, and return the time per evaluation
+
+double evaluate(Likelihood &likelihood, ArrayXXd &parameters, ArrayXd &logLikelihoods)
+{
+    clock_t startTime = clock();
+
+    for (int n = 0; n < parameters.cols(); ++n)
+    {
+        ArrayXd modelParameters = parameters.col(n);
+        logLikelihoods(n) = likelihood.logValue(modelParameters);
+    }
+
+    return double(clock() - startTime) / CLOCKS_PER_SEC / parameters.cols();
+}
+
+
+
+void compare(string likelihoodName, Likelihood &virtualLikelihood, Likelihood &staticLikelihood, ArrayXXd &parameters)
+{
+    ArrayXd virtualLogLikelihoods(parameters.cols());
+    ArrayXd staticLogLikelihoods(parameters.cols());
+
+    double virtualTime = evaluate(virtualLikelihood, parameters, virtualLogLikelihoods);
+    double staticTime = evaluate(staticLikelihood, parameters, staticLogLikelihoods);
+
+    cerr << likelihoodName << endl;
+    cerr << "    Max relative difference of log-likelihoods: " 
+         << ((staticLogLikelihoods - virtualLogLikelihoods) / virtualLogLikelihoods).abs().maxCoeff() << endl;
+    cerr << "    Time per evaluation (virtual / static):     " << virtualTime << " s / " << staticTime << " s" << endl;
+    cerr << endl;
+}
+
+
+
+int main()
+{
+    int Nbins = 1000000;
+    int Nmodes = 20;
+    int Nevaluations = 20;
+
+    mt19937 engine(42);
+    uniform_real_distribution<> uniform(0.0, 1.0);
+    normal_distribution<> normal(0.0, 1.0);
+
+
+    // Frequency grid, and the true parameters
+
+    ArrayXd covariates = ArrayXd::LinSpaced(Nbins, 100.0, 5000.0);
+    ArrayXd trueParameters(1 + 3*Nmodes);
+    trueParameters(0) = 2.0;
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        trueParameters(1 + 3*mode) = 1000.0 + 135.0 * mode;
+        trueParameters(2 + 3*mode) = 10.0 + 40.0 * uniform(engine);
+        trueParameters(3 + 3*mode) = 0.5 + 1.5 * uniform(engine);
+    }
+
+    LorentzianModel model(covariates, Nmodes);
+    ArrayXd truePredictions = ArrayXd::Zero(Nbins);
+    model.predict(truePredictions, trueParameters);
+
+
+    // A power spectrum (chi-square with 2 d.o.f. noise), and a spectrum with normal noise
+
+    ArrayXd powerSpectrum(Nbins);
+    ArrayXd normalObservations(Nbins);
+    ArrayXd uncertainties = ArrayXd::Constant(Nbins, 0.5);
+
+    for (int n = 0; n < Nbins; ++n)
+    {
+        powerSpectrum(n) = -truePredictions(n) * log(uniform(engine));
+        normalObservations(n) = truePredictions(n) + uncertainties(n) * normal(engine);
+    }
+
+
+    // Perturbed sets of parameters around the true ones
+
+    ArrayXXd parameters(trueParameters.size(), Nevaluations);
+
+    for (int n = 0; n < Nevaluations; ++n)
+    {
+        for (int i = 0; i < trueParameters.size(); ++i)
+        {
+            parameters(i, n) = trueParameters(i) * (1.0 + 0.0001 * normal(engine));
+        }
+    }
+
+    ExponentialLikelihood exponentialLikelihood(powerSpectrum, model);
+    StaticLikelihood<LorentzianModel, ExponentialNoisePolicy> staticExponentialLikelihood(powerSpectrum, model);
+    NormalLikelihood normalLikelihood(normalObservations, uncertainties, model);
+    StaticLikelihood<LorentzianModel, NormalNoisePolicy> staticNormalLikelihood(normalObservations, model, 
+                                                                                 ArrayXd::Constant(Nbins, 0.5));
+
+    cerr << setprecision(6);
+    cerr << Nbins << " bins, " << Nmodes << " modes, " << Nevaluations << " evaluations" << endl << endl;
+
+    compare("Exponential likelihood", exponentialLikelihood, staticExponentialLikelihood, parameters);
+    compare("Normal likelihood", normalLikelihood, staticNormalLikelihood, parameters);
+
+
+    // The same static likelihood over several threads. The wall-clock time is measured here.
+
+    ArrayXd singleThreadLogLikelihoods(Nevaluations);
+    ArrayXd logLikelihoods(Nevaluations);
+
+    cerr << "Static normal likelihood over several threads" << endl;
+
+    for (int Nthreads = 1; Nthreads <= 4; Nthreads *= 2)
+    {
+        staticNormalLikelihood.setNthreads(Nthreads);
+
+        auto startTime = chrono::steady_clock::now();
+        evaluate(staticNormalLikelihood, parameters, logLikelihoods);
+        double time = chrono::duration<double>(chrono::steady_clock::now() - startTime).count() / Nevaluations;
+
+        if (Nthreads == 1) singleThreadLogLikelihoods = logLikelihoods;
+
+        cerr << "    " << Nthreads << " thread(s): time per evaluation = " << time << " s   identical to 1 thread: " 
+             << (logLikelihoods == singleThreadLogLikelihoods).all() << endl;
+    }
+
+    return EXIT_SUCCESS;
+}
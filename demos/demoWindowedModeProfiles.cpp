@@ -0,0 +1,152 @@
+// Compares the windowed mode profiles with the sum of the exact profiles of
+// modeProfile(), modeProfileWithAmplitude() and modeProfileSinc(), on a spectrum
+// of 10^6 bins with 300 modes, for several window widths and for uniformly and
+// non-uniformly spaced bins. The wings of the windowed profiles are series
+// expansions whose relative error is below 2e-8 (3e-8 of the envelope for the
+// sinc-square profiles), see the REMARKS of Functions::modeProfilesWindowed().
+// The demo prints the largest errors found, checks them against these bounds,
+// and prints the speedup. When the segments of the expansion would contain
+// fewer bins than the degree of the expansion, the profiles are evaluated exactly
+// everywhere, which is the case of the sinc-square profiles for windows of 5 and
+// 20 resolutions.
+//
+// Compile with:
+// clang++ -o demoWindowedModeProfiles demoWindowedModeProfiles.cpp -L../build/ -I ../include/ -l diamonds -stdlib=libc++ -std=c++11 -Wno-deprecated-register
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "Functions.h"
+
+using namespace std;
+using namespace Eigen;
+
+
+
+double secondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+
+
+int main()
+{
+    const int Nbins = 1000000;
+    const int Nmodes = 300;
+    const double resolution = 0.01;
+    const double lorentzianBound = 2e-8;
+    const double sincBound = 3e-8;
+
+    mt19937 engine(12345);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+
+
+    // Uniformly spaced bins, and bins with random spacings between 0.5 and 1.5 resolutions
+
+    ArrayXd uniformFrequencies = 1000.0 + resolution * ArrayXd::LinSpaced(Nbins, 0, Nbins-1);
+    ArrayXd jitteredFrequencies(Nbins);
+    jitteredFrequencies(0) = 1000.0;
+
+    for (int i = 1; i < Nbins; ++i)
+    {
+        jitteredFrequencies(i) = jitteredFrequencies(i-1) + resolution * (0.5 + uniform(engine));
+    }
+
+    ArrayXd centroids(Nmodes);
+    ArrayXd heights(Nmodes);
+    ArrayXd amplitudes(Nmodes);
+    ArrayXd linewidths(Nmodes);
+
+    for (int mode = 0; mode < Nmodes; ++mode)
+    {
+        centroids(mode) = 1000.0 + 10000.0 * uniform(engine);
+        heights(mode) = 10.0 + 1000.0 * uniform(engine);
+        amplitudes(mode) = 1.0 + 10.0 * uniform(engine);
+        linewidths(mode) = 0.5 + 2.0 * uniform(engine);
+    }
+
+    bool allWithinBounds = true;
+
+    cout << scientific << setprecision(2);
+
+    for (int grid = 0; grid < 2; ++grid)
+    {
+        ArrayXd &frequencies = (grid == 0) ? uniformFrequencies : jitteredFrequencies;
+        ArrayXd profile(Nbins);
+
+
+        // The exact sums of the profiles
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+        ArrayXd exactLorentzians = ArrayXd::Zero(Nbins);
+
+        for (int mode = 0; mode < Nmodes; ++mode)
+        {
+            Functions::modeProfile(profile, frequencies, centroids(mode), heights(mode), linewidths(mode));
+            exactLorentzians += profile;
+        }
+
+        const double exactTime = secondsSince(start);
+
+        ArrayXd exactAmplitudeLorentzians = ArrayXd::Zero(Nbins);
+        ArrayXd exactSincs = ArrayXd::Zero(Nbins);
+        ArrayXd sincEnvelopes = ArrayXd::Zero(Nbins);
+
+        for (int mode = 0; mode < Nmodes; ++mode)
+        {
+            Functions::modeProfileWithAmplitude(profile, frequencies, centroids(mode), amplitudes(mode), linewidths(mode));
+            exactAmplitudeLorentzians += profile;
+            Functions::modeProfileSinc(profile, frequencies, centroids(mode), heights(mode), resolution);
+            exactSincs += profile;
+
+            ArrayXd argument = (Functions::PI / resolution) * (frequencies - centroids(mode));
+            sincEnvelopes += heights(mode) * (1.0 / argument.square()).min(1.0);
+        }
+
+        cout << ((grid == 0) ? "Uniformly spaced bins" : "Randomly spaced bins") << endl;
+        cout << "  window    Lorentzian   amplitude   sinc-square   speedup (Lorentzian)" << endl;
+
+        const double windowWidths[] = {5.0, 20.0, 50.0};
+
+        for (double windowWidth : windowWidths)
+        {
+            ArrayXd lorentzians = ArrayXd::Zero(Nbins);
+
+            start = chrono::steady_clock::now();
+            Functions::modeProfilesWindowed(lorentzians, frequencies, centroids, heights, linewidths, windowWidth);
+            const double windowedTime = secondsSince(start);
+
+            ArrayXd amplitudeLorentzians = ArrayXd::Zero(Nbins);
+            Functions::modeProfilesWithAmplitudeWindowed(amplitudeLorentzians, frequencies, centroids, amplitudes,
+                                                         linewidths, windowWidth);
+            ArrayXd sincs = ArrayXd::Zero(Nbins);
+            Functions::modeProfilesSincWindowed(sincs, frequencies, centroids, heights, resolution, windowWidth);
+
+
+            // Relative errors of the Lorentzians, and errors of the sinc-squares relative to their envelopes
+
+            const double lorentzianError = ((lorentzians - exactLorentzians).abs() / exactLorentzians).maxCoeff();
+            const double amplitudeError = ((amplitudeLorentzians - exactAmplitudeLorentzians).abs()
+                                           / exactAmplitudeLorentzians).maxCoeff();
+            const double sincError = ((sincs - exactSincs).abs() / sincEnvelopes).maxCoeff();
+
+            allWithinBounds = allWithinBounds && (lorentzianError < lorentzianBound)
+                              && (amplitudeError < lorentzianBound) && (sincError < sincBound);
+
+            cout << "  " << fixed << setprecision(0) << setw(6) << windowWidth << scientific << setprecision(2)
+                 << "    " << lorentzianError << "    " << amplitudeError << "    " << sincError
+                 << "      " << fixed << setprecision(1) << exactTime / windowedTime << scientific << setprecision(2) << endl;
+        }
+    }
+
+    cout << "Bounds: " << lorentzianBound << " (Lorentzian, relative), " << sincBound << " (sinc-square, relative to the envelope)" << endl;
+    cout << (allWithinBounds ? "All errors are within the bounds." : "Some errors exceed the bounds!") << endl;
+
+    return allWithinBounds ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -16,25 +16,30 @@
 #include "ZeroClusterer.h"
 #include "ZeroSampler.h"
 #include "ZeroPrior.h"
+#include "RunMerger.h"
 
 int main(int argc, char *argv[])
 {
     // Check number of arguments for main function
     
-    if (argc != 4)
+    if ((argc != 4) && !((argc == 5) && (string(argv[4]) == "archive")))
     {
-        cerr << "Usage: ./merger <KIC ID> <initial run number> <tot number of runs>" << endl;
+        cerr << "Usage: ./merger <KIC ID> <initial run number> <tot number of runs> [archive]" << endl;
         exit(EXIT_FAILURE);
     }
 
+
+    // With the option archive, the runs are read from, and the merged results are written to, binary archives
+
+    bool useArchives = (argc == 5);
+
     // ---------------------------
     // ----- Read input data -----
     // ---------------------------
 
     string preName = "TO BE SET BY THE USER";
-    string likelihoodFileName = preName + "logLikelihood.txt";
-    string parameterFileName = preName + "parameter";
     string configurationFileName = preName + "configuringParameters.txt";
+    string archiveFileName = preName + "archive.bin";
 
     unsigned long Npoints = 0;
     unsigned long NconfiguringParameters = 0;
@@ -48,8 +53,6 @@ int main(int argc, char *argv[])
     int Nprocesses = atoi(numberOfProcesses.c_str());   // The total number of processes to be merged (starting from 0)
 
 
-    ArrayXd totalLogLikelihood;
-    ArrayXXd totalParameterValues;
     int NfiguresProcesses = 2;
 
     cerr << "------------------------------------------------" << endl;
@@ -72,30 +75,17 @@ int main(int argc, char *argv[])
     inputFile.close();
 
     int Ndimensions = data(0,0);
-    int NfiguresDimensions = ceil(log10(Ndimensions*100));
 
 
-    // Read input data from different processes and collect them
+    // Add the runs of the different processes to the merger. Their samples are only read
+    // during the merging, which streams them by increasing likelihood.
     
-    int totalNpoints = 0;
-    int totalNlive = 0;
-    ArrayXXd data1;
-    ArrayXXd data2;
+    RunMerger merger(Ndimensions);
 
     for (int i=initialProcessNumber; i < initialProcessNumber+Nprocesses; i++)
     {
-        // Read log likelihood values
-       
         ostringstream numberString1;
         numberString1 << setfill('0') << setw(NfiguresProcesses) << i;
-        string inputFileName1 = inputDirName + numberString1.str() + "/" + likelihoodFileName;
-        File::openInputFile(inputFile, inputFileName1);
-        File::sniffFile(inputFile, Npoints, Ncols);
-        data1 = File::arrayXXdFromFile(inputFile, Npoints, Ncols);
-        inputFile.close();
-        
-        totalLogLikelihood.conservativeResize(totalNpoints + Npoints);
-        totalLogLikelihood.segment(totalNpoints, Npoints) = data1;
 
 
         // Read configuring parameters to compute total number of live points
@@ -107,78 +97,34 @@ int main(int argc, char *argv[])
         inputFile.close();
 
         int Nlive = data(1,0);
-        totalNlive += Nlive;
 
 
-        // Read parameter values for each dimension and collect them
+        // Add the log likelihood values and parameter values, from the archive of the run if required
 
-        totalParameterValues.conservativeResize(Ndimensions, totalNpoints + Npoints);
-        
-        for (int j=0; j < Ndimensions; j++)
+        if (useArchives)
         {
-            ostringstream numberString2;
-            numberString2 << setfill('0') << setw(NfiguresDimensions) << j;
-            string inputFileName2 = inputDirName + numberString1.str() + "/" + parameterFileName + numberString2.str() + ".txt";
-            File::openInputFile(inputFile, inputFileName2);
-            File::sniffFile(inputFile, Npoints, Ncols);
-            data2 = File::arrayXXdFromFile(inputFile, Npoints, Ncols);
-            inputFile.close();
-
-            totalParameterValues.row(j).segment(totalNpoints, Npoints) = data2.transpose();
+            merger.addRunFromArchive(inputDirName + numberString1.str() + "/" + archiveFileName, Nlive);
+        }
+        else
+        {
+            merger.addRunFromFiles(inputDirName + numberString1.str() + "/" + preName, Nlive);
         }
-
-        totalNpoints += Npoints;
     }
   
 
-    // Sort total arrays by increasing likelihood and sort parameter values accordingly
-
-    for (int i=0; i < Ndimensions; i++)
-    {
-        ArrayXd parameterValues(totalNpoints);
-        parameterValues = totalParameterValues.row(i);
-        Functions::topDownMergeSort(totalLogLikelihood, parameterValues);
-        totalParameterValues.row(i) = parameterValues;
-    }
-
-    
-    // Compute weights according to trapezoidal rule
-    
-    ArrayXd totalLogWeight(totalNpoints);
-    double reductionFactor = exp(-1.0/totalNlive);
+    // Merge the runs, and write the merged sample, its weights and the evidence
 
-    totalLogWeight(0) = log(0.5) + log(2 - reductionFactor - reductionFactor*reductionFactor);         // First boundary condition
-    totalLogWeight(totalNpoints-1) = log(0.5) + log(pow(reductionFactor,totalNpoints-2) - pow(reductionFactor,totalNpoints));      // Second boundary condition
-
-    for (int i=1; i < totalNpoints - 1; i++)
+    if (useArchives)
     {
-        totalLogWeight(i) = log(0.5) + log(pow(reductionFactor,i-1) - pow(reductionFactor,i+1));
+        merger.mergeToArchive(outputDirName + "mergedArchive.bin");
     }
-    
-
-    // Compute final total evidence and its error bar
-
-    double logEvidence = numeric_limits<double>::lowest();
-    double informationGain = 0.0; 
-
-
-    // Update the evidence and the information Gain
-    
-    for (int i=0; i < totalNpoints; ++i)
+    else
     {
-        double logEvidenceContributionNew = totalLogWeight(i) + totalLogLikelihood(i);    
-        double logEvidenceNew = Functions::logExpSum(logEvidence, logEvidenceContributionNew);
-        informationGain = exp(logEvidenceContributionNew - logEvidenceNew) * totalLogLikelihood(i) 
-                    + exp(logEvidence - logEvidenceNew) * (informationGain + logEvidence) 
-                    - logEvidenceNew;
-        logEvidence = logEvidenceNew;
+        merger.mergeToFiles(outputDirName);
     }
 
-
-    // Compute Skilling's error on the log(Evidence)
-    
-    double logEvidenceError = sqrt(fabs(informationGain)/totalNlive); 
-
+    int totalNlive = merger.getTotalNlive();
+    long totalNpoints = merger.getNsamples();
 
 
     // Set up NestedSampler with current information
@@ -202,12 +148,6 @@ int main(int argc, char *argv[])
 
     ZeroSampler nestedSampler(printOnTheScreen, initialNobjects, minNobjects, ptrPriors, likelihood, metric, clusterer);
     
-    nestedSampler.setLogEvidence(logEvidence);
-    nestedSampler.setLogEvidenceError(logEvidenceError);
-    nestedSampler.setInformationGain(informationGain);
-    nestedSampler.setPosteriorSample(totalParameterValues);
-    nestedSampler.setLogLikelihoodOfPosteriorSample(totalLogLikelihood);
-    nestedSampler.setLogWeightOfPosteriorSample(totalLogWeight);
     nestedSampler.setOutputPathPrefix(outputDirName);
     
 
@@ -226,15 +166,42 @@ int main(int argc, char *argv[])
 
     nestedSampler.outputFile.close();
 
-    Results results(nestedSampler);
-    results.writeParametersToFile("parameter");
-    results.writeLogLikelihoodToFile("logLikelihood.txt");
-    results.writeLogWeightsToFile("logWeight.txt");
-    results.writeEvidenceInformationToFile("evidenceInformation.txt");
-    results.writePosteriorProbabilityToFile("posteriorDistribution.txt");
+    // Compute the posterior probability and the parameter estimation of the merged sample.
+    // These need the whole sample, which is read back from the merged output.
 
+    Results results(nestedSampler);
     double credibleLevel = 68.3;
     bool writeMarginalDistributionToFile = true;
+
+    if (useArchives)
+    {
+        results.readArchive(outputDirName + "mergedArchive.bin");
+        results.writeArchive("mergedArchive.bin", false, credibleLevel, writeMarginalDistributionToFile);
+
+        cerr << "------------------------------------------------" << endl;
+        cerr << " Merging complete." << endl;
+        cerr << "------------------------------------------------" << endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    ArrayXXd totalParameterValues(Ndimensions, totalNpoints);
+
+    for (int j=0; j < Ndimensions; j++)
+    {
+        ostringstream numberString2;
+        numberString2 << setfill('0') << setw(3) << j;
+        totalParameterValues.row(j) = File::arrayXXdFromMappedFile(outputDirName + "parameter" + numberString2.str() + ".txt").transpose();
+    }
+
+    nestedSampler.setPosteriorSample(totalParameterValues);
+    nestedSampler.setLogLikelihoodOfPosteriorSample(File::arrayXXdFromMappedFile(outputDirName + "logLikelihood.txt").col(0));
+    nestedSampler.setLogWeightOfPosteriorSample(File::arrayXXdFromMappedFile(outputDirName + "logWeight.txt").col(0));
+    nestedSampler.setLogEvidence(merger.getLogEvidence());
+    nestedSampler.setLogEvidenceError(merger.getLogEvidenceError());
+    nestedSampler.setInformationGain(merger.getInformationGain());
+
+    results.writePosteriorProbabilityToFile("posteriorDistribution.txt");
     results.writeParametersSummaryToFile("parameterSummary.txt", credibleLevel, writeMarginalDistributionToFile);
 
     cerr << "------------------------------------------------" << endl;
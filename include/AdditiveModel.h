@@ -0,0 +1,72 @@
+// Abstract class for models that are a sum of independent components, 
+// each depending on its own block of free parameters (e.g. a background
+// plus a set of oscillation modes). The sum of the contributions is cached,
+// so that only the components whose parameters changed since the previous
+// prediction are recomputed.
+// Header file "AdditiveModel.h"
+// Implementations contained in "AdditiveModel.cpp"
+
+
+#ifndef ADDITIVEMODEL_H
+#define ADDITIVEMODEL_H
+
+#include <cassert>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Core>
+#include "Model.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class AdditiveModel : public Model
+{
+    public:
+
+        AdditiveModel(const RefArrayXd covariates, const int NupdatesBetweenRefreshes = 1000);
+        ~AdditiveModel();
+
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) override;
+        void clearCache();
+
+        int getNcomponents();
+        unsigned long getNcomponentEvaluations();
+
+
+    protected:
+
+        void addComponent(const int firstParameterIndex, const int NparametersOfComponent);
+        virtual void predictComponent(RefArrayXd contribution, const int componentIndex, const RefArrayXd componentParameters) = 0;
+
+
+    private:
+
+        struct Cache
+        {
+            ArrayXd totalContribution;              // The sum of the contributions of all components
+            ArrayXd cachedParameters;               // The free parameters for which totalContribution was computed
+            ArrayXd componentContribution;          // Workspace for the contribution of a single component
+            bool isValid;
+            int NupdatesSinceRefresh;               // Number of components updated since totalContribution was last summed from scratch
+        };
+
+        vector<int> firstParameterIndices;          // For each component, the index of its first free parameter
+        vector<int> NparametersOfComponents;        // For each component, the number of its (consecutive) free parameters
+        int NupdatesBetweenRefreshes;
+        atomic<unsigned long> NcomponentEvaluations;
+        unordered_map<thread::id, Cache> caches;    // One cache for each thread calling predict()
+        mutex cachesMutex;                          // Only protects the look-up of the cache of a thread
+
+        Cache &getCache();
+        void updateComponent(Cache &cache, const int component, const RefArrayXd modelParameters);
+};
+
+
+#endif
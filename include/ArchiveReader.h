@@ -0,0 +1,71 @@
+// Class for reading a binary archive written by an ArchiveWriter. The archive
+// is memory-mapped, and its blocks are located when it is opened, so that
+// each array is copied only once, directly from the mapped file. The blocks
+// with the same name are concatenated row-wise. An incomplete last block,
+// e.g. from an interrupted run, is skipped.
+// Header file "ArchiveReader.h"
+// Implementation contained in "ArchiveReader.cpp"
+
+
+#ifndef ARCHIVEREADER_H
+#define ARCHIVEREADER_H
+
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <Eigen/Core>
+#include "ArchiveWriter.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+
+
+class ArchiveReader
+{
+    public:
+
+        ArchiveReader(string fullPath);
+        ~ArchiveReader();
+
+        vector<string> getBlockNames();
+        bool containsBlock(string name);
+        uint64_t getNrows(string name);
+
+        ArrayXXd readArrayXXd(string name);
+        ArrayXXd readArrayXXd(string name, const uint64_t firstRow, const uint64_t Nrows);
+        ArrayXd readArrayXd(string name);
+        string readText(string name);
+
+
+    protected:
+
+    private:
+
+        struct Block
+        {
+            string name;
+            uint32_t type;
+            uint64_t Nrows;
+            uint64_t Ncols;
+            const char *values;             // Pointer to the first value in the mapped archive
+        };
+
+        string fullPath;
+        void *mapping;
+        size_t archiveSize;
+        vector<Block> blocks;
+};
+
+
+#endif
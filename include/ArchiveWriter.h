@@ -0,0 +1,77 @@
+// Class for writing a binary archive of the results of a run, as a sequence
+// of named blocks. Each block holds either a two-dimensional array of float64
+// or float32 values, stored column after column in little-endian byte order,
+// or a text. Blocks are appended one after the other, so that an array can be
+// streamed in pieces: the blocks with the same name are concatenated row-wise
+// when the archive is read with an ArchiveReader.
+//
+// Layout of the archive:
+//      - the header: the 8 characters "DIAMONDS", the format version (uint32)
+//        and the size of the header (uint32)
+//      - for each block: the length of the name (uint32), the name, the type
+//        of the values (uint32), the number of rows and columns (uint64), zero
+//        padding up to a multiple of 8 bytes, and the values. A text is stored
+//        as a single column of Nrows characters.
+//
+// Header file "ArchiveWriter.h"
+// Implementation contained in "ArchiveWriter.cpp"
+
+
+#ifndef ARCHIVEWRITER_H
+#define ARCHIVEWRITER_H
+
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <unistd.h>
+#include <Eigen/Core>
+
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+using Eigen::ArrayXXf;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXXd> RefArrayXXd;
+
+
+class ArchiveWriter
+{
+    public:
+
+        enum BlockType {text = 0, float64 = 1, float32 = 2};
+
+        static const char archiveSignature[8];
+        static const uint32_t formatVersion = 1;
+
+        ArchiveWriter(string fullPath, const bool appendToExistingArchive = false);
+        ~ArchiveWriter();
+
+        void appendArrayXXd(string name, RefArrayXXd const array, const bool singlePrecision = false);
+        void appendArrayXd(string name, RefArrayXd const array, const bool singlePrecision = false);
+        void appendText(string name, string text);
+        void close();
+
+        static bool hostIsLittleEndian();
+
+
+    protected:
+
+    private:
+
+        ofstream outputFile;
+        string fullPath;
+        uint64_t position;                  // Number of bytes written to the archive so far
+
+        uint64_t findEndOfCompleteBlocks(ifstream &existingFile, const uint64_t archiveSize);
+        void writeBlockHeader(string name, const BlockType type, const uint64_t Nrows, const uint64_t Ncols);
+        void writeBytes(const void *bytes, const uint64_t Nbytes);
+};
+
+
+#endif
@@ -0,0 +1,71 @@
+// Derived class for a likelihood that memoizes the log-likelihood values 
+// of another likelihood. The parameter vectors are quantized, so that
+// points on the same node of a parameter grid share a single evaluation,
+// made at the node itself (see ParameterQuantizer).
+// The cache has a bounded number of entries, the least recently used 
+// entry being evicted first, and can be used from several threads.
+// Header file "CachedLikelihood.h"
+// Implementations contained in "CachedLikelihood.cpp"
+
+
+#ifndef CACHEDLIKELIHOOD_H
+#define CACHEDLIKELIHOOD_H
+
+#include <cassert>
+#include <list>
+#include <mutex>
+#include <utility>
+#include <unordered_map>
+#include "Likelihood.h"
+#include "ParameterQuantizer.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class CachedLikelihood : public Likelihood
+{
+
+    public:
+
+        CachedLikelihood(Likelihood &likelihood, const RefArrayXd quantizationSteps, const size_t maxNentries = 100000);
+        ~CachedLikelihood();
+
+        virtual unsigned long long fingerprint() override;
+        virtual double logValue(RefArrayXd const modelParameters) override;
+        virtual double logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold) override;
+
+        void clear();
+        unsigned long getNhits();
+        unsigned long getNmisses();
+        size_t getNentries();
+        size_t getMaxNentries();
+
+
+    protected:
+
+        typedef ParameterQuantizer::Key Key;
+        typedef ParameterQuantizer::KeyHash KeyHash;
+
+
+    private:
+
+        Likelihood &likelihood;                 // The likelihood whose values are cached
+        ParameterQuantizer quantizer;           // Rounds the parameters to the nodes of the grid
+        size_t maxNentries;
+        unsigned long Nhits;
+        unsigned long Nmisses;
+        mutex cacheMutex;
+        list<pair<Key, double>> entries;        // Ordered from most to least recently used
+        unordered_map<Key, list<pair<Key, double>>::iterator, KeyHash> entryOfKey;
+
+        CachedLikelihood(Likelihood &likelihood, ArrayXd observations, const RefArrayXd quantizationSteps, const size_t maxNentries);
+
+        bool lookUp(const Key &key, double &logLikelihood);
+        void insert(const Key &key, const double logLikelihood);
+
+}; 
+
+#endif
@@ -0,0 +1,58 @@
+// Derived class for a normal likelihood with correlated noise, whose covariance
+// is given by a semiseparable ("celerite") kernel: a sum of exponentially decaying
+// terms, possibly modulated by a cosine and a sine (Foreman-Mackey et al. 2017, AJ 154, 220).
+// The log-determinant and the quadratic form of the covariance matrix are computed
+// in O(N J^2) with the semiseparable Cholesky factorization, where N is the number
+// of observations and J the number of terms of the kernel.
+// Header file "CeleriteLikelihood.h"
+// Implementations contained in "CeleriteLikelihood.cpp"
+
+
+#ifndef CELERITELIKELIHOOD_H
+#define CELERITELIKELIHOOD_H
+
+#include <cmath>
+#include <iostream>
+#include <cstdlib>
+#include <cassert>
+#include <limits>
+#include "Likelihood.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class CeleriteLikelihood : public Likelihood
+{
+
+    public:
+
+        CeleriteLikelihood(const RefArrayXd observations, const RefArrayXd uncertainties, Model &model,
+                           const int NrealTerms, const int NcomplexTerms);
+        ~CeleriteLikelihood();
+
+        ArrayXd getUncertainties();
+        int getNrealTerms();
+        int getNcomplexTerms();
+        int getNkernelParameters();
+
+        virtual unsigned long long fingerprint() override;
+        using Likelihood::logValue;
+        virtual double logValue(RefArrayXd const modelParameters) override;
+
+
+    private:
+
+        ArrayXd uncertainties;
+        ArrayXd squaredUncertainties;
+        ArrayXd covariates;                 // Copy of the covariates of the model, e.g. the times of the observations
+        ArrayXd timeDifferences;            // Differences between consecutive covariates, the first one being zero
+        int NrealTerms;                     // Terms a * exp(-c * tau)
+        int NcomplexTerms;                  // Terms exp(-c * tau) * (a * cos(d * tau) + b * sin(d * tau))
+
+}; // END class CeleriteLikelihood
+
+#endif
@@ -26,6 +26,7 @@ class Clusterer
         ~Clusterer(){};
     
         virtual int cluster(RefArrayXXd sample, vector<int> &optimalClusterIndices, vector<int> &optimalClusterSizes) = 0;
+        Metric &getMetric();
 
 
     protected:
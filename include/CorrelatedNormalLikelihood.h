@@ -0,0 +1,60 @@
+// Derived class for a normal likelihood with correlated errors, whose covariance
+// matrix is known and fixed. The covariance matrix is factorized once at construction,
+// either with a banded Cholesky decomposition, or with the Levinson-Durbin recursion
+// for a stationary (Toeplitz) covariance. Each evaluation is then a single triangular
+// solve on the residuals.
+// Header file "CorrelatedNormalLikelihood.h"
+// Implementations contained in "CorrelatedNormalLikelihood.cpp"
+
+
+#ifndef CORRELATEDNORMALLIKELIHOOD_H
+#define CORRELATEDNORMALLIKELIHOOD_H
+
+#include <cmath>
+#include <iostream>
+#include <cstdlib>
+#include <cassert>
+#include <vector>
+#include "Likelihood.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXXd> RefArrayXXd;
+
+
+class CorrelatedNormalLikelihood : public Likelihood
+{
+
+    public:
+
+        CorrelatedNormalLikelihood(const RefArrayXd observations, const RefArrayXXd bandedCovariance, Model &model);
+        CorrelatedNormalLikelihood(const RefArrayXd observations, const RefArrayXd autocovariance, Model &model,
+                                   const double relTolerance);
+        ~CorrelatedNormalLikelihood();
+
+        int getBandwidth();
+        double getLogDeterminant();
+
+        virtual unsigned long long fingerprint() override;
+        using Likelihood::logValue;
+        virtual double logValue(RefArrayXd const modelParameters) override;
+
+
+    private:
+
+        bool covarianceIsToeplitz;
+        ArrayXXd choleskyBand;                          // choleskyBand(k,n) = L(n,n-k) of the banded Cholesky factor L
+        vector<ArrayXd> predictionCoefficients;         // Levinson-Durbin coefficients of the linear predictor of each order
+        ArrayXd predictionErrorVariances;               // Variance of the prediction error for each order
+        double normalizationConstant;                   // -0.5 * (N log(2 pi) + log|covariance|)
+        double logDeterminant;
+
+        void factorizeBandedCovariance(const RefArrayXXd bandedCovariance);
+        void factorizeToeplitzCovariance(const RefArrayXd autocovariance, const double relTolerance);
+
+}; // END class CorrelatedNormalLikelihood
+
+#endif
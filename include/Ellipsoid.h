@@ -18,6 +18,7 @@
 #include <cassert>
 #include <Eigen/Dense>
 #include "Functions.h"
+#include "RandomStreams.h"
 
 using namespace std;
 using namespace Eigen;
@@ -63,9 +64,8 @@ class Ellipsoid
     private:
 
         int Ndimensions;
-        mt19937 engine;
+        Philox4x32Engine engine;
         uniform_real_distribution<> uniform;
-        normal_distribution<> normal;  
 
 
 };
@@ -29,10 +29,13 @@ class ExponentialLikelihood : public Likelihood
         ~ExponentialLikelihood();
 
         virtual double logValue(RefArrayXd const modelParameters);
+        virtual double logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold);
 
 
     private:
 
+        ArrayXd remainingUpperBounds;       // For each segment, the upper bound of the sum of the terms of the following segments
+
 }; // END class ExponentialLikelihood
 
 #endif
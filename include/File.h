@@ -16,7 +16,19 @@
 #include <iomanip>
 #include <fstream>
 #include <sstream>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <cassert>
+#include <locale>
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <Eigen/Core>
+#include "ThreadPool.h"
 
 
 using namespace std;
@@ -33,12 +45,18 @@ namespace File
     ArrayXXd arrayXXdFromFile(ifstream &inputFile, const unsigned long Nrows, const int Ncols, char separator = ' ', char commentChar = '#');
     vector<string> vectorStringFromFile(ifstream &inputFile, const unsigned long Nrows, char commentChar = '#');
 
-    void arrayXXdToFile(ofstream &outputFile, RefArrayXXd array, string separator = "  ", string terminator = "\n");
-    void twoArrayXdToFile(ofstream &outputFile, RefArrayXd array1, RefArrayXd array2, string separator = "  ", string terminator = "\n");
-    void arrayXdToFile(ofstream &outputFile, RefArrayXd array, string terminator = "\n");
+    void arrayXXdToFile(ofstream &outputFile, RefArrayXXd array, string separator = "  ", string terminator = "\n", const int Nthreads = 1);
+    void twoArrayXdToFile(ofstream &outputFile, RefArrayXd array1, RefArrayXd array2, string separator = "  ", string terminator = "\n", 
+                          const int Nthreads = 1);
+    void arrayXdToFile(ofstream &outputFile, RefArrayXd array, string terminator = "\n", const int Nthreads = 1);
     void arrayXXdRowsToFiles(RefArrayXXd array, string fullPathPrefix, string fileExtension = ".txt", string terminator = "\n");
     void sniffFile(ifstream &inputFile, unsigned long &Nrows, int &Ncols, char separator = ' ', char commentChar = '#');
 
+    ArrayXXd arrayXXdFromMappedFile(string inputFileName, char separator = ' ', char commentChar = '#', const int Nthreads = 1);
+    bool parseDouble(const char *begin, const char *end, double &value);
+    int formatScientific(const double value, const int precision, char *output, const bool uppercase = false, 
+                         const bool showPositiveSign = false);
+
 }
 
 #endif
@@ -10,6 +10,7 @@
 #define FUNCTIONS_H
 
 #include <cmath>
+#include <complex>
 #include <cassert>
 #include <numeric>
 #include <functional>
@@ -29,6 +30,7 @@
 using namespace std;
 using namespace Eigen;
 typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXf> RefArrayXf;
 typedef Eigen::Ref<Eigen::ArrayXi> RefArrayXi;
 typedef Eigen::Ref<Eigen::ArrayXXd> RefArrayXXd;
 
@@ -48,6 +50,12 @@ namespace Functions
                                   const double centroid = 0.0, const double amplitude = 1.0, const double linewidth = 1.0);
     void modeProfileSinc(RefArrayXd predictions, const RefArrayXd covariates, 
                      const double centroid = 0.0, const double height = 1.0, const double resolution = 1.0);
+    void modeProfilesWindowed(RefArrayXd predictions, const RefArrayXd covariates, const RefArrayXd centroids, 
+                              const RefArrayXd heights, const RefArrayXd linewidths, const double windowWidth = 50.0);
+    void modeProfilesWithAmplitudeWindowed(RefArrayXd predictions, const RefArrayXd covariates, const RefArrayXd centroids, 
+                                           const RefArrayXd amplitudes, const RefArrayXd linewidths, const double windowWidth = 50.0);
+    void modeProfilesSincWindowed(RefArrayXd predictions, const RefArrayXd covariates, const RefArrayXd centroids, 
+                                  const RefArrayXd heights, const double resolution = 1.0, const double windowWidth = 50.0);
     double logGaussProfile(const double covariate, const double mu = 0.0, 
                            const double sigma = 1.0, const double amplitude = 1.0);
     void logGaussProfile(RefArrayXd predictions, const RefArrayXd covariates, const double mu = 0.0, 
@@ -73,6 +81,9 @@ namespace Functions
     inline double sum(const vector<double> &vec);
     double logExpSum(const double x, const double y);
     double logExpDifference(const double x, const double y);
+    double compensatedSum(RefArrayXf const array);
+    unsigned long long fnv1aHash(const void *data, const size_t Nbytes, 
+                                 const unsigned long long initialHash = 14695981039346656037ULL);
     void topDownMerge(RefArrayXd array1, RefArrayXd arrayCopy1,         // Only used within topDownMergeSort
                       RefArrayXd array2, RefArrayXd arrayCopy2, 
                       int beginIndex, int middleIndex, int endIndex);
@@ -85,9 +96,13 @@ namespace Functions
 
 
     vector<int> findArrayIndicesWithinBoundaries(RefArrayXd const array, double lowerBound, double upperBound);
+    void findSortedArrayIndicesWithinBoundaries(RefArrayXd const array, double lowerBound, double upperBound,
+                                                int &beginIndex, int &endIndex);
     int countArrayIndicesWithinBoundaries(RefArrayXd const array, double lowerBound, double upperBound);
     ArrayXd cubicSplineInterpolation(RefArrayXd const observedAbscissa, RefArrayXd const observedOrdinate, 
                                      RefArrayXd const interpolatedAbscissaUntruncated);
+    void rebinSpectrum(RefArrayXd const frequencies, RefArrayXd const spectrum, const int Nbins,
+                       ArrayXd &rebinnedFrequencies, ArrayXd &rebinnedSpectrum);
 
 
     // Utility functions
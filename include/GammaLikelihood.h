@@ -0,0 +1,47 @@
+// Derived class for the likelihood of a power spectrum averaged over Nbins
+// consecutive frequency bins. Each averaged value follows a chi-square 
+// distribution with 2*Nbins d.o.f., i.e. a gamma distribution with shape Nbins
+// and mean equal to the model. For Nbins = 1 it reduces to the ExponentialLikelihood.
+// Header file "GammaLikelihood.h"
+// Implementations contained in "GammaLikelihood.cpp"
+
+
+#ifndef GAMMALIKELIHOOD_H
+#define GAMMALIKELIHOOD_H
+
+#include <cmath>
+#include <iostream>
+#include <cstdlib>
+#include <cassert>
+#include "Likelihood.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class GammaLikelihood : public Likelihood
+{
+
+    public:
+
+        GammaLikelihood(const RefArrayXd observations, Model &model, const int Nbins);
+        ~GammaLikelihood();
+
+        int getNbins();
+
+        virtual unsigned long long fingerprint();
+        virtual double logValue(RefArrayXd const modelParameters);
+        virtual double logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold);
+
+
+    private:
+
+        int Nbins;                          // Number of frequency bins averaged into each observation
+        double normalizationConstant;       // The part of the log-likelihood that does not depend on the model
+        ArrayXd remainingUpperBounds;       // For each segment, the upper bound of the sum of the terms of the following segments
+
+}; // END class GammaLikelihood
+
+#endif
@@ -0,0 +1,83 @@
+// Class for a Gaussian-process emulator of the log-likelihood, trained
+// online on the evaluated points. It is used by the samplers to skip the
+// evaluation of candidate points whose upper confidence bound is below the
+// likelihood constraint. A random fraction of these points is still
+// evaluated, to monitor the rate of false rejections and keep it bounded.
+// Header file "GaussianProcessSurrogate.h"
+// Implementation contained in "GaussianProcessSurrogate.cpp"
+
+
+#ifndef GAUSSIANPROCESSSURROGATE_H
+#define GAUSSIANPROCESSSURROGATE_H
+
+#include <cmath>
+#include <cassert>
+#include <ctime>
+#include <random>
+#include <Eigen/Dense>
+#include "RandomStreams.h"
+
+
+using namespace std;
+using namespace Eigen;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class GaussianProcessSurrogate
+{
+    public:
+
+        GaussianProcessSurrogate(const int Ndimensions, const int maxNtrainingPoints = 500, const double kappa = 3.0, 
+                                 const double maxFalseRejectionRate = 0.01, const double auditFraction = 0.05,
+                                 const int minNtrainingPoints = 50);
+        ~GaussianProcessSurrogate();
+
+        bool pointCanBeSkipped(RefArrayXd const point, const double logLikelihoodThreshold);
+        void addEvaluatedPoint(RefArrayXd const point, const double logLikelihood, const double logLikelihoodThreshold);
+        void predict(RefArrayXd const point, double &mean, double &variance);
+
+        int getNtrainingPoints();
+        double getKappa();
+        unsigned long getNskippedPoints();
+        unsigned long getNaudits();
+        unsigned long getNfalseRejections();
+        double getFalseRejectionRate();
+
+
+    protected:
+
+    private:
+
+        int Ndimensions;
+        int maxNtrainingPoints;                 // Oldest training points are dropped beyond this number
+        int minNtrainingPoints;                 // No point is skipped before the surrogate has this many training points
+        double kappa;                           // Number of standard deviations in the upper confidence bound
+        double maxFalseRejectionRate;           // kappa is increased when the audited false rejection rate exceeds this value
+        double auditFraction;                   // Fraction of the points predicted to be rejected that are evaluated anyway
+        int Ntraining;                          // Current number of training points
+        int NpointsSinceRefit;
+        bool auditIsPending;                    // The last point passed to pointCanBeSkipped() is an audit
+        unsigned long NskippedPoints;
+        unsigned long Naudits;                  // Audits since the last increase of kappa
+        unsigned long NfalseRejections;         // Audited points with a log-likelihood above the threshold
+        unsigned long totalNaudits;
+        unsigned long totalNfalseRejections;
+        MatrixXd trainingPoints;                // (Ndimensions, maxNtrainingPoints)
+        VectorXd trainingValues;
+        VectorXd lengthScales;
+        double signalVariance;
+        double noiseVariance;
+        double meanValue;
+        bool fitIsValid;                        // False if the kernel matrix could not be factorized
+        MatrixXd choleskyFactor;                // Lower triangular Cholesky factor of the kernel matrix of the training points
+        VectorXd weights;                       // Inverse kernel matrix times the training values minus their mean
+        Philox4x32Engine engine;
+        uniform_real_distribution<> uniform;
+
+        double kernel(const VectorXd &point1, const VectorXd &point2);
+        void refit();
+        void appendToFit();
+};
+
+
+#endif
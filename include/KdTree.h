@@ -0,0 +1,88 @@
+// Class for building a k-d tree over a sample of points, to be
+// used for nearest-neighbour and range queries on the live points.
+// The tree is updated incrementally and rebalanced lazily.
+// Header file "KdTree.h"
+// Implementation contained in "KdTree.cpp"
+
+
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include <cmath>
+#include <cassert>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include <Eigen/Core>
+
+
+using namespace std;
+using namespace Eigen;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXXd> RefArrayXXd;
+
+
+class KdTree
+{
+    public:
+
+        KdTree(const int maxNpointsPerLeaf = 8, const double maxFractionOfModifications = 0.25);
+        ~KdTree();
+
+        void build(RefArrayXXd const sample);
+        void replacePoint(const int pointIndex, RefArrayXd const newCoordinates);
+        void removePoint(const int pointIndex);
+        void rebalance();
+
+        void findNearestNeighbours(RefArrayXd const queryPoint, const int Nneighbours,
+                                   vector<int> &neighbourIndices, vector<double> &neighbourDistances);
+        void findNearestNeighbours(RefArrayXXd queryPoints, const int Nneighbours,
+                                   vector<vector<int>> &neighbourIndices);
+        vector<int> findPointsWithinRadius(RefArrayXd const queryPoint, const double radius);
+        void findPointsWithinRadius(RefArrayXXd queryPoints, const double radius,
+                                    vector<vector<int>> &pointIndices);
+
+        int getNpoints();
+        int getNdimensions();
+        int getNmodificationsSinceRebalance();
+        ArrayXXd getSample();
+
+
+    protected:
+
+        struct Node
+        {
+            int splitDimension;                 // Coordinate along which the node is split (-1 for a leaf)
+            double splitValue;                  // Points with coordinate < splitValue go to the left child
+            int leftChild;
+            int rightChild;
+            vector<int> pointIndices;           // Only used by leaves
+        };
+
+
+    private:
+
+        int Ndimensions;
+        int Npoints;
+        int maxNpointsPerLeaf;                  // Leaves are split during (re)building when they contain more points
+        int NmodificationsSinceRebalance;       // Number of insertions and removals since the last (re)build
+        double maxFractionOfModifications;      // The tree is rebuilt when NmodificationsSinceRebalance exceeds this fraction of Npoints
+        ArrayXXd sample;                        // Coordinates of the points, of size (Ndimensions, Npoints)
+        vector<Node> nodes;
+        vector<int> leafOfPoint;                // For each point the index of the leaf node containing it
+
+        int buildSubtree(vector<int> &pointIndices, const int beginIndex, const int endIndex);
+        void insertPoint(const int pointIndex);
+        void detachPoint(const int pointIndex);
+        void rebalanceIfNeeded();
+        void searchNearestNeighbours(const int nodeIndex, RefArrayXd const queryPoint, const int Nneighbours,
+                                     priority_queue<pair<double,int>> &bestCandidates);
+        void searchWithinRadius(const int nodeIndex, RefArrayXd const queryPoint, const double squaredRadius,
+                                vector<int> &pointIndices);
+};
+
+
+#endif
@@ -15,6 +15,7 @@
 #include <limits>
 #include <iostream>
 #include "Clusterer.h"
+#include "RandomStreams.h"
 
 
 using namespace std;
@@ -32,21 +33,22 @@ class KmeansClusterer : public Clusterer
 
     protected:
    
-
-    private:
-    
-        void chooseInitialClusterCenters(RefArrayXXd sample, RefArrayXXd centers, unsigned int Nclusters);
-        bool updateClusterCentersUntilConverged(RefArrayXXd sample, RefArrayXXd centers, 
-                                                RefArrayXd clusterSizes, vector<int> &clusterIndices,
-                                                double &sumOfDistancesToClosestCenter, double relTolerance);
-        double evaluateBICvalue(RefArrayXXd sample, RefArrayXXd centers, RefArrayXd clusterSizes, 
-                                vector<int> &clusterIndices);
+        virtual void chooseInitialClusterCenters(RefArrayXXd sample, RefArrayXXd centers, unsigned int Nclusters);
+        virtual bool updateClusterCentersUntilConverged(RefArrayXXd sample, RefArrayXXd centers, 
+                                                        RefArrayXd clusterSizes, vector<int> &clusterIndices,
+                                                        double &sumOfDistancesToClosestCenter, double relTolerance);
 
         unsigned int minNclusters;
         unsigned int maxNclusters;
         unsigned int Ntrials;
         double relTolerance;
-        mt19937 engine;
+        Philox4x32Engine engine;
+
+
+    private:
+    
+        double evaluateBICvalue(RefArrayXXd sample, RefArrayXXd centers, RefArrayXd clusterSizes, 
+                                vector<int> &clusterIndices);
 
 };
 
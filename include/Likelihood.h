@@ -7,13 +7,26 @@
 #ifndef LIKELIHOOD_H
 #define LIKELIHOOD_H
 
+#include <unordered_map>
+#include <map>
+#include <utility>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <typeinfo>
 #include <Eigen/Core>
 #include "Functions.h"
 #include "Model.h"
+#include "ThreadPool.h"
 
 
 using namespace std;
 using Eigen::ArrayXd;
+using Eigen::ArrayXf;
+using Eigen::ArrayXXd;
 typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
 
 
@@ -25,19 +38,51 @@ class Likelihood
         Likelihood(const RefArrayXd observations, Model &model);
         ~Likelihood();
         ArrayXd getObservations();
+        Model &getModel();
+        virtual unsigned long long fingerprint();
+
+        void setSinglePrecision(const bool newSinglePrecisionIsUsed);
+        bool getSinglePrecision();
+
+        void setNthreads(const int Nthreads);
+        int getNthreads();
 
         virtual double logValue(RefArrayXd const modelParameters) = 0;
+        virtual double logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold);
 
 
     protected:
         
         ArrayXd observations;
+        ArrayXf observationsSinglePrecision;        // The observations rounded to single precision, empty until single precision is chosen
         Model &model;
+        bool singlePrecisionIsUsed;                 // If true, the predictions are computed in single precision
+        static const int segmentSize;               // Number of observations per segment in sumOverSegments() and boundedSumOverSegments()
+
+        ArrayXd &getPredictionsWorkspace();
+        ArrayXf &getSinglePrecisionPredictionsWorkspace();
+        ArrayXd &getVectorWorkspace(const int workspaceIndex, const int size);
+        ArrayXXd &getMatrixWorkspace(const int workspaceIndex, const int Nrows, const int Ncols);
+        virtual void prepareSinglePrecision();
+        void refuseLinearParameters(const string likelihoodName);
+        double sumOverSegments(RefArrayXd const modelParameters, 
+                               const function<double(const int beginIndex, RefArrayXd predictions)> &segmentSum);
+        double sumOverSegments(const function<double(const int beginIndex, const int length)> &segmentSum);
+        double boundedSumOverSegments(RefArrayXd const modelParameters, const double logLikelihoodThreshold,
+                                      const function<double(const int beginIndex, RefArrayXd predictions)> &segmentSum,
+                                      const function<double(const int NsegmentsDone, const double partialSum)> &upperBound);
 
 
     private:
 
-        
+        unique_ptr<ThreadPool> threadPool;          // Only used when the observations are split over several threads
+        unordered_map<thread::id, ArrayXd> predictionsWorkspaces;                   // One buffer for each calling thread
+        unordered_map<thread::id, ArrayXf> singlePrecisionPredictionsWorkspaces;
+        map<pair<thread::id, int>, ArrayXd> vectorWorkspaces;                       // Further buffers, by thread and index (negative indices for the base class)
+        map<pair<thread::id, int>, ArrayXXd> matrixWorkspaces;                      // Further buffers of derived classes, by thread and index
+        static const int segmentPredictionsWorkspaceIndex;                          // Index of the vector buffer used by sumOverSegments()
+        mutex workspacesMutex;                      // Only protects the look-up of the buffers of a thread
+
 };
 
 #endif
@@ -34,7 +34,7 @@ class LivePointsReducer
         LivePointsReducer(NestedSampler &nestedSampler);
         ~LivePointsReducer();
        
-        vector<int> findIndicesOfLivePointsToRemove(mt19937 engine);
+        vector<int> findIndicesOfLivePointsToRemove(Philox4x32Engine &engine);
         int getNlivePointsToRemove();
 
         virtual int updateNlivePoints() = 0;
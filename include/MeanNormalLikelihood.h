@@ -30,13 +30,19 @@ class MeanNormalLikelihood : public Likelihood
         ArrayXd getNormalizedUncertainties();
         ArrayXd getWeights();
 
+        virtual unsigned long long fingerprint();
         virtual double logValue(RefArrayXd const modelParameters);
+        virtual double logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold);
 
     private:
         
         ArrayXd uncertainties;
         ArrayXd normalizedUncertainties;
         ArrayXd weights;
+        ArrayXf weightsSinglePrecision;
+        double normalizationConstant;       // The part of the log-likelihood that does not depend on the model
+
+        virtual void prepareSinglePrecision();
 
 }; // END class MeanNormalLikelihood
 
@@ -0,0 +1,53 @@
+// Derived class for mini-batch K-means clustering algorithm
+// (Sculley D., 2010, Proc. 19th Int. Conf. on World Wide Web, 1177).
+// The cluster centers are updated from small random subsets of the sample,
+// which makes the cost of each update independent of the sample size.
+// Header file "MiniBatchKmeansClusterer.h"
+// Implementations contained in "MiniBatchKmeansClusterer.cpp"
+
+
+#ifndef MINIBATCHKMEANSCLUSTERER_H
+#define MINIBATCHKMEANSCLUSTERER_H
+
+#include <ctime>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <limits>
+#include <iostream>
+#include "KmeansClusterer.h"
+
+
+using namespace std;
+
+
+class MiniBatchKmeansClusterer : public KmeansClusterer
+{
+    public:
+
+        MiniBatchKmeansClusterer(Metric &metric, unsigned int minNclusters, unsigned int maxNclusters, unsigned int Ntrials,
+                                 double relTolerance, unsigned int batchSize = 256, unsigned int maxNepochs = 100);
+        ~MiniBatchKmeansClusterer();
+
+        unsigned int getBatchSize();
+        unsigned int getMaxNepochs();
+
+
+    protected:
+
+        virtual void chooseInitialClusterCenters(RefArrayXXd sample, RefArrayXXd centers, unsigned int Nclusters) override;
+        virtual bool updateClusterCentersUntilConverged(RefArrayXXd sample, RefArrayXXd centers,
+                                                        RefArrayXd clusterSizes, vector<int> &clusterIndices,
+                                                        double &sumOfDistancesToClosestCenter, double relTolerance) override;
+
+
+    private:
+
+        unsigned int batchSize;             // Number of points drawn from the sample for each update of the centers
+        unsigned int maxNepochs;            // Maximum number of mini-batch updates of the centers
+
+};
+
+
+
+#endif
@@ -9,13 +9,17 @@
 #define MODEL_H
 
 #include <cstdlib>
+#include <iostream>
 #include <Eigen/Core>
 #include "Functions.h"
 
 
 using namespace std;
 using Eigen::ArrayXd;
+using Eigen::ArrayXf;
 typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXf> RefArrayXf;
+typedef Eigen::Ref<Eigen::ArrayXXd> RefArrayXXd;
 
 
 class Model
@@ -27,12 +31,23 @@ class Model
         ArrayXd getCovariates();
 
         virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) = 0;
+        virtual void predictSinglePrecision(RefArrayXf predictions, const RefArrayXd modelParameters);
+        virtual bool canPredictSinglePrecision();
+        void prepareSinglePrecision();
+        virtual void predictSegment(RefArrayXd predictions, const RefArrayXd modelParameters, const int beginIndex);
+        virtual bool canPredictSegments();
+        virtual int getNlinearParameters();
+        virtual void predictDesignMatrix(RefArrayXXd designMatrix, const RefArrayXd modelParameters);
         int getNparameters();
 
 
     protected:
         
         ArrayXd covariates;
+        ArrayXf covariatesSinglePrecision;          // The covariates minus the origin of their block, in single precision, 
+                                                    // for predictSinglePrecision(). Empty until prepareSinglePrecision() is called.
+        ArrayXd covariatesBlockOrigins;             // The origin of each block of singlePrecisionBlockSize consecutive covariates
+        static const int singlePrecisionBlockSize = 1024;
         int Nparameters;
 
 
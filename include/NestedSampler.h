@@ -20,10 +20,14 @@
 #include "Functions.h"
 #include "Prior.h"
 #include "Likelihood.h"
+#include "CachedLikelihood.h"
 #include "Metric.h"
 #include "Clusterer.h"
 #include "LivePointsReducer.h"
+#include "KdTree.h"
+#include "GaussianProcessSurrogate.h"
 #include "File.h"
+#include "RandomStreams.h"
 
 
 using namespace std;
@@ -67,6 +71,19 @@ class NestedSampler
         vector<int> getNlivePointsPerIteration();
         ArrayXXd getNestedSample();
         ArrayXd getLogLikelihood();
+        void setLivePointsTreeEnabled(const bool isEnabled);
+        bool getLivePointsTreeEnabled();
+        KdTree &getLivePointsTree();
+        unsigned int getNclusterings();
+
+        void setDriftTriggeredClustering(const bool isEnabled, const double minAcceptanceRateFraction = 0.5, 
+                                         const double maxRelativeShift = 0.25,
+                                         const int minNiterationsBetweenClusterings = 10, 
+                                         const int maxNiterationsBetweenClusterings = 1000);
+        bool getDriftTriggeredClustering();
+
+        void setSurrogate(GaussianProcessSurrogate *newSurrogate);
+        GaussianProcessSurrogate *getSurrogate();
         
         void setLogEvidence(double newLogEvidence);
         double getLogEvidence();
@@ -107,8 +124,12 @@ class NestedSampler
         double logRemainingPriorMass;               // The remaining width in prior mass at a given nested iteration (log X)
         double ratioOfRemainderToCurrentEvidence;   // The current ratio of live to cumulated evidence 
         vector<int> NlivePointsPerIteration;           // A vector that stores the number of live points used at each iteration of the nesting process
+        bool livePointsTreeIsEnabled;               // If true, livePointsTree is kept up to date during the nesting process (false by default)
+        KdTree livePointsTree;                      // A k-d tree over the current live sample, only built if livePointsTreeIsEnabled
+        int NdrawAttempts;                          // The number of attempts needed by drawWithConstraint() to find the last new point
+        GaussianProcessSurrogate *surrogate;        // An optional emulator of the log-likelihood, to skip candidate points (nullptr if not used)
         
-        mt19937 engine;
+        Philox4x32Engine engine;
 
         virtual bool verifySamplerStatus() = 0; 
         
@@ -133,9 +154,31 @@ class NestedSampler
         ArrayXd logLikelihoodOfPosteriorSample;  // log(Likelihood) values corresponding to the posterior sample 
         ArrayXd logWeightOfPosteriorSample;      // log(Weights) = log(Likelihood) + log(dX) corresponding to the posterior sample
 
+        bool driftTriggeredClusteringIsEnabled;  // If true, recluster when the live sample drifted away from the last clustering
+        double minAcceptanceRateFraction;        // Recluster when the smoothed acceptance rate drops below this fraction of its reference value
+        double maxRelativeShift;                 // Recluster when a cluster mean or spread changed by more than this fraction of its size
+        int minNiterationsBetweenClusterings;    // Never recluster more often than this
+        int maxNiterationsBetweenClusterings;    // Always recluster at least this often
+        unsigned int Nclusterings;               // Number of times the clusterer was called
+        unsigned int lastClusteringIteration;    // Iteration at which the live sample was last clustered
+        int NnewPointsSinceClustering;           // Number of new points drawn since the last clustering
+        int NdrawAttemptsSinceClustering;        // Number of draw attempts needed for these new points
+        double smoothedNdrawAttempts;            // Exponential moving average of NdrawAttempts
+        double referenceAcceptanceRate;          // Acceptance rate during the first iterations after the last clustering
+        ArrayXXd clusterSumOfCoordinates;        // Per cluster the sum of the coordinates of its live points (Ndimensions, Nclusters)
+        ArrayXXd clusterSumOfSquaredCoordinates; // Per cluster the sum of the squared coordinates of its live points
+        ArrayXXd referenceClusterMeans;          // Per cluster the mean of its live points at the last clustering
+        ArrayXd referenceClusterSpreads;         // Per cluster the trace of its covariance matrix at the last clustering
+        vector<int> referenceClusterSizes;       // Per cluster the number of its live points at the last clustering
+
         void removeLivePointsFromSample(const vector<int> &indicesOfLivePointsToRemove, 
                                         vector<int> &clusterIndices, vector<int> &clusterSizes);
         void printComputationalTime(const double startTime);
+        void computeClusterSums(const unsigned int Nclusters, const vector<int> &clusterIndices);
+        void resetDriftStatistics(const unsigned int Nclusters, const vector<int> &clusterIndices, const vector<int> &clusterSizes);
+        void updateDriftStatistics(RefArrayXd const removedPoint, RefArrayXd const newPoint, int &clusterIndex, 
+                                   vector<int> &clusterSizes);
+        bool clusteringHasDrifted(const vector<int> &clusterSizes);
 }; 
 
 #endif
@@ -12,11 +12,17 @@
 #include <iostream>
 #include <cstdlib>
 #include <cassert>
+#include <limits>
+#include <Eigen/Dense>
 #include "Likelihood.h"
 
 
 using namespace std;
 using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+using Eigen::VectorXd;
+using Eigen::MatrixXd;
+using Eigen::LDLT;
 typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
 
 
@@ -29,12 +35,25 @@ class NormalLikelihood : public Likelihood
         ~NormalLikelihood();
         ArrayXd getUncertainties();
 
+        void setLinearParametersLogPriorVolume(const double newLogPriorVolume);
+        double getLinearParametersLogPriorVolume();
+        ArrayXd getLinearParameters(RefArrayXd const modelParameters);
+
+        virtual unsigned long long fingerprint();
         virtual double logValue(RefArrayXd const modelParameters);
+        virtual double logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold);
 
 
     private:
 
         ArrayXd uncertainties;
+        ArrayXd inverseSquaredUncertainties;        // 1/uncertainties^2, computed once at construction
+        ArrayXf inverseSquaredUncertaintiesSinglePrecision;
+        double normalizationConstant;               // The part of the log-likelihood that does not depend on the model
+        double linearParametersLogPriorVolume;      // Log of the volume of the uniform prior of the marginalized linear parameters
+
+        double marginalizedLogValue(RefArrayXd const modelParameters, VectorXd &bestLinearParameters);
+        virtual void prepareSinglePrecision();
 
 }; 
 
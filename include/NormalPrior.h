@@ -38,7 +38,6 @@ class NormalPrior : public Prior
 
     private:
         
-        vector<normal_distribution<>> normalDistributionVector;
         uniform_real_distribution<> uniform;
         ArrayXd mean;
         ArrayXd standardDeviation;
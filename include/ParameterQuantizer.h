@@ -0,0 +1,54 @@
+// Class for rounding the free parameters to the nodes of a grid, and
+// computing a hashable key for each node. It is shared by the likelihoods
+// that store log-likelihood values per point (CachedLikelihood and
+// PersistentLikelihood), so that points on the same node of the grid
+// share a single evaluation, made at the node itself.
+// Header file "ParameterQuantizer.h"
+// Implementation contained in "ParameterQuantizer.cpp"
+
+
+#ifndef PARAMETERQUANTIZER_H
+#define PARAMETERQUANTIZER_H
+
+#include <cmath>
+#include <cstring>
+#include <cassert>
+#include <vector>
+#include <Eigen/Core>
+#include "Functions.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class ParameterQuantizer
+{
+    public:
+
+        typedef vector<long long> Key;
+
+        struct KeyHash
+        {
+            size_t operator()(const Key &key) const;
+        };
+
+        ParameterQuantizer(const RefArrayXd quantizationSteps);
+        ~ParameterQuantizer();
+
+        Key makeKey(RefArrayXd const modelParameters);
+        ArrayXd getNode(const Key &key);
+        ArrayXd getQuantizationSteps();
+        int getNdimensions();
+
+
+    protected:
+
+    private:
+
+        ArrayXd quantizationSteps;              // Parameters are rounded to multiples of these steps (exact values if a step is zero)
+
+}; 
+
+#endif
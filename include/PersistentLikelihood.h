@@ -0,0 +1,98 @@
+// Derived class for a likelihood that stores the log-likelihood values of
+// another likelihood in an append-only file, so that they can be replayed
+// by later runs on the same data and model, e.g. with different settings
+// of the sampler, or after an interruption. Each record is tagged with a
+// fingerprint of the likelihood (its class and data, the model class and
+// covariates, see Likelihood::fingerprint()), so that one file can be shared 
+// by different data sets. As in CachedLikelihood, the parameters can be
+// quantized, so that points on the same node of a grid share one record,
+// evaluated at the node itself (see ParameterQuantizer).
+// Header file "PersistentLikelihood.h"
+// Implementations contained in "PersistentLikelihood.cpp"
+
+
+#ifndef PERSISTENTLIKELIHOOD_H
+#define PERSISTENTLIKELIHOOD_H
+
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <typeinfo>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include "Likelihood.h"
+#include "Functions.h"
+#include "ParameterQuantizer.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+class PersistentLikelihood : public Likelihood
+{
+
+    public:
+
+        PersistentLikelihood(Likelihood &likelihood, const int Ndimensions, const string fileName, const string modelTag = "");
+        PersistentLikelihood(Likelihood &likelihood, const RefArrayXd quantizationSteps, const string fileName, 
+                             const string modelTag = "");
+        ~PersistentLikelihood();
+
+        virtual double logValue(RefArrayXd const modelParameters) override;
+        virtual double logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold) override;
+
+        virtual unsigned long long fingerprint() override;
+        unsigned long getNloadedEvaluations();
+        unsigned long getNreplayedEvaluations();
+        unsigned long getNstoredEvaluations();
+
+
+    protected:
+
+        typedef ParameterQuantizer::Key Key;
+        typedef ParameterQuantizer::KeyHash KeyHash;
+
+
+    private:
+
+        Likelihood &likelihood;                 // The likelihood whose values are stored
+        int Ndimensions;
+        ParameterQuantizer quantizer;           // Rounds the parameters to the nodes of the grid
+        string fileName;
+        int fileDescriptor;
+        size_t recordSize;                      // Fingerprint, Ndimensions parameters, and log-likelihood
+        unsigned long long storeFingerprint;    // The fingerprint with which the records of this object are tagged
+        unsigned long NloadedEvaluations;       // Records of the file with the same fingerprint, found at construction
+        unsigned long NreplayedEvaluations;
+        unsigned long NstoredEvaluations;       // Records appended by this object
+        mutex storeMutex;
+        unordered_map<Key, double, KeyHash> logLikelihoodOfKey;
+
+        PersistentLikelihood(Likelihood &likelihood, ArrayXd observations, ArrayXd quantizationSteps, 
+                             const string fileName, const string modelTag);
+
+        bool lookUp(const Key &key, double &logLikelihood);
+        void store(const Key &key, const double logLikelihood);
+        void openFile();
+        void loadRecords(const size_t Nrecords);
+        size_t countCompleteRecords();
+        size_t getFileSize();
+        void lockFile();
+        void unlockFile();
+
+}; 
+
+#endif
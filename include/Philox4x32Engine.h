@@ -0,0 +1,100 @@
+// Class for the Philox4x32-10 counter-based random number generator
+// (Salmon et al. 2011, Proc. Int. Conf. for High Performance Computing, 16).
+// Each block of 4 random 32-bit integers is a keyed bijection of a 128-bit
+// counter, so that a stream is selected with half of the counter, and any
+// position in a stream is reached in constant time. The state fits in three
+// 64-bit integers. It can be used with all random distributions of <random>,
+// and fills Eigen arrays with uniform or normal variates in bulk, several
+// counters being processed side by side so that the compiler can vectorize.
+// Header file "Philox4x32Engine.h"
+// Implementation contained in "Philox4x32Engine.cpp"
+
+
+#ifndef PHILOX4X32ENGINE_H
+#define PHILOX4X32ENGINE_H
+
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <Eigen/Core>
+
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXXd> RefArrayXXd;
+
+
+class Philox4x32Engine
+{
+    public:
+
+        typedef uint32_t result_type;
+
+        Philox4x32Engine(const uint64_t seed = 0, const uint64_t streamIndex = 0);
+        ~Philox4x32Engine();
+
+        void seed(const uint64_t seed, const uint64_t streamIndex = 0);
+        void seek(const uint64_t position);
+        void discard(const uint64_t Nnumbers);
+
+        uint64_t getSeed();
+        uint64_t getStreamIndex();
+        uint64_t getPosition();
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return numeric_limits<result_type>::max(); }
+
+        inline result_type operator()();
+
+        void fillUniform(RefArrayXd values);
+        void fillNormal(RefArrayXd values);
+        void fillUniformSample(RefArrayXXd sample);
+        void fillNormalSample(RefArrayXXd sample);
+
+        static void generateBlock(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4]);
+
+
+    private:
+
+        uint64_t seedValue;                 // The key of the bijection
+        uint64_t streamIndex;               // The upper half of the counter
+        uint64_t blockIndex;                // The lower half of the counter, for the next block to be generated
+        uint32_t block[4];                  // The current block of random numbers
+        int indexInBlock;                   // Index of the next number in the current block, 4 if the block is used up
+        ArrayXd radii;                      // Buffers of fillNormal(), not part of the state of the stream
+        ArrayXd angles;
+
+        void generateNextBlock();
+        void generateUniforms(double *values, const int Nvalues, const bool zeroIsExcluded);
+};
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::operator()
+//
+// PURPOSE:
+//      Return the next random number of the stream.
+//
+// OUTPUT:
+//      A random 32-bit unsigned integer.
+//
+
+inline Philox4x32Engine::result_type Philox4x32Engine::operator()()
+{
+    if (indexInBlock == 4)
+    {
+        generateNextBlock();
+    }
+
+    return block[indexInBlock++];
+}
+
+
+#endif
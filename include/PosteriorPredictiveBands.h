@@ -0,0 +1,78 @@
+// Class for computing posterior predictive bands of a model, i.e. quantiles
+// of the model predictions over the posterior sample, for each covariate.
+// The posterior sample is resampled according to its weights, and the
+// predictions are computed in parallel, block by block. The quantiles are
+// estimated on the fly with the P^2 algorithm (Jain & Chlamtac 1985,
+// Comm. ACM 28, 1076), so that the memory does not grow with the number of samples.
+// Header file "PosteriorPredictiveBands.h"
+// Implementation contained in "PosteriorPredictiveBands.cpp"
+
+
+#ifndef POSTERIORPREDICTIVEBANDS_H
+#define POSTERIORPREDICTIVEBANDS_H
+
+#include <cmath>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <iomanip>
+#include <Eigen/Core>
+#include "File.h"
+#include "Model.h"
+#include "ThreadPool.h"
+#include "RandomStreams.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXXd> RefArrayXXd;
+
+
+class PosteriorPredictiveBands
+{
+    public:
+
+        PosteriorPredictiveBands(Model &model, const RefArrayXd quantileLevels, const int Nthreads = 1,
+                                 const int blockSize = 64);
+        ~PosteriorPredictiveBands();
+
+        void compute(RefArrayXXd const posteriorSample, RefArrayXd const posteriorProbability, const int Nsamples);
+        void writeBandsToFile(string fullPath);
+
+        ArrayXXd getBands();
+        ArrayXd getQuantileLevels();
+        int getNsamples();
+
+
+    protected:
+
+        struct QuantileEstimator
+        {
+            double level;                       // Probability of the quantile, between 0 and 1
+            double heights[5];                  // Marker heights; the middle one estimates the quantile
+            double positions[5];                // Actual marker positions
+            double desiredPositions[5];
+            int Nobservations;
+        };
+
+        void resetQuantileEstimator(QuantileEstimator &estimator, const double level);
+        void updateQuantileEstimator(QuantileEstimator &estimator, const double observation);
+        double quantileEstimate(const QuantileEstimator &estimator);
+
+
+    private:
+
+        Model &model;
+        ArrayXd quantileLevels;
+        int blockSize;                                  // Number of samples whose predictions are computed at once
+        int Nsamples;                                   // Number of resampled posterior samples of the last computation
+        ThreadPool threadPool;
+        vector<QuantileEstimator> estimators;           // Nquantiles estimators per covariate, covariate after covariate
+};
+
+
+#endif
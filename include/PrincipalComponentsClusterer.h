@@ -0,0 +1,53 @@
+// Derived class for clustering in a subspace spanned by the principal
+// components of the sample. The points are projected onto the principal
+// components that retain a given fraction of the total variance, and the
+// projected points are clustered by another clustering algorithm.
+// The cluster indices refer to the points of the original sample, so that
+// e.g. ellipsoids can still be built in the full parameter space.
+// Header file "PrincipalComponentsClusterer.h"
+// Implementations contained in "PrincipalComponentsClusterer.cpp"
+
+
+#ifndef PRINCIPALCOMPONENTSCLUSTERER_H
+#define PRINCIPALCOMPONENTSCLUSTERER_H
+
+#include <cmath>
+#include <cassert>
+#include <iostream>
+#include <Eigen/Core>
+#include "Clusterer.h"
+#include "Functions.h"
+
+
+using namespace std;
+using namespace Eigen;
+
+
+class PrincipalComponentsClusterer : public Clusterer
+{
+    public:
+
+        PrincipalComponentsClusterer(Clusterer &clusterer, double retainedVarianceFraction = 0.95, int minNdimensions = 1);
+        ~PrincipalComponentsClusterer();
+
+        virtual int cluster(RefArrayXXd sample, vector<int> &optimalClusterIndices, vector<int> &optimalClusterSizes) override;
+
+        int getNprojectedDimensions();
+        double getRetainedVarianceFraction();
+
+
+    protected:
+
+        Clusterer &clusterer;                   // Clusterer used on the projected sample
+
+
+    private:
+
+        double retainedVarianceFraction;        // Minimum fraction of the total variance kept by the projection
+        int minNdimensions;                     // Minimum number of principal components kept
+        int NprojectedDimensions;               // Number of principal components used in the last call of cluster()
+
+};
+
+
+#endif
@@ -16,6 +16,7 @@
 #include "Likelihood.h"
 #include "Functions.h"
 #include "File.h"
+#include "RandomStreams.h"
 
 using namespace std;
 typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
@@ -42,7 +43,7 @@ class Prior
     protected:
         
         int Ndimensions;
-        mt19937 engine;
+        Philox4x32Engine engine;
 
     
     private:
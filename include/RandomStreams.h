@@ -0,0 +1,38 @@
+// Functions for handing out independent streams of random numbers to the
+// components of a run (priors, samplers, clusterers, ellipsoids, ...), all
+// derived from a single run seed. Each stream is a Philox4x32Engine whose
+// stream index is a hash of the name of the component and of up to two indices
+// (e.g. an instance, iteration or thread number), so that a run is reproducible
+// from its seed, whatever the order in which the streams are used.
+// Header file "RandomStreams.h"
+// Implementation contained in "RandomStreams.cpp"
+
+
+#ifndef RANDOMSTREAMS_H
+#define RANDOMSTREAMS_H
+
+#include <cstdint>
+#include <string>
+#include <mutex>
+#include <chrono>
+#include <unordered_map>
+#include "Functions.h"
+#include "Philox4x32Engine.h"
+
+
+using namespace std;
+
+
+namespace RandomStreams
+{
+
+    void setRunSeed(const uint64_t newRunSeed);
+    uint64_t getRunSeed();
+
+    Philox4x32Engine getStream(const string &componentName, const uint64_t index1 = 0, const uint64_t index2 = 0);
+    Philox4x32Engine getNextStream(const string &componentName);
+
+}
+
+
+#endif
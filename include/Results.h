@@ -20,6 +20,8 @@
 #include "Functions.h"
 #include "File.h"
 #include "NestedSampler.h"
+#include "ArchiveWriter.h"
+#include "ArchiveReader.h"
 
 
 using namespace std;
@@ -43,6 +45,9 @@ class Results
         void writeEvidenceInformationToFile(string fileName);
         void writePosteriorProbabilityToFile(string fileName);
         void writeParametersSummaryToFile(string fileName, const double credibleLevel = 68.27, const bool writeMarginalDistribution = true);
+        void writeArchive(string fileName, const bool singlePrecision = false, const double credibleLevel = 68.27, 
+                          const bool writeMarginalDistribution = true);
+        void readArchive(string fullPath);
         void writeObjectsIdentificationToFile(){};          // TO DO
 
 
@@ -64,7 +69,8 @@ class Results
         ArrayXd posteriorProbability();
         void writeMarginalDistributionToFile(const int parameterNumber);
         ArrayXd computeCredibleLimits(const double credibleLevel, const double skewness, const int NinterpolationsPerBin = 10);
-        ArrayXXd parameterEstimation(const double credibleLevel, const bool writeMarginalDistribution);
+        ArrayXXd parameterEstimation(const double credibleLevel, const bool writeMarginalDistribution, 
+                                     ArchiveWriter *marginalDistributionArchive = NULL);
 
 };
 #endif
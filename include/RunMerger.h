@@ -0,0 +1,104 @@
+// Class for merging the posterior samples of several independent nested sampling
+// runs into a single one. The dead points of each run are already sorted by
+// increasing likelihood, and only its final live points need to be sorted, so
+// the runs are streamed through a heap-based k-way merge, in O(N log k) for N
+// points in k runs. The log(Weight) values, the
+// evidence and the information gain are computed in the same single pass, while
+// the merged sample is written out in blocks, so that only a few blocks of each
+// run are held in memory. The runs can be read from the ASCII files or from the
+// binary archive written by Results.
+// Header file "RunMerger.h"
+// Implementation contained in "RunMerger.cpp"
+
+
+#ifndef RUNMERGER_H
+#define RUNMERGER_H
+
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <cctype>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <queue>
+#include <memory>
+#include <limits>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <Eigen/Core>
+#include "Functions.h"
+#include "File.h"
+#include "ArchiveWriter.h"
+#include "ArchiveReader.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+
+
+class RunMerger
+{
+    public:
+
+        RunMerger(const int Ndimensions);
+        ~RunMerger();
+
+        void addRunFromFiles(string inputPathPrefix, const int Nlive);
+        void addRunFromArchive(string fullPath, const int Nlive);
+
+        void mergeToFiles(string outputPathPrefix);
+        void mergeToArchive(string fullPath, const bool singlePrecision = false);
+
+        int getTotalNlive();
+        int64_t getNsamples();
+        double getLogEvidence();
+        double getLogEvidenceError();
+        double getInformationGain();
+
+
+    protected:
+
+    private:
+
+        struct Run
+        {
+            string name;                                // Path of the run, for the error messages
+            unique_ptr<ArchiveReader> archive;          // NULL if the run is read from ASCII files
+            uint64_t NarchiveRows;
+            uint64_t nextArchiveRow;
+            vector<unique_ptr<ifstream>> inputFiles;    // The log(Likelihood) file, then one file per free parameter
+            vector<string> inputFileNames;
+            ArrayXd logLikelihood;                      // The log(Likelihood) values of the buffered points
+            ArrayXXd parameters;                        // The buffered points, one column per point
+            int Nlive;                                  // Number of points held back at the end of the buffer
+            int Nstored;                                // Number of points in the buffer
+            int Nbuffered;                              // Number of points in the buffer released to the merging
+            int nextBuffered;
+            bool isExhausted;                           // True once all points of the run have been read
+        };
+
+        static const int NpointsPerRead;               // Number of points of a run read at a time
+        static const int NsamplesPerBlock;             // Number of merged samples written at a time
+
+        int Ndimensions;
+        int totalNlive;
+        int64_t Nsamples;
+        double logEvidence;
+        double logEvidenceError;
+        double informationGain;
+        vector<Run> runs;
+
+        bool fillBuffer(Run &run);
+        int readValues(ifstream &inputFile, string inputFileName, double *values, const int Nvalues);
+        void merge(ArchiveWriter *archive, const bool singlePrecision, vector<unique_ptr<ofstream>> &outputFiles);
+        void writeBlock(RefArrayXXd parameters, RefArrayXd logLikelihood, RefArrayXd logWeight, ArchiveWriter *archive,
+                        const bool singlePrecision, vector<unique_ptr<ofstream>> &outputFiles);
+};
+
+
+#endif
@@ -0,0 +1,246 @@
+// Class template for likelihoods that bind a concrete model type and a noise
+// policy at compile time. The prediction of the model and the term of the
+// log-likelihood are computed in a single fused loop over the observations,
+// without virtual calls and without storing the predictions. The loop is split
+// in segments over the threads of Likelihood::setNthreads(). The class derives
+// from Likelihood, so that it can be passed to the samplers as any other likelihood.
+// Header file "StaticLikelihood.h"
+// Implementation contained in this header file (class template)
+
+
+#ifndef STATICLIKELIHOOD_H
+#define STATICLIKELIHOOD_H
+
+#include <cmath>
+#include <cassert>
+#include <utility>
+#include <Eigen/Core>
+#include "Likelihood.h"
+#include "Functions.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+
+
+// Noise policies. Each policy holds the data-only constants of the likelihood and
+// provides the term of the log-likelihood for a single observation, as well as a
+// hash of the data it holds (see Likelihood::fingerprint()). The observations
+// themselves are only kept by Likelihood, and passed to logTerm().
+
+// Normal noise, with the same normalization as NormalLikelihood
+
+class NormalNoisePolicy
+{
+    public:
+
+        NormalNoisePolicy(const RefArrayXd observations, const ArrayXd &uncertainties)
+        : inverseSquaredUncertainties(uncertainties.square().inverse())
+        {
+            assert(observations.size() == uncertainties.size());
+
+            double n = observations.size();
+            normalizationConstant = -0.5 * n * n * log(2.0*Functions::PI) - uncertainties.log().sum();
+        }
+
+        double getNormalizationConstant() const
+        {
+            return normalizationConstant;
+        }
+
+        double logTerm(const int n, const double observation, const double prediction) const
+        {
+            const double residual = observation - prediction;
+            return -0.5 * residual * residual * inverseSquaredUncertainties(n);
+        }
+
+        unsigned long long fingerprint(const unsigned long long initialHash) const
+        {
+            return Functions::fnv1aHash(inverseSquaredUncertainties.data(), 
+                                        inverseSquaredUncertainties.size() * sizeof(double), initialHash);
+        }
+
+
+    private:
+
+        ArrayXd inverseSquaredUncertainties;
+        double normalizationConstant;
+};
+
+
+
+
+// Exponential noise (chi-square with 2 d.o.f.), as in ExponentialLikelihood
+
+class ExponentialNoisePolicy
+{
+    public:
+
+        ExponentialNoisePolicy(const RefArrayXd observations)
+        {
+
+        }
+
+        double getNormalizationConstant() const
+        {
+            return 0.0;
+        }
+
+        double logTerm(const int n, const double observation, const double prediction) const
+        {
+            return -1.0 * (log(prediction) + observation / prediction);
+        }
+
+        unsigned long long fingerprint(const unsigned long long initialHash) const
+        {
+            return initialHash;
+        }
+};
+
+
+
+
+
+template <typename ModelType, typename NoisePolicy>
+class StaticLikelihood : public Likelihood
+{
+    public:
+
+        template <typename... NoiseArguments>
+        StaticLikelihood(const RefArrayXd observations, ModelType &model, NoiseArguments&&... noiseArguments);
+
+        using Likelihood::logValue;
+        virtual double logValue(RefArrayXd const modelParameters) override;
+        virtual unsigned long long fingerprint() override;
+
+
+    protected:
+
+    private:
+
+        ModelType &staticModel;                 // The same object as Likelihood::model, with its static type
+        NoisePolicy noise;
+
+}; // END class StaticLikelihood
+
+
+
+
+
+
+
+
+
+
+
+// StaticLikelihood::StaticLikelihood()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      observations: array containing the dependent variable values
+//      model: object specifying the model to be used. Its class should derive from 
+//             StaticModel, and provide evaluate(covariate, modelParameters).
+//      noiseArguments: the remaining arguments of the constructor of the noise policy,
+//                      e.g. the uncertainties for NormalNoisePolicy. They are forwarded,
+//                      so that temporaries can be passed as well.
+//
+// REMARKS:
+//      Example:
+//          StaticLikelihood<MyModel, NormalNoisePolicy> likelihood(observations, model, uncertainties);
+//      Only the base class keeps a copy of the observations. The covariates are read 
+//      from the model (see StaticModel::evaluateAt()).
+//
+
+template <typename ModelType, typename NoisePolicy>
+template <typename... NoiseArguments>
+StaticLikelihood<ModelType, NoisePolicy>::StaticLikelihood(const RefArrayXd observations, ModelType &model,
+                                                           NoiseArguments&&... noiseArguments)
+: Likelihood(observations, model),
+  staticModel(model),
+  noise(observations, std::forward<NoiseArguments>(noiseArguments)...)
+{
+    assert(model.getCovariates().size() == observations.size());
+}
+
+
+
+
+
+
+
+
+
+
+
+// StaticLikelihood::logValue()
+//
+// PURPOSE:
+//      Compute the natural logarithm of the likelihood for a given set of
+//      model parameters.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//                       values of the free parameters that describe the model.
+//
+// OUTPUT:
+//      a double number containing the natural logarithm of the likelihood
+//
+// REMARKS:
+//      The calls to evaluate() and logTerm() are resolved at compile time,
+//      so that they can be inlined into a single pass over each segment of the 
+//      observations. The segments are summed over the threads set by setNthreads(),
+//      and the result does not depend on the number of threads.
+//      The single precision mode of Likelihood is not used by this class.
+//
+
+template <typename ModelType, typename NoisePolicy>
+double StaticLikelihood<ModelType, NoisePolicy>::logValue(RefArrayXd const modelParameters)
+{
+    auto segmentSum = [&](const int beginIndex, const int length)
+    {
+        double partialSum = 0.0;
+
+        for (int n = beginIndex; n < beginIndex + length; ++n)
+        {
+            partialSum += noise.logTerm(n, observations(n), staticModel.evaluateAt(n, modelParameters));
+        }
+
+        return partialSum;
+    };
+
+    return noise.getNormalizationConstant() + sumOverSegments(segmentSum);
+}
+
+
+
+
+
+
+
+
+
+
+
+// StaticLikelihood::fingerprint()
+//
+// PURPOSE:
+//      Compute a hash of everything the log-likelihood values depend on,
+//      apart from the free parameters (see Likelihood::fingerprint()).
+//
+// OUTPUT:
+//      The hash of the base class, combined with the data of the noise policy.
+//
+
+template <typename ModelType, typename NoisePolicy>
+unsigned long long StaticLikelihood<ModelType, NoisePolicy>::fingerprint()
+{
+    return noise.fingerprint(Likelihood::fingerprint());
+}
+
+
+#endif
@@ -0,0 +1,204 @@
+// Class template for models whose prediction for a single covariate is
+// known at compile time (curiously recurring template pattern).
+// The derived class only implements evaluate(), which can then be inlined
+// by StaticLikelihood into the reduction of the log-likelihood, while
+// predict() keeps the model usable through the virtual Model interface.
+// Header file "StaticModel.h"
+// Implementation contained in this header file (class template)
+
+
+#ifndef STATICMODEL_H
+#define STATICMODEL_H
+
+#include <Eigen/Core>
+#include "Model.h"
+
+
+using namespace std;
+using Eigen::ArrayXd;
+typedef Eigen::Ref<Eigen::ArrayXd> RefArrayXd;
+
+
+template <typename Derived>
+class StaticModel : public Model
+{
+    public:
+
+        StaticModel(const RefArrayXd covariates);
+
+        virtual void predict(RefArrayXd predictions, const RefArrayXd modelParameters) override;
+        virtual void predictSegment(RefArrayXd predictions, const RefArrayXd modelParameters, const int beginIndex) override;
+        virtual bool canPredictSegments() override;
+
+        inline double evaluateAt(const int index, const RefArrayXd modelParameters) const;
+
+
+    protected:
+
+    private:
+
+}; // END class StaticModel
+
+
+
+
+
+
+
+
+
+
+
+// StaticModel::StaticModel()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      covariates: one-dimensional array containing the values of the
+//                  independent variable.
+//
+// REMARKS:
+//      The derived class should set Nparameters, and implement
+//      
+//          double evaluate(const double covariate, const RefArrayXd modelParameters) const;
+//
+//      returning the prediction of the model for a single covariate.
+//
+
+template <typename Derived>
+StaticModel<Derived>::StaticModel(const RefArrayXd covariates)
+: Model(covariates)
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+
+// StaticModel::predict()
+//
+// PURPOSE:
+//      Add the predictions of the model to the predictions array, for all covariates,
+//      so that the model can be used as any other Model.
+//
+// INPUT:
+//      predictions: one-dimensional array to contain the predictions
+//      modelParameters: one-dimensional array containing the values of the free parameters
+//
+// OUTPUT:
+//      void
+//
+
+template <typename Derived>
+void StaticModel<Derived>::predict(RefArrayXd predictions, const RefArrayXd modelParameters)
+{
+    const Derived &model = static_cast<const Derived&>(*this);
+
+    for (int n = 0; n < covariates.size(); ++n)
+    {
+        predictions(n) += model.evaluate(covariates(n), modelParameters);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+
+
+// StaticModel::predictSegment()
+//
+// PURPOSE:
+//      Add the predictions of the model to the predictions array, for the covariates
+//      covariates(beginIndex), ..., covariates(beginIndex + predictions.size() - 1).
+//
+// INPUT:
+//      predictions: one-dimensional array to contain the predictions of the segment
+//      modelParameters: one-dimensional array containing the values of the free parameters
+//      beginIndex: index of the covariate corresponding to predictions(0)
+//
+// OUTPUT:
+//      void
+//
+
+template <typename Derived>
+void StaticModel<Derived>::predictSegment(RefArrayXd predictions, const RefArrayXd modelParameters, const int beginIndex)
+{
+    const Derived &model = static_cast<const Derived&>(*this);
+
+    for (int n = 0; n < predictions.size(); ++n)
+    {
+        predictions(n) += model.evaluate(covariates(beginIndex + n), modelParameters);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+
+// StaticModel::canPredictSegments()
+//
+// PURPOSE:
+//      Tell whether predictSegment() is implemented for any segment of the covariates.
+//
+// OUTPUT:
+//      True, because evaluate() only depends on a single covariate.
+//
+
+template <typename Derived>
+bool StaticModel<Derived>::canPredictSegments()
+{
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+
+// StaticModel::evaluateAt()
+//
+// PURPOSE:
+//      Compute the prediction of the model for a single covariate, given by its index,
+//      so that StaticLikelihood does not need a copy of the covariates.
+//
+// INPUT:
+//      index: the index of the covariate
+//      modelParameters: one-dimensional array containing the values of the free parameters
+//
+// OUTPUT:
+//      The prediction of the model for covariates(index).
+//
+
+template <typename Derived>
+inline double StaticModel<Derived>::evaluateAt(const int index, const RefArrayXd modelParameters) const
+{
+    return static_cast<const Derived&>(*this).evaluate(covariates(index), modelParameters);
+}
+
+
+#endif
@@ -0,0 +1,57 @@
+// Class for a fixed pool of worker threads, used to run the iterations
+// of a loop in parallel. The thread calling parallelFor() also runs
+// iterations, and waits until all of them are done.
+// Header file "ThreadPool.h"
+// Implementation contained in "ThreadPool.cpp"
+
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+
+
+using namespace std;
+
+
+class ThreadPool
+{
+    public:
+
+        ThreadPool(const int Nthreads);
+        ~ThreadPool();
+
+        void parallelFor(const int Ntasks, const function<void(const int taskIndex)> &task);
+
+        int getNthreads();
+
+
+    protected:
+
+    private:
+
+        int Nthreads;                               // Number of threads running tasks, including the calling thread
+        vector<thread> workers;
+        mutex callMutex;                            // Serializes concurrent calls to parallelFor()
+        mutex poolMutex;
+        condition_variable workIsAvailable;
+        condition_variable workIsFinished;
+        const function<void(const int)> *task;
+        int Ntasks;
+        atomic<int> nextTaskIndex;
+        int NbusyWorkers;
+        unsigned long generation;                   // Incremented for each call of parallelFor()
+        bool isStopping;
+
+        void work();
+        void runTasks();
+};
+
+
+#endif
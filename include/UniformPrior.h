@@ -40,7 +40,6 @@ class UniformPrior : public Prior
 
     private:
 
-        uniform_real_distribution<> uniform;
         ArrayXd minima;
         ArrayXd maxima;
 
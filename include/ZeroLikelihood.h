@@ -29,6 +29,7 @@ class ZeroLikelihood : public Likelihood
         ZeroLikelihood(const RefArrayXd observations, Model &model);
         ~ZeroLikelihood();
 
+        using Likelihood::logValue;
         virtual double logValue(RefArrayXd const modelParameters) override;
 
 
@@ -25,6 +25,7 @@ class ZeroSampler : public NestedSampler
         virtual bool drawWithConstraint(const RefArrayXXd totalSample, const unsigned int Nclusters, const vector<int> &clusterIndices,
                                         const vector<int> &clusterSizes, RefArrayXd drawnPoint, 
                                         double &logLikelihoodOfDrawnPoint, const int maxNdrawAttempts) override; 
+        virtual bool verifySamplerStatus() override;
         
     protected:
       
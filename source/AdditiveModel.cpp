@@ -0,0 +1,314 @@
+#include "AdditiveModel.h"
+
+
+// AdditiveModel::AdditiveModel()
+//
+// PURPOSE: 
+//      Constructor.
+//
+// INPUT:
+//      covariates: one-dimensional array containing the values
+//                  of the independent variable.
+//      NupdatesBetweenRefreshes: each update of a component adds the difference between its
+//                                new and old contribution to the total, which accumulates 
+//                                rounding errors. The total is therefore summed from scratch
+//                                after this number of component updates.
+//
+// REMARKS:
+//      Derived classes should set Nparameters and call addComponent() for each component 
+//      in their constructor, and implement predictComponent(), which receives an array of
+//      zeros to which it can either add or assign the contribution of the component.
+//      The cache of each thread calling predict() needs memory for 3 x Ncovariates values,
+//      independently of the number of components.
+//
+
+AdditiveModel::AdditiveModel(const RefArrayXd covariates, const int NupdatesBetweenRefreshes)
+: Model(covariates),
+  NupdatesBetweenRefreshes(NupdatesBetweenRefreshes),
+  NcomponentEvaluations(0)
+{
+    assert(NupdatesBetweenRefreshes > 0);
+}
+
+
+
+
+
+
+
+
+// AdditiveModel::~AdditiveModel()
+//
+// PURPOSE: 
+//      Destructor.
+//
+
+AdditiveModel::~AdditiveModel()
+{
+
+}
+
+
+
+
+
+
+
+
+// AdditiveModel::predict()
+//
+// PURPOSE: 
+//      Add the sum of the contributions of all components to the predictions. Only the 
+//      components of which at least one free parameter changed since the previous call
+//      from the same thread are recomputed.
+//
+// INPUT:
+//      predictions: one-dimensional array to contain the predictions
+//      modelParameters: one-dimensional array containing the values of the free parameters
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Each calling thread has its own cache, so that different threads can predict
+//      at the same time, e.g. when the likelihoods of several points are computed
+//      in parallel.
+//
+
+void AdditiveModel::predict(RefArrayXd predictions, const RefArrayXd modelParameters)
+{
+    Cache &cache = getCache();
+    const int Ncomponents = firstParameterIndices.size();
+
+
+    // Find the components whose free parameters changed. Updating a component costs two evaluations,
+    // so all components are computed from scratch if at least half of them changed. This is also
+    // done once in a while, to remove the rounding errors accumulated by the updates.
+
+    bool allComponentsShouldBeComputed = !cache.isValid || (cache.cachedParameters.size() != modelParameters.size())
+                                         || (cache.NupdatesSinceRefresh >= NupdatesBetweenRefreshes);
+    vector<int> changedComponents;
+
+    for (int component = 0; (component < Ncomponents) && !allComponentsShouldBeComputed; ++component)
+    {
+        const int firstIndex = firstParameterIndices[component];
+        const int Nparameters = NparametersOfComponents[component];
+
+        if ((modelParameters.segment(firstIndex, Nparameters) != cache.cachedParameters.segment(firstIndex, Nparameters)).any())
+        {
+            changedComponents.push_back(component);
+            allComponentsShouldBeComputed = (2 * int(changedComponents.size()) >= Ncomponents);
+        }
+    }
+
+    if (allComponentsShouldBeComputed)
+    {
+        cache.totalContribution = ArrayXd::Zero(covariates.size());
+        cache.componentContribution.resize(covariates.size());
+
+        for (int component = 0; component < Ncomponents; ++component)
+        {
+            ArrayXd componentParameters = modelParameters.segment(firstParameterIndices[component], NparametersOfComponents[component]);
+            cache.componentContribution.setZero();
+            predictComponent(cache.componentContribution, component, componentParameters);
+            cache.totalContribution += cache.componentContribution;
+        }
+
+        NcomponentEvaluations += Ncomponents;
+        cache.isValid = true;
+        cache.NupdatesSinceRefresh = 0;
+    }
+    else
+    {
+        for (size_t n = 0; n < changedComponents.size(); ++n)
+        {
+            updateComponent(cache, changedComponents[n], modelParameters);
+        }
+    }
+
+    cache.cachedParameters = modelParameters;
+    predictions += cache.totalContribution;
+}
+
+
+
+
+
+
+
+
+// AdditiveModel::clearCache()
+//
+// PURPOSE: 
+//      Invalidate the cached contributions, so that all components are recomputed
+//      at the next call of predict(), and release their memory.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Should not be called while other threads are calling predict().
+//
+
+void AdditiveModel::clearCache()
+{
+    lock_guard<mutex> lock(cachesMutex);
+
+    caches.clear();
+}
+
+
+
+
+
+
+
+
+// AdditiveModel::getNcomponents()
+//
+// PURPOSE: 
+//      Get the number of components of the model.
+//
+// OUTPUT:
+//      The number of components added with addComponent().
+//
+
+int AdditiveModel::getNcomponents()
+{
+    return firstParameterIndices.size();
+}
+
+
+
+
+
+
+
+
+// AdditiveModel::getNcomponentEvaluations()
+//
+// PURPOSE: 
+//      Get private data member NcomponentEvaluations.
+//
+// OUTPUT:
+//      The total number of calls of predictComponent().
+//
+
+unsigned long AdditiveModel::getNcomponentEvaluations()
+{
+    return NcomponentEvaluations;
+}
+
+
+
+
+
+
+
+
+// AdditiveModel::addComponent()
+//
+// PURPOSE: 
+//      Declare a component of the model, and the block of consecutive free parameters
+//      on which it depends. 
+//
+// INPUT:
+//      firstParameterIndex: the index of the first free parameter of the component
+//      NparametersOfComponent: the number of free parameters of the component
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The blocks of different components may overlap, e.g. for a parameter shared by
+//      several components. A change of such a parameter updates all these components.
+//
+
+void AdditiveModel::addComponent(const int firstParameterIndex, const int NparametersOfComponent)
+{
+    assert(firstParameterIndex >= 0);
+    assert(NparametersOfComponent >= 0);
+
+    firstParameterIndices.push_back(firstParameterIndex);
+    NparametersOfComponents.push_back(NparametersOfComponent);
+    clearCache();
+}
+
+
+
+
+
+
+
+
+// AdditiveModel::getCache()
+//
+// PURPOSE: 
+//      Get the cache of the calling thread, which is created empty the first time.
+//
+// OUTPUT:
+//      A reference to the cache of the calling thread.
+//
+// REMARKS:
+//      The caches are owned by the model, and released with it or by clearCache().
+//      Only the look-up is done under the mutex: the references to the elements of
+//      an unordered_map stay valid when other elements are inserted.
+//
+
+AdditiveModel::Cache &AdditiveModel::getCache()
+{
+    lock_guard<mutex> lock(cachesMutex);
+
+    auto inserted = caches.emplace(this_thread::get_id(), Cache());
+    Cache &cache = inserted.first->second;
+
+    if (inserted.second)
+    {
+        cache.isValid = false;
+        cache.NupdatesSinceRefresh = 0;
+    }
+
+    return cache;
+}
+
+
+
+
+
+
+
+
+// AdditiveModel::updateComponent()
+//
+// PURPOSE: 
+//      Recompute the contribution of a single component, and update the total contribution
+//      by subtracting its contribution for the cached parameters and adding its contribution
+//      for the new parameters.
+//
+// INPUT:
+//      cache: the cache of the calling thread
+//      component: the index of the component
+//      modelParameters: one-dimensional array containing the values of all free parameters
+//
+// OUTPUT:
+//      void
+//
+
+void AdditiveModel::updateComponent(Cache &cache, const int component, const RefArrayXd modelParameters)
+{
+    const int firstIndex = firstParameterIndices[component];
+    const int Nparameters = NparametersOfComponents[component];
+    ArrayXd oldComponentParameters = cache.cachedParameters.segment(firstIndex, Nparameters);
+    ArrayXd newComponentParameters = modelParameters.segment(firstIndex, Nparameters);
+
+    cache.componentContribution.setZero();
+    predictComponent(cache.componentContribution, component, oldComponentParameters);
+    cache.totalContribution -= cache.componentContribution;
+
+    cache.componentContribution.setZero();
+    predictComponent(cache.componentContribution, component, newComponentParameters);
+    cache.totalContribution += cache.componentContribution;
+
+    NcomponentEvaluations += 2;
+    cache.NupdatesSinceRefresh++;
+}
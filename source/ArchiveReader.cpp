@@ -0,0 +1,431 @@
+#include "ArchiveReader.h"
+
+
+// ArchiveReader::ArchiveReader()
+//
+// PURPOSE:
+//      Constructor. Maps the archive into memory, checks its header, and
+//      locates all its blocks.
+//
+// INPUT:
+//      fullPath: full path of the archive
+//
+
+ArchiveReader::ArchiveReader(string fullPath)
+: fullPath(fullPath),
+  mapping(NULL),
+  archiveSize(0)
+{
+    if (!ArchiveWriter::hostIsLittleEndian())
+    {
+        cerr << "Error: binary archives can only be read on little-endian machines." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Map the archive into memory
+
+    int fileDescriptor = open(fullPath.c_str(), O_RDONLY);
+
+    if (fileDescriptor < 0)
+    {
+        cerr << "Error opening input file " << fullPath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    struct stat fileStatus;
+
+    if (fstat(fileDescriptor, &fileStatus) != 0)
+    {
+        close(fileDescriptor);
+        cerr << "Error reading the size of input file " << fullPath << ": " << strerror(errno) << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    archiveSize = fileStatus.st_size;
+
+    if (archiveSize < 16)
+    {
+        close(fileDescriptor);
+        cerr << "Error: " << fullPath << " is not a binary archive." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    mapping = mmap(NULL, archiveSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    close(fileDescriptor);
+
+    if (mapping == MAP_FAILED)
+    {
+        cerr << "Error mapping input file " << fullPath << ": " << strerror(errno) << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    const char *archiveBegin = static_cast<const char*>(mapping);
+    uint32_t version;
+    uint32_t headerSize;
+    memcpy(&version, archiveBegin + 8, 4);
+    memcpy(&headerSize, archiveBegin + 12, 4);
+
+    if ((memcmp(archiveBegin, ArchiveWriter::archiveSignature, 8) != 0) || (version > ArchiveWriter::formatVersion))
+    {
+        cerr << "Error: " << fullPath << " is not a binary archive of a supported version." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Locate the blocks, up to the last complete one
+
+    uint64_t position = headerSize;
+
+    while (position < archiveSize)
+    {
+        Block block;
+        uint32_t nameLength;
+        bool blockIsComplete = (position + 4 <= archiveSize);
+
+        if (blockIsComplete)
+        {
+            memcpy(&nameLength, archiveBegin + position, 4);
+            blockIsComplete = (position + 4 + nameLength + 20 <= archiveSize);
+        }
+
+        if (blockIsComplete)
+        {
+            block.name.assign(archiveBegin + position + 4, nameLength);
+            position += 4 + nameLength;
+            memcpy(&block.type, archiveBegin + position, 4);
+            memcpy(&block.Nrows, archiveBegin + position + 4, 8);
+            memcpy(&block.Ncols, archiveBegin + position + 12, 8);
+            position += 20;
+            position += (8 - position % 8) % 8;
+
+            const uint64_t valueSize = (block.type == ArchiveWriter::float64 ? 8 : (block.type == ArchiveWriter::float32 ? 4 : 1));
+            const uint64_t Nbytes = block.Nrows * block.Ncols * valueSize;
+
+            block.values = archiveBegin + position;
+            position += Nbytes + (8 - Nbytes % 8) % 8;
+            blockIsComplete = (block.type <= ArchiveWriter::float32) && (position <= archiveSize);
+        }
+
+        if (!blockIsComplete)
+        {
+            cerr << "Warning: the last block of " << fullPath << " is incomplete, and is skipped." << endl;
+            break;
+        }
+
+        blocks.push_back(block);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveReader::~ArchiveReader()
+//
+// PURPOSE:
+//      Destructor. Unmaps the archive.
+//
+
+ArchiveReader::~ArchiveReader()
+{
+    if (mapping != NULL)
+    {
+        munmap(mapping, archiveSize);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveReader::getBlockNames()
+//
+// PURPOSE:
+//      Get the names of the blocks in the archive.
+//
+// OUTPUT:
+//      The names of the blocks, in order of first appearance, each name only once.
+//
+
+vector<string> ArchiveReader::getBlockNames()
+{
+    vector<string> names;
+
+    for (size_t n = 0; n < blocks.size(); ++n)
+    {
+        if (find(names.begin(), names.end(), blocks[n].name) == names.end())
+        {
+            names.push_back(blocks[n].name);
+        }
+    }
+
+    return names;
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveReader::containsBlock()
+//
+// PURPOSE:
+//      Check whether the archive contains a block with a given name.
+//
+// INPUT:
+//      name: the name of the block
+//
+// OUTPUT:
+//      True if there is at least one such block.
+//
+
+bool ArchiveReader::containsBlock(string name)
+{
+    for (size_t n = 0; n < blocks.size(); ++n)
+    {
+        if (blocks[n].name == name) return true;
+    }
+
+    return false;
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveReader::getNrows()
+//
+// PURPOSE:
+//      Get the number of rows of the array stored in all blocks with a given name.
+//
+// INPUT:
+//      name: the name of the blocks
+//
+// OUTPUT:
+//      The total number of rows of the blocks, which must all have the same number of columns.
+//
+
+uint64_t ArchiveReader::getNrows(string name)
+{
+    uint64_t Nrows = 0;
+    int64_t Ncols = -1;
+
+    for (size_t n = 0; n < blocks.size(); ++n)
+    {
+        if ((blocks[n].name != name) || (blocks[n].type == ArchiveWriter::text)) continue;
+
+        if ((Ncols != -1) && (blocks[n].Ncols != uint64_t(Ncols)))
+        {
+            cerr << "Error: blocks " << name << " of " << fullPath << " have different numbers of columns." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        Ncols = blocks[n].Ncols;
+        Nrows += blocks[n].Nrows;
+    }
+
+    if (Ncols == -1)
+    {
+        cerr << "Error: no array " << name << " in " << fullPath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return Nrows;
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveReader::readArrayXXd()
+//
+// PURPOSE:
+//      Read the array stored in all blocks with a given name, concatenated row-wise.
+//
+// INPUT:
+//      name: the name of the blocks
+//
+// OUTPUT:
+//      An Eigen::ArrayXXd. float32 values are converted to double precision.
+//
+
+ArrayXXd ArchiveReader::readArrayXXd(string name)
+{
+    return readArrayXXd(name, 0, getNrows(name));
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveReader::readArrayXXd()
+//
+// PURPOSE:
+//      Read a range of rows of the array stored in all blocks with a given name,
+//      concatenated row-wise.
+//
+// INPUT:
+//      name: the name of the blocks
+//      firstRow: the first row to be read, counted from the first row of the first block
+//      Nrows: the number of rows to be read
+//
+// OUTPUT:
+//      An Eigen::ArrayXXd. float32 values are converted to double precision.
+//
+// REMARKS:
+//      Only the requested rows are copied from the mapped archive, so that a large
+//      array can be read piece by piece with a bounded amount of memory.
+//
+
+ArrayXXd ArchiveReader::readArrayXXd(string name, const uint64_t firstRow, const uint64_t Nrows)
+{
+    if (firstRow + Nrows > getNrows(name))
+    {
+        cerr << "Error: rows " << firstRow << " to " << firstRow + Nrows << " are beyond the end of array " 
+             << name << " in " << fullPath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Copy the overlapping part of each block, column after column
+
+    ArrayXXd array;
+    uint64_t firstRowOfBlock = 0;
+
+    for (size_t n = 0; n < blocks.size(); ++n)
+    {
+        const Block &block = blocks[n];
+
+        if ((block.name != name) || (block.type == ArchiveWriter::text)) continue;
+
+        if (array.cols() == 0)
+        {
+            array.resize(Nrows, block.Ncols);
+        }
+
+        const uint64_t beginRow = max(firstRow, firstRowOfBlock);
+        const uint64_t endRow = min(firstRow + Nrows, firstRowOfBlock + block.Nrows);
+
+        for (uint64_t j = 0; (beginRow < endRow) && (j < block.Ncols); ++j)
+        {
+            const uint64_t NrowsCopied = endRow - beginRow;
+
+            if (block.type == ArchiveWriter::float64)
+            {
+                memcpy(&array(beginRow - firstRow, j), block.values + (j * block.Nrows + beginRow - firstRowOfBlock) * sizeof(double), 
+                       NrowsCopied * sizeof(double));
+            }
+            else
+            {
+                Eigen::ArrayXf column(NrowsCopied);
+                memcpy(column.data(), block.values + (j * block.Nrows + beginRow - firstRowOfBlock) * sizeof(float), 
+                       NrowsCopied * sizeof(float));
+                array.col(j).segment(beginRow - firstRow, NrowsCopied) = column.cast<double>();
+            }
+        }
+
+        firstRowOfBlock += block.Nrows;
+    }
+
+    return array;
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveReader::readArrayXd()
+//
+// PURPOSE:
+//      Read the one-dimensional array stored in all blocks with a given name.
+//
+// INPUT:
+//      name: the name of the blocks, which must have a single column
+//
+// OUTPUT:
+//      An Eigen::ArrayXd.
+//
+
+ArrayXd ArchiveReader::readArrayXd(string name)
+{
+    ArrayXXd array = readArrayXXd(name);
+
+    if (array.cols() != 1)
+    {
+        cerr << "Error: array " << name << " of " << fullPath << " has more than one column." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return array.col(0);
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveReader::readText()
+//
+// PURPOSE:
+//      Read the text stored in all blocks with a given name.
+//
+// INPUT:
+//      name: the name of the blocks
+//
+// OUTPUT:
+//      The concatenated texts, empty if there are no such blocks.
+//
+
+string ArchiveReader::readText(string name)
+{
+    string text;
+
+    for (size_t n = 0; n < blocks.size(); ++n)
+    {
+        if ((blocks[n].name == name) && (blocks[n].type == ArchiveWriter::text))
+        {
+            text.append(blocks[n].values, blocks[n].Nrows);
+        }
+    }
+
+    return text;
+}
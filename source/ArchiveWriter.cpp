@@ -0,0 +1,433 @@
+#include "ArchiveWriter.h"
+
+
+const char ArchiveWriter::archiveSignature[8] = {'D', 'I', 'A', 'M', 'O', 'N', 'D', 'S'};
+
+
+// ArchiveWriter::ArchiveWriter()
+//
+// PURPOSE:
+//      Constructor. Opens the archive, and writes its header if it is new.
+//
+// INPUT:
+//      fullPath: full path of the archive
+//      appendToExistingArchive: if true and the archive exists, the new blocks are
+//                               appended to it. Otherwise the archive is overwritten.
+//
+// REMARKS:
+//      Before appending, the blocks of the existing archive are located as in ArchiveReader.
+//      An incomplete last block, left by an interrupted run, is truncated away, so that
+//      the appended blocks remain readable.
+//
+
+ArchiveWriter::ArchiveWriter(string fullPath, const bool appendToExistingArchive)
+: fullPath(fullPath),
+  position(0)
+{
+    if (!hostIsLittleEndian())
+    {
+        cerr << "Error: binary archives can only be written on little-endian machines." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Check the header of an existing archive, to which blocks are to be appended
+
+    if (appendToExistingArchive)
+    {
+        ifstream existingFile(fullPath.c_str(), ios::binary | ios::ate);
+
+        if (existingFile.good())
+        {
+            const uint64_t archiveSize = existingFile.tellg();
+            position = findEndOfCompleteBlocks(existingFile, archiveSize);
+            existingFile.close();
+
+            if (position < archiveSize)
+            {
+                cerr << "Warning: the last block of " << fullPath << " is incomplete, and is discarded." << endl;
+
+                if (truncate(fullPath.c_str(), position) != 0)
+                {
+                    cerr << "Error truncating output file " << fullPath << ": " << strerror(errno) << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+
+            outputFile.open(fullPath.c_str(), ios::binary | ios::app);
+
+            if (!outputFile.good())
+            {
+                cerr << "Error opening output file " << fullPath << endl;
+                exit(EXIT_FAILURE);
+            }
+
+            return;
+        }
+    }
+
+
+    // Start a new archive
+
+    outputFile.open(fullPath.c_str(), ios::binary | ios::trunc);
+
+    if (!outputFile.good())
+    {
+        cerr << "Error opening output file " << fullPath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    const uint32_t version = formatVersion;
+    const uint32_t headerSize = 16;
+    writeBytes(archiveSignature, 8);
+    writeBytes(&version, 4);
+    writeBytes(&headerSize, 4);
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveWriter::~ArchiveWriter()
+//
+// PURPOSE:
+//      Destructor. Closes the archive if this was not done yet.
+//
+
+ArchiveWriter::~ArchiveWriter()
+{
+    close();
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveWriter::appendArrayXXd()
+//
+// PURPOSE:
+//      Append a block with a two-dimensional array to the archive.
+//
+// INPUT:
+//      name: the name of the block. Blocks with the same name must have the same
+//            number of columns, and are concatenated row-wise when read.
+//      array: the values to be stored
+//      singlePrecision: if true the values are stored as float32, otherwise as float64
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The values are written as soon as the block is appended, so that an archive
+//      whose writing is interrupted contains all blocks appended so far.
+//
+
+void ArchiveWriter::appendArrayXXd(string name, RefArrayXXd const array, const bool singlePrecision)
+{
+    writeBlockHeader(name, (singlePrecision ? float32 : float64), array.rows(), array.cols());
+
+    for (int j = 0; j < array.cols(); ++j)
+    {
+        if (singlePrecision)
+        {
+            Eigen::ArrayXf column = array.col(j).cast<float>();
+            writeBytes(column.data(), column.size() * sizeof(float));
+        }
+        else
+        {
+            writeBytes(array.col(j).data(), array.rows() * sizeof(double));
+        }
+    }
+
+
+    // Pad the values up to a multiple of 8 bytes, in case of float32 values
+
+    const char padding[8] = {0};
+    writeBytes(padding, (8 - position % 8) % 8);
+    outputFile.flush();
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveWriter::appendArrayXd()
+//
+// PURPOSE:
+//      Append a block with a one-dimensional array to the archive, as a single column.
+//
+// INPUT:
+//      name: the name of the block
+//      array: the values to be stored
+//      singlePrecision: if true the values are stored as float32, otherwise as float64
+//
+// OUTPUT:
+//      void
+//
+
+void ArchiveWriter::appendArrayXd(string name, RefArrayXd const array, const bool singlePrecision)
+{
+    Eigen::Map<ArrayXXd> column(const_cast<double*>(array.data()), array.size(), 1);
+    appendArrayXXd(name, column, singlePrecision);
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveWriter::appendText()
+//
+// PURPOSE:
+//      Append a block with a text to the archive, e.g. to describe the other blocks.
+//
+// INPUT:
+//      name: the name of the block
+//      text: the text to be stored
+//
+// OUTPUT:
+//      void
+//
+
+void ArchiveWriter::appendText(string name, string text)
+{
+    writeBlockHeader(name, ArchiveWriter::text, text.size(), 1);
+    writeBytes(text.data(), text.size());
+
+    const char padding[8] = {0};
+    writeBytes(padding, (8 - position % 8) % 8);
+    outputFile.flush();
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveWriter::close()
+//
+// PURPOSE:
+//      Close the archive.
+//
+// OUTPUT:
+//      void
+//
+
+void ArchiveWriter::close()
+{
+    if (outputFile.is_open())
+    {
+        outputFile.close();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveWriter::hostIsLittleEndian()
+//
+// PURPOSE:
+//      Check the byte order of the machine.
+//
+// OUTPUT:
+//      True if the least significant byte of a number is stored first.
+//
+
+bool ArchiveWriter::hostIsLittleEndian()
+{
+    const uint32_t one = 1;
+    unsigned char firstByte;
+    memcpy(&firstByte, &one, 1);
+
+    return (firstByte == 1);
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveWriter::findEndOfCompleteBlocks()
+//
+// PURPOSE:
+//      Check the header of an existing archive, and walk its blocks in the same way 
+//      as ArchiveReader, up to the last complete one.
+//
+// INPUT:
+//      existingFile: the archive, opened for reading
+//      archiveSize: the size of the archive, in bytes
+//
+// OUTPUT:
+//      The position right after the last complete block, i.e. the size of the
+//      archive without its incomplete last block, if any.
+//
+
+uint64_t ArchiveWriter::findEndOfCompleteBlocks(ifstream &existingFile, const uint64_t archiveSize)
+{
+    char signature[8] = {0};
+    uint32_t version = 0;
+    uint32_t headerSize = 0;
+
+    existingFile.seekg(0);
+    existingFile.read(signature, 8);
+    existingFile.read(reinterpret_cast<char*>(&version), 4);
+    existingFile.read(reinterpret_cast<char*>(&headerSize), 4);
+
+    if (!existingFile.good() || (memcmp(signature, archiveSignature, 8) != 0) || (version > formatVersion) 
+        || (headerSize < 16) || (headerSize > archiveSize))
+    {
+        cerr << "Error: " << fullPath << " is not a binary archive of a supported version." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t endOfBlocks = headerSize;
+
+    while (endOfBlocks < archiveSize)
+    {
+        uint64_t blockPosition = endOfBlocks;
+        uint32_t nameLength = 0;
+        uint32_t typeCode = 0;
+        uint64_t Nrows = 0;
+        uint64_t Ncols = 0;
+
+        if (blockPosition + 4 > archiveSize) break;
+
+        existingFile.seekg(blockPosition);
+        existingFile.read(reinterpret_cast<char*>(&nameLength), 4);
+
+        if (blockPosition + 4 + nameLength + 20 > archiveSize) break;
+
+        blockPosition += 4 + nameLength;
+        existingFile.seekg(blockPosition);
+        existingFile.read(reinterpret_cast<char*>(&typeCode), 4);
+        existingFile.read(reinterpret_cast<char*>(&Nrows), 8);
+        existingFile.read(reinterpret_cast<char*>(&Ncols), 8);
+
+        if (!existingFile.good() || (typeCode > float32) || (Nrows > archiveSize) || (Ncols > archiveSize)) break;
+
+        blockPosition += 20;
+        blockPosition += (8 - blockPosition % 8) % 8;
+
+        if ((Ncols > 0) && (Nrows > archiveSize / Ncols)) break;
+
+        const uint64_t valueSize = (typeCode == float64 ? 8 : (typeCode == float32 ? 4 : 1));
+        const uint64_t Nbytes = Nrows * Ncols * valueSize;
+
+        blockPosition += Nbytes + (8 - Nbytes % 8) % 8;
+
+        if (blockPosition > archiveSize) break;
+
+        endOfBlocks = blockPosition;
+    }
+
+    return endOfBlocks;
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveWriter::writeBlockHeader()
+//
+// PURPOSE:
+//      Write the header of a block, padded so that the values start at a
+//      multiple of 8 bytes from the beginning of the archive.
+//
+// INPUT:
+//      name: the name of the block
+//      type: the type of the values
+//      Nrows: the number of rows
+//      Ncols: the number of columns
+//
+// OUTPUT:
+//      void
+//
+
+void ArchiveWriter::writeBlockHeader(string name, const BlockType type, const uint64_t Nrows, const uint64_t Ncols)
+{
+    const uint32_t nameLength = name.size();
+    const uint32_t typeCode = type;
+    const char padding[8] = {0};
+
+    writeBytes(&nameLength, 4);
+    writeBytes(name.data(), nameLength);
+    writeBytes(&typeCode, 4);
+    writeBytes(&Nrows, 8);
+    writeBytes(&Ncols, 8);
+    writeBytes(padding, (8 - position % 8) % 8);
+}
+
+
+
+
+
+
+
+
+
+
+// ArchiveWriter::writeBytes()
+//
+// PURPOSE:
+//      Write raw bytes to the archive, and check that the writing succeeded.
+//
+// INPUT:
+//      bytes: pointer to the first byte
+//      Nbytes: the number of bytes to be written
+//
+// OUTPUT:
+//      void
+//
+
+void ArchiveWriter::writeBytes(const void *bytes, const uint64_t Nbytes)
+{
+    if (Nbytes == 0) return;
+
+    outputFile.write(static_cast<const char*>(bytes), Nbytes);
+
+    if (!outputFile.good())
+    {
+        cerr << "Error writing to output file " << fullPath << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    position += Nbytes;
+}
@@ -0,0 +1,404 @@
+#include "CachedLikelihood.h"
+
+
+// CachedLikelihood::CachedLikelihood()
+//
+// PURPOSE: 
+//      Derived class constructor.
+//
+// INPUT:
+//      likelihood: the likelihood whose values are to be cached
+//      quantizationSteps: for each free parameter, the step to which it is rounded
+//                         before looking up the cache. For a parameter on a grid this
+//                         is the grid spacing. A zero step means that only identical
+//                         values of that parameter share an entry.
+//                         The likelihood is evaluated at the nearest node of the grid.
+//      maxNentries: maximum number of cached log-likelihood values
+//
+// REMARKS:
+//      The observations and the model are those of the cached likelihood.
+// 
+
+CachedLikelihood::CachedLikelihood(Likelihood &likelihood, const RefArrayXd quantizationSteps, const size_t maxNentries)
+: CachedLikelihood(likelihood, likelihood.getObservations(), quantizationSteps, maxNentries)
+{
+
+}
+
+
+
+
+
+
+
+
+
+// CachedLikelihood::CachedLikelihood()
+//
+// PURPOSE: 
+//      Private constructor, to which the public constructor delegates. The copy of the
+//      observations is passed by value, so that it can be bound to the argument of
+//      the constructor of Likelihood.
+// 
+
+CachedLikelihood::CachedLikelihood(Likelihood &likelihood, ArrayXd observations, const RefArrayXd quantizationSteps, 
+                                   const size_t maxNentries)
+: Likelihood(observations, likelihood.getModel()),
+  likelihood(likelihood),
+  quantizer(quantizationSteps),
+  maxNentries(maxNentries),
+  Nhits(0),
+  Nmisses(0)
+{
+    assert(maxNentries > 0);
+
+    entryOfKey.reserve(maxNentries);
+}
+
+
+
+
+
+
+
+
+
+// CachedLikelihood::~CachedLikelihood()
+//
+// PURPOSE: 
+//      Derived class destructor.
+//
+
+CachedLikelihood::~CachedLikelihood()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// CachedLikelihood::fingerprint()
+//
+// PURPOSE:
+//      Compute a hash of everything the log-likelihood values depend on,
+//      apart from the free parameters (see Likelihood::fingerprint()).
+//
+// OUTPUT:
+//      The hash of the wrapped likelihood, combined with the quantization steps,
+//      since the cached values are those of the nodes of the grid.
+//
+
+unsigned long long CachedLikelihood::fingerprint()
+{
+    ArrayXd quantizationSteps = quantizer.getQuantizationSteps();
+
+    return Functions::fnv1aHash(quantizationSteps.data(), quantizationSteps.size() * sizeof(double), 
+                                likelihood.fingerprint());
+}
+
+
+
+
+
+
+
+
+
+// CachedLikelihood::logValue()
+//
+// PURPOSE:
+//      Get the natural logarithm of the likelihood from the cache, or compute it
+//      with the cached likelihood and store it in the cache.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//                       values of the free parameters that describe the model.
+//
+// OUTPUT:
+//      a double number containing the natural logarithm of the likelihood
+//
+// REMARKS:
+//      The likelihood is computed at the node of the grid nearest to modelParameters,
+//      so that the value does not depend on the order in which the points are evaluated.
+//      It is computed outside the lock of the cache, so that several threads can 
+//      evaluate different points at the same time.
+//
+
+double CachedLikelihood::logValue(RefArrayXd const modelParameters)
+{
+    Key key = quantizer.makeKey(modelParameters);
+    double logLikelihood;
+
+    if (lookUp(key, logLikelihood))
+    {
+        return logLikelihood;
+    }
+
+    ArrayXd node = quantizer.getNode(key);
+    logLikelihood = likelihood.logValue(node);
+    insert(key, logLikelihood);
+
+    return logLikelihood;
+}
+
+
+
+
+
+
+
+
+
+// CachedLikelihood::logValue()
+//
+// PURPOSE:
+//      As logValue() above, when only values of the log-likelihood above a threshold
+//      are of interest (see Likelihood::logValue()).
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//                       values of the free parameters that describe the model.
+//      logLikelihoodThreshold: the value below which the exact log-likelihood is not needed
+//
+// OUTPUT:
+//      The natural logarithm of the likelihood if it is at least logLikelihoodThreshold,
+//      otherwise an upper bound of it that is smaller than logLikelihoodThreshold.
+//
+// REMARKS:
+//      Values below the threshold may be upper bounds only, so they are not stored in the cache.
+//
+
+double CachedLikelihood::logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold)
+{
+    Key key = quantizer.makeKey(modelParameters);
+    double logLikelihood;
+
+    if (lookUp(key, logLikelihood))
+    {
+        return logLikelihood;
+    }
+
+    ArrayXd node = quantizer.getNode(key);
+    logLikelihood = likelihood.logValue(node, logLikelihoodThreshold);
+
+    if (logLikelihood >= logLikelihoodThreshold)
+    {
+        insert(key, logLikelihood);
+    }
+
+    return logLikelihood;
+}
+
+
+
+
+
+
+
+
+
+// CachedLikelihood::clear()
+//
+// PURPOSE:
+//      Remove all entries from the cache, and reset the hit and miss counters.
+//
+// OUTPUT:
+//      void
+//
+
+void CachedLikelihood::clear()
+{
+    lock_guard<mutex> lock(cacheMutex);
+
+    entries.clear();
+    entryOfKey.clear();
+    Nhits = 0;
+    Nmisses = 0;
+}
+
+
+
+
+
+
+
+
+
+// CachedLikelihood::getNhits()
+//
+// PURPOSE:
+//      Get private data member Nhits.
+//
+// OUTPUT:
+//      The number of log-likelihood values that were found in the cache.
+//
+
+unsigned long CachedLikelihood::getNhits()
+{
+    lock_guard<mutex> lock(cacheMutex);
+
+    return Nhits;
+}
+
+
+
+
+
+
+
+
+
+// CachedLikelihood::getNmisses()
+//
+// PURPOSE:
+//      Get private data member Nmisses.
+//
+// OUTPUT:
+//      The number of log-likelihood values that had to be computed.
+//
+
+unsigned long CachedLikelihood::getNmisses()
+{
+    lock_guard<mutex> lock(cacheMutex);
+
+    return Nmisses;
+}
+
+
+
+
+
+
+
+
+
+// CachedLikelihood::getNentries()
+//
+// PURPOSE:
+//      Get the current number of entries in the cache.
+//
+// OUTPUT:
+//      The number of cached log-likelihood values.
+//
+
+size_t CachedLikelihood::getNentries()
+{
+    lock_guard<mutex> lock(cacheMutex);
+
+    return entries.size();
+}
+
+
+
+
+
+
+
+
+
+// CachedLikelihood::getMaxNentries()
+//
+// PURPOSE:
+//      Get private data member maxNentries.
+//
+// OUTPUT:
+//      The maximum number of cached log-likelihood values.
+//
+
+size_t CachedLikelihood::getMaxNentries()
+{
+    return maxNentries;
+}
+
+
+
+
+
+
+
+
+
+// CachedLikelihood::lookUp()
+//
+// PURPOSE:
+//      Look up the log-likelihood value of a key, and mark the entry as most recently used.
+//
+// INPUT:
+//      key: the quantized model parameters
+//      logLikelihood: the cached value, if found
+//
+// OUTPUT:
+//      True if the key was found in the cache, false otherwise.
+//
+
+bool CachedLikelihood::lookUp(const Key &key, double &logLikelihood)
+{
+    lock_guard<mutex> lock(cacheMutex);
+
+    auto found = entryOfKey.find(key);
+
+    if (found == entryOfKey.end())
+    {
+        Nmisses++;
+        return false;
+    }
+
+    entries.splice(entries.begin(), entries, found->second);
+    logLikelihood = found->second->second;
+    Nhits++;
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+// CachedLikelihood::insert()
+//
+// PURPOSE:
+//      Store the log-likelihood value of a key as the most recently used entry, 
+//      and evict the least recently used entry if the cache is full.
+//
+// INPUT:
+//      key: the quantized model parameters
+//      logLikelihood: the value to be cached
+//
+// OUTPUT:
+//      void
+//
+
+void CachedLikelihood::insert(const Key &key, const double logLikelihood)
+{
+    lock_guard<mutex> lock(cacheMutex);
+
+
+    // Another thread may have inserted the same key in the meantime
+
+    auto found = entryOfKey.find(key);
+
+    if (found != entryOfKey.end())
+    {
+        entries.splice(entries.begin(), entries, found->second);
+        return;
+    }
+
+    entries.emplace_front(key, logLikelihood);
+    entryOfKey[key] = entries.begin();
+
+    if (entries.size() > maxNentries)
+    {
+        entryOfKey.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
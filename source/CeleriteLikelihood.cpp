@@ -0,0 +1,360 @@
+#include "CeleriteLikelihood.h"
+
+
+// CeleriteLikelihood::CeleriteLikelihood()
+//
+// PURPOSE:
+//      Derived class constructor.
+//
+// INPUT:
+//      observations: array containing the dependent variable values
+//      uncertainties: array containing the uncertainties of the observations,
+//                     i.e. the white noise added to the diagonal of the covariance matrix
+//      model: object specifying the mean function. Its covariates (e.g. the times
+//             of the observations) should be sorted in increasing order.
+//      NrealTerms: number of terms a * exp(-c * tau) of the kernel
+//      NcomplexTerms: number of terms exp(-c * tau) * (a * cos(d * tau) + b * sin(d * tau))
+//                     of the kernel
+//
+// REMARKS:
+//      The free parameters are those of the model, followed by (a, c) for each real
+//      term and by (a, b, c, d) for each complex term of the kernel.
+//
+
+CeleriteLikelihood::CeleriteLikelihood(const RefArrayXd observations, const RefArrayXd uncertainties, Model &model,
+                                       const int NrealTerms, const int NcomplexTerms)
+: Likelihood(observations, model),
+  uncertainties(uncertainties),
+  NrealTerms(NrealTerms),
+  NcomplexTerms(NcomplexTerms)
+{
+    refuseLinearParameters("CeleriteLikelihood");
+
+    assert(observations.size() == uncertainties.size());
+    assert(NrealTerms >= 0 && NcomplexTerms >= 0);
+
+    squaredUncertainties = uncertainties.square();
+
+
+    // The factorization runs over the observations in the order of the covariates
+
+    covariates = model.getCovariates();
+    const int Nobservations = covariates.size();
+
+    timeDifferences = ArrayXd::Zero(Nobservations);
+
+    for (int n = 1; n < Nobservations; ++n)
+    {
+        timeDifferences(n) = covariates(n) - covariates(n-1);
+    }
+
+    if ((timeDifferences < 0.0).any())
+    {
+        cerr << "CeleriteLikelihood: the covariates of the model should be sorted in increasing order." << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+
+
+
+
+
+
+
+// CeleriteLikelihood::~CeleriteLikelihood()
+//
+// PURPOSE:
+//      Derived class destructor.
+//
+
+CeleriteLikelihood::~CeleriteLikelihood()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// CeleriteLikelihood::fingerprint()
+//
+// PURPOSE:
+//      Compute a hash of everything the log-likelihood values depend on,
+//      apart from the free parameters (see Likelihood::fingerprint()).
+//
+// OUTPUT:
+//      The hash of the base class, combined with the uncertainties and the
+//      numbers of terms of the kernel.
+//
+
+unsigned long long CeleriteLikelihood::fingerprint()
+{
+    unsigned long long hash = Likelihood::fingerprint();
+    hash = Functions::fnv1aHash(uncertainties.data(), uncertainties.size() * sizeof(double), hash);
+    hash = Functions::fnv1aHash(&NrealTerms, sizeof(int), hash);
+    hash = Functions::fnv1aHash(&NcomplexTerms, sizeof(int), hash);
+
+    return hash;
+}
+
+
+
+
+
+
+
+
+
+// CeleriteLikelihood::getUncertainties()
+//
+// PURPOSE:
+//      Get private data member uncertainties.
+//
+// OUTPUT:
+//      The uncertainties of the observations.
+//
+
+ArrayXd CeleriteLikelihood::getUncertainties()
+{
+    return uncertainties;
+}
+
+
+
+
+
+
+
+
+
+// CeleriteLikelihood::getNrealTerms()
+//
+// PURPOSE:
+//      Get private data member NrealTerms.
+//
+// OUTPUT:
+//      The number of real terms of the kernel.
+//
+
+int CeleriteLikelihood::getNrealTerms()
+{
+    return NrealTerms;
+}
+
+
+
+
+
+
+
+
+
+// CeleriteLikelihood::getNcomplexTerms()
+//
+// PURPOSE:
+//      Get private data member NcomplexTerms.
+//
+// OUTPUT:
+//      The number of complex terms of the kernel.
+//
+
+int CeleriteLikelihood::getNcomplexTerms()
+{
+    return NcomplexTerms;
+}
+
+
+
+
+
+
+
+
+
+// CeleriteLikelihood::getNkernelParameters()
+//
+// PURPOSE:
+//      Get the number of free parameters of the kernel.
+//
+// OUTPUT:
+//      2 per real term and 4 per complex term. The total number of free parameters
+//      is this number plus the number of parameters of the model.
+//
+
+int CeleriteLikelihood::getNkernelParameters()
+{
+    return 2 * NrealTerms + 4 * NcomplexTerms;
+}
+
+
+
+
+
+
+
+
+
+// CeleriteLikelihood::logValue()
+//
+// PURPOSE:
+//      Compute the natural logarithm of the normal likelihood of the residuals
+//      observations - model, with covariance matrix
+//          K(n,m) = uncertainties(n)^2 * delta(n,m) + kernel(|t(n) - t(m)|)
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the parameters of the model,
+//                       followed by the parameters of the kernel.
+//
+// OUTPUT:
+//      The natural logarithm of the likelihood, -0.5 * (r^T K^{-1} r + log|K| + N log(2 pi)).
+//      If the kernel parameters are invalid, or if K is not positive definite, the lowest
+//      double is returned, so that the point is never accepted.
+//
+// REMARKS:
+//      K = L D L^T, where each row of the unit lower-triangular L below the diagonal is
+//      U(n)^T W(m) times decaying exponentials, and U, W have J columns (1 per real term,
+//      2 per complex term). The rows of D and W follow from the recursion
+//          S(n) = phi(n) phi(n)^T * [S(n-1) + D(n-1) W(n-1) W(n-1)^T]
+//          D(n) = K(n,n) - U(n)^T S(n) U(n)
+//          W(n) = [V(n) - S(n) U(n)] / D(n)
+//      with phi(n) = exp(-c * (t(n) - t(n-1))), and the forward substitution L z = r is done
+//      in the same pass, so that only O(J^2) memory is needed besides the residuals.
+//      This is the numerically stable form of Foreman-Mackey et al. (2017), Sect. 5.2.
+//      The workspace is allocated per thread and per likelihood (see Likelihood::getVectorWorkspace()).
+//
+
+double CeleriteLikelihood::logValue(RefArrayXd const modelParameters)
+{
+    const int Nobservations = observations.size();
+    const int Nterms = NrealTerms + NcomplexTerms;
+    const int J = NrealTerms + 2 * NcomplexTerms;
+    const int firstKernelParameter = modelParameters.size() - getNkernelParameters();
+
+    assert(firstKernelParameter >= 0);
+
+
+    // Unpack the parameters of the kernel. The real terms have b = d = 0.
+
+    ArrayXd &a = getVectorWorkspace(0, Nterms);
+    ArrayXd &b = getVectorWorkspace(1, Nterms);
+    ArrayXd &c = getVectorWorkspace(2, Nterms);
+    ArrayXd &d = getVectorWorkspace(3, Nterms);
+
+    for (int term = 0; term < NrealTerms; ++term)
+    {
+        a(term) = modelParameters(firstKernelParameter + 2*term);
+        b(term) = 0.0;
+        c(term) = modelParameters(firstKernelParameter + 2*term + 1);
+        d(term) = 0.0;
+    }
+
+    for (int term = 0; term < NcomplexTerms; ++term)
+    {
+        const int index = firstKernelParameter + 2*NrealTerms + 4*term;
+        a(NrealTerms + term) = modelParameters(index);
+        b(NrealTerms + term) = modelParameters(index + 1);
+        c(NrealTerms + term) = modelParameters(index + 2);
+        d(NrealTerms + term) = modelParameters(index + 3);
+    }
+
+    if ((c < 0.0).any())
+    {
+        return numeric_limits<double>::lowest();
+    }
+
+
+    // The residuals overwrite the predictions
+
+    ArrayXd &residuals = getPredictionsWorkspace();
+
+    residuals.setZero();
+    model.predict(residuals, modelParameters);
+    residuals = observations - residuals;
+
+
+    // Semiseparable Cholesky factorization and forward substitution.
+    // Basis function j belongs to term j for the real terms, and to term
+    // NrealTerms + (j - NrealTerms)/2 for the complex terms.
+
+    ArrayXd &U = getVectorWorkspace(4, J);
+    ArrayXd &V = getVectorWorkspace(5, J);
+    ArrayXd &W = getVectorWorkspace(6, J);
+    ArrayXd &phi = getVectorWorkspace(7, J);
+    ArrayXd &f = getVectorWorkspace(8, J);
+    ArrayXd &SU = getVectorWorkspace(9, J);
+    ArrayXXd &S = getMatrixWorkspace(0, J, J);
+
+    f.setZero();
+    S.setZero();
+
+    const double kernelVariance = a.sum();
+    double previousD = 0.0;
+    double previousZ = 0.0;
+    double logDeterminant = 0.0;
+    double chiSquare = 0.0;
+
+    for (int n = 0; n < Nobservations; ++n)
+    {
+        const double t = covariates(n);
+
+        for (int term = 0; term < NrealTerms; ++term)
+        {
+            U(term) = a(term);
+            V(term) = 1.0;
+            phi(term) = exp(-c(term) * timeDifferences(n));
+        }
+
+        for (int term = NrealTerms; term < Nterms; ++term)
+        {
+            const int j = NrealTerms + 2 * (term - NrealTerms);
+            const double cosine = cos(d(term) * t);
+            const double sine = sin(d(term) * t);
+
+            U(j)   = a(term) * cosine + b(term) * sine;
+            U(j+1) = a(term) * sine - b(term) * cosine;
+            V(j)   = cosine;
+            V(j+1) = sine;
+            phi(j) = phi(j+1) = exp(-c(term) * timeDifferences(n));
+        }
+
+        if (n > 0)
+        {
+            for (int j = 0; j < J; ++j)
+            {
+                for (int k = 0; k < J; ++k)
+                {
+                    S(j,k) = phi(j) * phi(k) * (S(j,k) + previousD * W(j) * W(k));
+                }
+            }
+
+            f = phi * (f + W * previousZ);
+        }
+
+        SU = (S.matrix() * U.matrix()).array();
+
+        const double D = squaredUncertainties(n) + kernelVariance - (U * SU).sum();
+
+        if (!(D > 0.0))
+        {
+            return numeric_limits<double>::lowest();
+        }
+
+        W = (V - SU) / D;
+
+        const double z = residuals(n) - (U * f).sum();
+
+        logDeterminant += log(D);
+        chiSquare += z * z / D;
+        previousD = D;
+        previousZ = z;
+    }
+
+    return -0.5 * (chiSquare + logDeterminant + Nobservations * log(2.0*Functions::PI));
+}
@@ -8,3 +8,24 @@ Clusterer::Clusterer(Metric &metric)
 
 }
 
+
+
+
+
+
+
+
+
+// Clusterer::getMetric()
+//
+// PURPOSE:
+//      Get protected data member metric.
+//
+// OUTPUT:
+//      A reference to the metric used to compute the distance between two points.
+//
+
+Metric &Clusterer::getMetric()
+{
+    return metric;
+}
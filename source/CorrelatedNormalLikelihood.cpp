@@ -0,0 +1,426 @@
+#include "CorrelatedNormalLikelihood.h"
+
+
+// CorrelatedNormalLikelihood::CorrelatedNormalLikelihood()
+//
+// PURPOSE:
+//      Derived class constructor, for a banded covariance matrix.
+//
+// INPUT:
+//      observations: array containing the dependent variable values
+//      bandedCovariance: two-dimensional array of size (bandwidth+1, Nobservations), where
+//                        bandedCovariance(k,n) is the covariance between observations n and n-k.
+//                        The elements with n < k are ignored.
+//      model: object specifying the model to be used.
+//
+// REMARKS:
+//      The Cholesky decomposition costs O(N bandwidth^2) and is only done here.
+//
+
+CorrelatedNormalLikelihood::CorrelatedNormalLikelihood(const RefArrayXd observations, const RefArrayXXd bandedCovariance,
+                                                       Model &model)
+: Likelihood(observations, model),
+  covarianceIsToeplitz(false)
+{
+    refuseLinearParameters("CorrelatedNormalLikelihood");
+
+    assert(bandedCovariance.cols() == observations.size());
+
+    factorizeBandedCovariance(bandedCovariance);
+    normalizationConstant = -0.5 * (observations.size() * log(2.0*Functions::PI) + logDeterminant);
+}
+
+
+
+
+
+
+
+
+
+// CorrelatedNormalLikelihood::CorrelatedNormalLikelihood()
+//
+// PURPOSE:
+//      Derived class constructor, for a stationary (Toeplitz) covariance matrix.
+//
+// INPUT:
+//      observations: array containing the dependent variable values, equally spaced
+//      autocovariance: autocovariance(k) is the covariance between observations n and n-k,
+//                      for all n. The autocovariance beyond the last given lag is zero.
+//      model: object specifying the model to be used.
+//      relTolerance: the Levinson-Durbin recursion is stopped when the absolute value of the
+//                    reflection coefficient falls below relTolerance (e.g. 1.e-12), beyond the
+//                    last lag of the autocovariance. The predictor of that order is then used
+//                    for all following observations.
+//
+// REMARKS:
+//      The factorization costs O(p^2) and each evaluation O(N p), where p is the order
+//      at which the recursion stopped. With relTolerance = 0 the recursion runs up to
+//      order N-1, which is exact but costs O(N^2) memory.
+//
+
+CorrelatedNormalLikelihood::CorrelatedNormalLikelihood(const RefArrayXd observations, const RefArrayXd autocovariance,
+                                                       Model &model, const double relTolerance)
+: Likelihood(observations, model),
+  covarianceIsToeplitz(true)
+{
+    refuseLinearParameters("CorrelatedNormalLikelihood");
+
+    assert(autocovariance.size() > 0);
+    assert(relTolerance >= 0.0);
+
+    factorizeToeplitzCovariance(autocovariance, relTolerance);
+    normalizationConstant = -0.5 * (observations.size() * log(2.0*Functions::PI) + logDeterminant);
+}
+
+
+
+
+
+
+
+
+
+// CorrelatedNormalLikelihood::~CorrelatedNormalLikelihood()
+//
+// PURPOSE:
+//      Derived class destructor.
+//
+
+CorrelatedNormalLikelihood::~CorrelatedNormalLikelihood()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// CorrelatedNormalLikelihood::fingerprint()
+//
+// PURPOSE:
+//      Compute a hash of everything the log-likelihood values depend on,
+//      apart from the free parameters (see Likelihood::fingerprint()).
+//
+// OUTPUT:
+//      The hash of the base class, combined with the factorization of the
+//      covariance matrix, which determines the covariance matrix.
+//
+
+unsigned long long CorrelatedNormalLikelihood::fingerprint()
+{
+    unsigned long long hash = Likelihood::fingerprint();
+    hash = Functions::fnv1aHash(&covarianceIsToeplitz, sizeof(bool), hash);
+    hash = Functions::fnv1aHash(choleskyBand.data(), choleskyBand.size() * sizeof(double), hash);
+    hash = Functions::fnv1aHash(predictionErrorVariances.data(), predictionErrorVariances.size() * sizeof(double), hash);
+
+    for (size_t order = 0; order < predictionCoefficients.size(); ++order)
+    {
+        hash = Functions::fnv1aHash(predictionCoefficients[order].data(), 
+                                    predictionCoefficients[order].size() * sizeof(double), hash);
+    }
+
+    return hash;
+}
+
+
+
+
+
+
+
+
+
+// CorrelatedNormalLikelihood::getBandwidth()
+//
+// PURPOSE:
+//      Get the number of preceding observations used to whiten each residual.
+//
+// OUTPUT:
+//      The bandwidth of the Cholesky factor for a banded covariance matrix, or the
+//      order of the linear predictor for a Toeplitz covariance matrix.
+//
+
+int CorrelatedNormalLikelihood::getBandwidth()
+{
+    if (covarianceIsToeplitz)
+    {
+        return predictionErrorVariances.size() - 1;
+    }
+    else
+    {
+        return choleskyBand.rows() - 1;
+    }
+}
+
+
+
+
+
+
+
+
+
+// CorrelatedNormalLikelihood::getLogDeterminant()
+//
+// PURPOSE:
+//      Get private data member logDeterminant.
+//
+// OUTPUT:
+//      The natural logarithm of the determinant of the covariance matrix.
+//
+
+double CorrelatedNormalLikelihood::getLogDeterminant()
+{
+    return logDeterminant;
+}
+
+
+
+
+
+
+
+
+
+// CorrelatedNormalLikelihood::logValue()
+//
+// PURPOSE:
+//      Compute the natural logarithm of the normal likelihood with the fixed
+//      covariance matrix C.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the values of the free parameters
+//
+// OUTPUT:
+//      The natural logarithm of the likelihood, -0.5 * (r^T C^{-1} r + log|C| + N log(2 pi)),
+//      with r the residuals.
+//
+// REMARKS:
+//      For a banded covariance matrix C = L L^T, the residuals are whitened in place by
+//      solving L z = r, so that r^T C^{-1} r = z^T z. For a Toeplitz covariance matrix,
+//      each residual is whitened by subtracting its linear prediction from the preceding
+//      residuals, and divided by the variance of the prediction error.
+//
+
+double CorrelatedNormalLikelihood::logValue(RefArrayXd const modelParameters)
+{
+    const int Nobservations = observations.size();
+    ArrayXd &residuals = getPredictionsWorkspace();
+
+    residuals.setZero();
+    model.predict(residuals, modelParameters);
+    residuals = observations - residuals;
+
+    double chiSquare = 0.0;
+
+    if (covarianceIsToeplitz)
+    {
+        const int maxOrder = predictionErrorVariances.size() - 1;
+
+        for (int n = 0; n < Nobservations; ++n)
+        {
+            const int order = min(n, maxOrder);
+            const ArrayXd &coefficients = predictionCoefficients[order];
+            double predictionError = residuals(n);
+
+            for (int j = 1; j <= order; ++j)
+            {
+                predictionError -= coefficients(j) * residuals(n-j);
+            }
+
+            chiSquare += predictionError * predictionError / predictionErrorVariances(order);
+        }
+    }
+    else
+    {
+        const int bandwidth = choleskyBand.rows() - 1;
+
+        for (int n = 0; n < Nobservations; ++n)
+        {
+            const int Nterms = min(n, bandwidth);
+
+            for (int k = 1; k <= Nterms; ++k)
+            {
+                residuals(n) -= choleskyBand(k,n) * residuals(n-k);
+            }
+
+            residuals(n) /= choleskyBand(0,n);
+            chiSquare += residuals(n) * residuals(n);
+        }
+    }
+
+    return normalizationConstant - 0.5 * chiSquare;
+}
+
+
+
+
+
+
+
+
+
+// CorrelatedNormalLikelihood::factorizeBandedCovariance()
+//
+// PURPOSE:
+//      Compute the Cholesky factor L of a banded covariance matrix, which has
+//      the same bandwidth, and the log-determinant of the covariance matrix.
+//
+// INPUT:
+//      bandedCovariance: two-dimensional array of size (bandwidth+1, Nobservations), where
+//                        bandedCovariance(k,n) is the covariance between observations n and n-k.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      If the covariance matrix is not positive definite, the program is stopped.
+//
+
+void CorrelatedNormalLikelihood::factorizeBandedCovariance(const RefArrayXXd bandedCovariance)
+{
+    const int bandwidth = bandedCovariance.rows() - 1;
+    const int Nobservations = bandedCovariance.cols();
+
+    choleskyBand = ArrayXXd::Zero(bandwidth + 1, Nobservations);
+    logDeterminant = 0.0;
+
+    for (int n = 0; n < Nobservations; ++n)
+    {
+        const int Nterms = min(n, bandwidth);
+
+        // Off-diagonal elements L(n,m) with m = n-k, from the farthest to the closest to the diagonal
+
+        for (int k = Nterms; k >= 1; --k)
+        {
+            const int m = n - k;
+            double sum = bandedCovariance(k,n);
+
+            for (int i = n - Nterms; i < m; ++i)
+            {
+                sum -= choleskyBand(n-i, n) * choleskyBand(m-i, m);
+            }
+
+            choleskyBand(k,n) = sum / choleskyBand(0,m);
+        }
+
+        double diagonal = bandedCovariance(0,n);
+
+        for (int k = 1; k <= Nterms; ++k)
+        {
+            diagonal -= choleskyBand(k,n) * choleskyBand(k,n);
+        }
+
+        if (!(diagonal > 0.0))
+        {
+            cerr << "CorrelatedNormalLikelihood: the covariance matrix is not positive definite." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        choleskyBand(0,n) = sqrt(diagonal);
+        logDeterminant += log(diagonal);
+    }
+}
+
+
+
+
+
+
+
+
+
+// CorrelatedNormalLikelihood::factorizeToeplitzCovariance()
+//
+// PURPOSE:
+//      Compute the coefficients of the linear predictors of increasing order of a stationary
+//      process, and the variances of their prediction errors, with the Levinson-Durbin recursion.
+//      This is the factorization C^{-1} = A^T D^{-1} A of the Toeplitz covariance matrix C, with
+//      A unit lower-triangular. The log-determinant of the covariance matrix is also computed.
+//
+// INPUT:
+//      autocovariance: autocovariance(k) is the covariance between observations n and n-k.
+//      relTolerance: the recursion is stopped when the absolute value of the reflection
+//                    coefficient falls below relTolerance, beyond the last lag of the autocovariance.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      If the covariance matrix is not positive definite, the program is stopped.
+//
+
+void CorrelatedNormalLikelihood::factorizeToeplitzCovariance(const RefArrayXd autocovariance, const double relTolerance)
+{
+    const int Nobservations = observations.size();
+    const int Nlags = autocovariance.size();
+
+    if (!(autocovariance(0) > 0.0))
+    {
+        cerr << "CorrelatedNormalLikelihood: the covariance matrix is not positive definite." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    vector<double> variances(1, autocovariance(0));
+    predictionCoefficients.assign(1, ArrayXd::Zero(1));
+
+    for (int order = 1; order < Nobservations; ++order)
+    {
+        const ArrayXd &previousCoefficients = predictionCoefficients[order-1];
+        double numerator = (order < Nlags ? autocovariance(order) : 0.0);
+
+        for (int j = 1; j < order; ++j)
+        {
+            if (order - j < Nlags)
+            {
+                numerator -= previousCoefficients(j) * autocovariance(order-j);
+            }
+        }
+
+        const double reflectionCoefficient = numerator / variances[order-1];
+
+        if ((order >= Nlags) && (fabs(reflectionCoefficient) < relTolerance))
+        {
+            break;
+        }
+
+        ArrayXd coefficients(order + 1);
+        coefficients(0) = 0.0;
+        coefficients(order) = reflectionCoefficient;
+
+        for (int j = 1; j < order; ++j)
+        {
+            coefficients(j) = previousCoefficients(j) - reflectionCoefficient * previousCoefficients(order-j);
+        }
+
+        const double variance = variances[order-1] * (1.0 - reflectionCoefficient * reflectionCoefficient);
+
+        if (!(variance > 0.0))
+        {
+            cerr << "CorrelatedNormalLikelihood: the covariance matrix is not positive definite." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        predictionCoefficients.push_back(coefficients);
+        variances.push_back(variance);
+    }
+
+    const int maxOrder = variances.size() - 1;
+    predictionErrorVariances = Eigen::Map<ArrayXd>(variances.data(), variances.size());
+
+
+    // Observation n is predicted from min(n, maxOrder) preceding observations
+
+    logDeterminant = 0.0;
+
+    for (int n = 0; n < Nobservations; ++n)
+    {
+        logDeterminant += log(predictionErrorVariances(min(n, maxOrder)));
+    }
+}
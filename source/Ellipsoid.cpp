@@ -16,13 +16,11 @@ Ellipsoid::Ellipsoid(RefArrayXXd sample, const double enlargementFraction)
 : sample(sample),
   sampleSize(sample.cols()),
   Ndimensions(sample.rows()),
-  uniform(0.0, 1.0),
-  normal(0.0, 1.0)
+  uniform(0.0, 1.0)
 {
-    // Set the seed of the random generator using the clock
+    // Take an independent stream of random numbers, derived from the seed of the run
 
-    clock_t clockticks = clock();
-    engine.seed(clockticks);
+    engine = RandomStreams::getNextStream("Ellipsoid");
 
 
     // Resize the matrices to their proper size
@@ -337,12 +335,9 @@ void Ellipsoid::drawPoint(RefArrayXd drawnPoint)
     
     do
     {
-        for (int i = 0; i < Ndimensions; i++)
-        {
-            // Sample normally in each coordinate direction
+        // Sample normally in all coordinate directions at once
 
-            drawnPoint(i) = normal(engine); 
-        }
+        engine.fillNormal(drawnPoint);
     }
     while ((drawnPoint == 0.0).all());    // Repeat sampling if point falls in origin
     
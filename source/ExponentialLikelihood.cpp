@@ -12,6 +12,24 @@
 ExponentialLikelihood::ExponentialLikelihood(const RefArrayXd observations, Model &model)
 : Likelihood(observations, model)
 {
+    refuseLinearParameters("ExponentialLikelihood");
+
+    // The term -log(prediction) - observation/prediction is maximal for prediction = observation.
+    // The upper bounds of the terms are summed per segment, for logValue() with a threshold.
+
+    const int Nobservations = observations.size();
+    const int Nsegments = (Nobservations + segmentSize - 1) / segmentSize;
+
+    remainingUpperBounds = ArrayXd::Zero(Nsegments + 1);
+
+    for (int segment = Nsegments-1; segment >= 0; --segment)
+    {
+        const int beginIndex = segment * segmentSize;
+        const int length = min(segmentSize, Nobservations - beginIndex);
+
+        remainingUpperBounds(segment) = remainingUpperBounds(segment + 1)
+                                        - (observations.segment(beginIndex, length).log() + 1.0).sum();
+    }
 }
 
 
@@ -53,13 +71,79 @@ ExponentialLikelihood::~ExponentialLikelihood()
 //      a double number containing the natural logarithm of the
 //      exponential likelihood
 //
+// REMARKS:
+//      The terms are summed per segment of observations (see Likelihood::sumOverSegments()),
+//      with or without threads, so that the result does not depend on the number of threads.
+//
 
 double ExponentialLikelihood::logValue(RefArrayXd const modelParameters)
 {
-    ArrayXd predictions(observations.size());
-    predictions.setZero();
-    model.predict(predictions, modelParameters);
+    if (singlePrecisionIsUsed)
+    {
+        ArrayXf &predictions = getSinglePrecisionPredictionsWorkspace();
+
+        predictions.setZero();
+        model.predictSinglePrecision(predictions, modelParameters);
+        predictions = predictions.log() + observationsSinglePrecision / predictions;
+
+        return -1.0 * Functions::compensatedSum(predictions);
+    }
 
-    return -1.0*(predictions.log() + observations/predictions).sum();
+    auto sumOfTerms = [this](const int beginIndex, RefArrayXd predictions)
+    {
+        return (predictions.log() + observations.segment(beginIndex, predictions.size()) / predictions).sum();
+    };
+
+    return -1.0 * sumOverSegments(modelParameters, sumOfTerms);
 }
 
+
+
+
+
+
+
+
+
+// ExponentialLikelihood::logValue()
+//
+// PURPOSE:
+//      Compute the natural logarithm of the exponential likelihood, but stop as 
+//      soon as it is certain to be below a given threshold.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//                       values of the free parameters that describe the model.
+//      logLikelihoodThreshold: the value below which the exact log-likelihood is not needed
+//
+// OUTPUT:
+//      The natural logarithm of the exponential likelihood if it is at least logLikelihoodThreshold,
+//      otherwise an upper bound of it that is smaller than logLikelihoodThreshold.
+//
+// REMARKS:
+//      Each term -log(prediction) - observation/prediction is at most -log(observation) - 1,
+//      so that the partial sum plus the bounds of the remaining terms is an upper bound
+//      of the log-likelihood. If an observation is zero, its bound is infinite, and the 
+//      evaluation cannot stop before that observation is reached.
+//      In single precision mode, or with several threads, the exact value is always computed.
+//
+
+double ExponentialLikelihood::logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold)
+{
+    if (singlePrecisionIsUsed || (getNthreads() > 1))
+    {
+        return logValue(modelParameters);
+    }
+
+    auto sumOfTerms = [this](const int beginIndex, RefArrayXd predictions)
+    {
+        return (predictions.log() + observations.segment(beginIndex, predictions.size()) / predictions).sum();
+    };
+
+    auto upperBound = [this](const int NsegmentsDone, const double partialSum)
+    {
+        return remainingUpperBounds(NsegmentsDone) - partialSum;
+    };
+
+    return boundedSumOverSegments(modelParameters, logLikelihoodThreshold, sumOfTerms, upperBound);
+}
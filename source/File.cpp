@@ -273,6 +273,7 @@ vector<string> File::vectorStringFromFile(ifstream &inputFile, const unsigned lo
 //      array: array to write to a file
 //      separator: column separator, e.g. "  "
 //      terminator: line terminator, e.g. "\n"
+//      Nthreads: the number of threads formatting the values
 // 
 // OUTPUT:
 //      - file contents is changed
@@ -280,17 +281,132 @@ vector<string> File::vectorStringFromFile(ifstream &inputFile, const unsigned lo
 // REMARKS:
 //      - the stream is not closed afterwards
 //      - this function can equally well be used to append to an existing file
+//      - the values are formatted as the stream would do, according to its flags (e.g. scientific),
+//        precision and locale, but with snprintf() or formatScientific(). Blocks of rows are formatted 
+//        in parallel into buffers, which are then written to the stream in order, with one call each.
+//        If the stream has a field width set, or a locale with another decimal point or with digit
+//        grouping, the values are written one by one through the stream.
 //
 
-void File::arrayXXdToFile(ofstream &outputFile, RefArrayXXd array, string separator, string terminator)
+void File::arrayXXdToFile(ofstream &outputFile, RefArrayXXd array, string separator, string terminator, const int Nthreads)
 {
-    for (ptrdiff_t i = 0; i < array.rows(); ++i)
+    assert(Nthreads >= 1);
+
+    const ptrdiff_t Nrows = array.rows();
+    const ptrdiff_t Ncols = array.cols();
+
+
+    // Check if the formatting of the stream can be reproduced with printf-style conversions
+
+    const ios_base::fmtflags flags = outputFile.flags();
+    const ios_base::fmtflags floatField = flags & ios_base::floatfield;
+    const numpunct<char> &punctuation = use_facet<numpunct<char>>(outputFile.getloc());
+    
+    if ((outputFile.width() != 0) || (punctuation.decimal_point() != '.') || !punctuation.grouping().empty()
+        || (floatField == (ios_base::fixed | ios_base::scientific)))
+    {
+        for (ptrdiff_t i = 0; i < Nrows; ++i)
+        {
+            for (ptrdiff_t j = 0; j < Ncols-1; ++j)
+            {
+                outputFile << array(i,j) << separator;
+            }
+            outputFile << array(i,Ncols-1) << terminator;
+        }
+
+        return;
+    }
+
+
+    // Build the conversion used by the stream (see std::num_put), with a fast path for the
+    // scientific notation used for all output files of the code
+
+    const int precision = (outputFile.precision() < 0 ? 6 : outputFile.precision());
+    const bool uppercase = flags & ios_base::uppercase;
+    const bool showPositiveSign = flags & ios_base::showpos;
+    const bool useFormatScientific = (floatField == ios_base::scientific) && !(flags & ios_base::showpoint) 
+                                     && (precision <= 14);
+
+    string format = "%";
+    if (showPositiveSign) format += "+";
+    if (flags & ios_base::showpoint) format += "#";
+    format += ".*";
+
+    if (floatField == ios_base::fixed)
+    {
+        format += "f";
+    }
+    else if (floatField == ios_base::scientific)
+    {
+        format += (uppercase ? "E" : "e");
+    }
+    else
     {
-        for (ptrdiff_t j = 0; j < array.cols()-1; ++j)
+        format += (uppercase ? "G" : "g");
+    }
+
+
+    // Format blocks of rows in parallel, a few blocks per thread at a time, and write
+    // them in order
+
+    const ptrdiff_t NrowsPerBlock = max(ptrdiff_t(1), ptrdiff_t(65536) / max(Ncols, ptrdiff_t(1)));
+    const ptrdiff_t Nblocks = (Nrows + NrowsPerBlock - 1) / NrowsPerBlock;
+    const int NblocksPerBatch = (Nthreads == 1 ? 1 : 4 * Nthreads);
+    vector<string> buffers(NblocksPerBatch);
+    ThreadPool threadPool(Nthreads);
+
+    for (ptrdiff_t firstBlock = 0; firstBlock < Nblocks; firstBlock += NblocksPerBatch)
+    {
+        const int NblocksInBatch = min(ptrdiff_t(NblocksPerBatch), Nblocks - firstBlock);
+
+        auto formatBlock = [&](const int blockIndex)
         {
-            outputFile << array(i,j) << separator;
+            const ptrdiff_t firstRow = (firstBlock + blockIndex) * NrowsPerBlock;
+            const ptrdiff_t lastRow = min(firstRow + NrowsPerBlock, Nrows);
+            string &buffer = buffers[blockIndex];
+            char number[512];
+
+            buffer.clear();
+
+            for (ptrdiff_t i = firstRow; i < lastRow; ++i)
+            {
+                for (ptrdiff_t j = 0; j < Ncols; ++j)
+                {
+                    int length;
+
+                    if (useFormatScientific)
+                    {
+                        length = formatScientific(array(i,j), precision, number, uppercase, showPositiveSign);
+                    }
+                    else
+                    {
+                        length = snprintf(number, sizeof(number), format.c_str(), precision, array(i,j));
+                    }
+
+                    if (length >= int(sizeof(number)))
+                    {
+                        // Very large fixed-point numbers with a large precision
+
+                        vector<char> longNumber(length + 1);
+                        snprintf(longNumber.data(), longNumber.size(), format.c_str(), precision, array(i,j));
+                        buffer.append(longNumber.data(), length);
+                    }
+                    else
+                    {
+                        buffer.append(number, length);
+                    }
+
+                    buffer += (j < Ncols-1 ? separator : terminator);
+                }
+            }
+        };
+
+        threadPool.parallelFor(NblocksInBatch, formatBlock);
+
+        for (int blockIndex = 0; blockIndex < NblocksInBatch; ++blockIndex)
+        {
+            outputFile.write(buffers[blockIndex].data(), buffers[blockIndex].size());
         }
-        outputFile << array(i,array.cols()-1) << terminator;
     }
 } 
 
@@ -312,6 +428,7 @@ void File::arrayXXdToFile(ofstream &outputFile, RefArrayXXd array, string separa
 //      array2: array which will appear as the first column in the file
 //      separator: column separator, e.g. "  "
 //      terminator: line terminator, e.g. "\n"
+//      Nthreads: the number of threads formatting the values
 // 
 // OUTPUT:
 //      - file contents is changed
@@ -320,16 +437,18 @@ void File::arrayXXdToFile(ofstream &outputFile, RefArrayXXd array, string separa
 //      - overloaded function
 //      - the stream is not closed afterwards
 //      - this function can equally well be used to append to an existing file
+//      - the values are formatted as in arrayXXdToFile()
 //
 
-void File::twoArrayXdToFile(ofstream &outputFile, RefArrayXd array1, RefArrayXd array2, string separator, string terminator)
+void File::twoArrayXdToFile(ofstream &outputFile, RefArrayXd array1, RefArrayXd array2, string separator, string terminator, 
+                            const int Nthreads)
 {
     assert(array1.size() == array2.size());
     
-    for (ptrdiff_t i = 0; i < array1.rows(); ++i)
-    {
-        outputFile << array1(i) << separator << array2(i) << terminator;
-    }
+    ArrayXXd twoColumns(array1.size(), 2);
+    twoColumns.col(0) = array1;
+    twoColumns.col(1) = array2;
+    File::arrayXXdToFile(outputFile, twoColumns, separator, terminator, Nthreads);
 }
 
 
@@ -351,6 +470,7 @@ void File::twoArrayXdToFile(ofstream &outputFile, RefArrayXd array1, RefArrayXd
 //      outputFile: output stream, assumed to be already opened and checked for sanity.
 //      array: array which will appear as a column in the file
 //      terminator: line terminator, e.g. "\n"
+//      Nthreads: the number of threads formatting the values
 // 
 // OUTPUT:
 //      - file contents is changed
@@ -358,14 +478,13 @@ void File::twoArrayXdToFile(ofstream &outputFile, RefArrayXd array1, RefArrayXd
 // REMARKS:
 //      - the stream is not closed afterwards
 //      - this function can equally well be used to append to an existing file
+//      - the values are formatted as in arrayXXdToFile()
 //
 
-void File::arrayXdToFile(ofstream &outputFile, RefArrayXd array, string terminator)
+void File::arrayXdToFile(ofstream &outputFile, RefArrayXd array, string terminator, const int Nthreads)
 {
-    for (ptrdiff_t i = 0; i < array.size(); ++i)
-    {
-        outputFile << array(i) << terminator;
-    }
+    Eigen::Map<ArrayXXd> column(array.data(), array.size(), 1);
+    File::arrayXXdToFile(outputFile, column, "", terminator, Nthreads);
 } 
 
 
@@ -491,3 +610,635 @@ void File::sniffFile(ifstream &inputFile, unsigned long &Nrows, int &Ncols, char
 }
 
 
+
+
+
+
+
+
+
+
+
+// File::arrayXXdFromMappedFile()
+//
+// PURPOSE: 
+//      Reads an ascii file into an Eigen ArrayXXd, in a single pass over the file,
+//      without the need of sniffFile(). The file is memory-mapped, and large files 
+//      are split at line boundaries into chunks which are parsed in parallel.
+//
+// INPUT:
+//      inputFileName: full path of the input file.
+//      separator: numbers are normally separated by ' '. Use ',' for CSV files.
+//                 Spaces, tabs and carriage returns are always treated as separators.
+//      commentChar: all lines starting with this character (e.g. '#') are skipped
+//      Nthreads: the number of threads parsing the chunks of the file
+// 
+// OUTPUT:
+//      An Eigen::ArrayXXd, with the number of rows and columns found in the file.
+//
+// REMARKS:
+//      - Lines with only whitespace are skipped, as in arrayXXdFromFile().
+//      - Each chunk collects its numbers row by row, and they are copied into the
+//        array once the number of rows in all chunks is known.
+//
+//  EXAMPLE:  ArrayXXd data = File::arrayXXdFromMappedFile("myfile.txt");
+//
+
+ArrayXXd File::arrayXXdFromMappedFile(string inputFileName, char separator, char commentChar, const int Nthreads)
+{
+    assert(Nthreads >= 1);
+
+
+    // Map the file into memory
+
+    int fileDescriptor = open(inputFileName.c_str(), O_RDONLY);
+
+    if (fileDescriptor < 0)
+    {
+        cerr << "Error opening input file " << inputFileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    struct stat fileStatus;
+
+    if (fstat(fileDescriptor, &fileStatus) != 0)
+    {
+        close(fileDescriptor);
+        cerr << "Error reading the size of input file " << inputFileName << ": " << strerror(errno) << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    size_t fileSize = fileStatus.st_size;
+
+    if (fileSize == 0)
+    {
+        close(fileDescriptor);
+        cerr << "Warning: input file " << inputFileName << " is empty" << endl;
+        return ArrayXXd(0, 0);
+    }
+
+    // Pre-fault the pages where the system supports it (Linux), otherwise rely on madvise()
+
+    int mappingFlags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    mappingFlags |= MAP_POPULATE;
+#endif
+
+    void *mapping = mmap(NULL, fileSize, PROT_READ, mappingFlags, fileDescriptor, 0);
+    close(fileDescriptor);
+
+    if (mapping == MAP_FAILED)
+    {
+        cerr << "Error mapping input file " << inputFileName << ": " << strerror(errno) << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    madvise(mapping, fileSize, MADV_SEQUENTIAL);
+    const char *fileBegin = static_cast<const char*>(mapping);
+    const char *fileEnd = fileBegin + fileSize;
+
+
+    // Split the file in chunks of at least minChunkSize bytes, each chunk starting
+    // at the beginning of a line. A few chunks per thread balance the load.
+
+    const size_t minChunkSize = 1 << 20;
+    int Nchunks = 1;
+
+    if (Nthreads > 1)
+    {
+        Nchunks = int(min(size_t(4 * Nthreads), fileSize / minChunkSize + 1));
+    }
+
+    vector<const char*> chunkBegins(Nchunks + 1);
+    chunkBegins[0] = fileBegin;
+    chunkBegins[Nchunks] = fileEnd;
+
+    for (int chunk = 1; chunk < Nchunks; ++chunk)
+    {
+        const char *position = max(fileBegin + chunk * (fileSize / Nchunks), chunkBegins[chunk-1]);
+        const char *newline = static_cast<const char*>(memchr(position, '\n', fileEnd - position));
+        chunkBegins[chunk] = (newline == NULL ? fileEnd : newline + 1);
+    }
+
+
+    // Parse the chunks. Errors are only recorded here, as the row numbers in the file
+    // are only known once all chunks are parsed.
+
+    struct Chunk
+    {
+        vector<double> values;                  // The numbers of the chunk, row after row
+        unsigned long Nrows;
+        int Ncols;                              // Number of columns of the first row, -1 if there are no rows
+        long errorRow;                          // Row of the chunk where an error occurred, -1 if none
+        string errorMessage;
+    };
+
+    vector<Chunk> chunks(Nchunks);
+
+    auto parseChunk = [&](const int chunkIndex)
+    {
+        Chunk &chunk = chunks[chunkIndex];
+        const char *position = chunkBegins[chunkIndex];
+        const char *chunkEnd = chunkBegins[chunkIndex+1];
+
+        chunk.values.reserve((chunkEnd - position) / 8);
+        chunk.Nrows = 0;
+        chunk.Ncols = -1;
+        chunk.errorRow = -1;
+
+        auto isSeparator = [separator](const char character)
+        {
+            return (character == separator) || (character == ' ') || (character == '\t') || (character == '\r');
+        };
+
+        while (position < chunkEnd)
+        {
+            const char *lineEnd = static_cast<const char*>(memchr(position, '\n', chunkEnd - position));
+            if (lineEnd == NULL) lineEnd = chunkEnd;
+
+
+            // Skip those lines that start with the comment character
+
+            if (*position == commentChar)
+            {
+                position = lineEnd + 1;
+                continue;
+            }
+
+
+            // Convert the numbers on the line, delimited by separators
+
+            int Ntokens = 0;
+            const char *tokenBegin = position;
+
+            while (true)
+            {
+                while ((tokenBegin < lineEnd) && isSeparator(*tokenBegin)) ++tokenBegin;
+                if (tokenBegin == lineEnd) break;
+
+                const char *tokenEnd = tokenBegin;
+                while ((tokenEnd < lineEnd) && !isSeparator(*tokenEnd)) ++tokenEnd;
+
+                double value;
+
+                if (!parseDouble(tokenBegin, tokenEnd, value))
+                {
+                    chunk.errorRow = chunk.Nrows;
+                    chunk.errorMessage = "Can't convert " + string(tokenBegin, tokenEnd) + " to a number";
+                    return;
+                }
+
+                chunk.values.push_back(value);
+                Ntokens++;
+                tokenBegin = tokenEnd;
+            }
+
+
+            // Skip those lines with only whitespace, and check if the number of numbers
+            // on the line matches the number of columns of the first row
+
+            if (Ntokens > 0)
+            {
+                if (chunk.Ncols == -1)
+                {
+                    chunk.Ncols = Ntokens;
+                }
+                else if (Ntokens != chunk.Ncols)
+                {
+                    chunk.errorRow = chunk.Nrows;
+                    chunk.errorMessage = "number of tokens != " + to_string(chunk.Ncols);
+                    return;
+                }
+
+                chunk.Nrows++;
+            }
+
+            position = lineEnd + 1;
+        }
+    };
+
+    ThreadPool threadPool(min(Nthreads, Nchunks));
+    threadPool.parallelFor(Nchunks, parseChunk);
+
+
+    // Check the chunks in order, so that the first error of the file is reported, and
+    // find the first row of each chunk in the array
+
+    vector<unsigned long> firstRows(Nchunks);
+    unsigned long Nrows = 0;
+    int Ncols = -1;
+
+    for (int chunkIndex = 0; chunkIndex < Nchunks; ++chunkIndex)
+    {
+        Chunk &chunk = chunks[chunkIndex];
+
+        if ((chunk.errorRow < 0) && (chunk.Ncols != -1) && (Ncols != -1) && (chunk.Ncols != Ncols))
+        {
+            chunk.errorRow = 0;
+            chunk.errorMessage = "number of tokens != " + to_string(Ncols);
+        }
+
+        if (chunk.errorRow >= 0)
+        {
+            munmap(mapping, fileSize);
+            cerr << "Error on row " << Nrows + chunk.errorRow << " of " << inputFileName << ": " 
+                 << chunk.errorMessage << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        if (Ncols == -1)
+        {
+            Ncols = chunk.Ncols;
+        }
+
+        firstRows[chunkIndex] = Nrows;
+        Nrows += chunk.Nrows;
+    }
+
+    munmap(mapping, fileSize);
+
+
+    // Copy the numbers of each chunk into their rows of the array
+
+    ArrayXXd array(Nrows, max(Ncols, 0));
+
+    auto copyChunk = [&](const int chunkIndex)
+    {
+        Chunk &chunk = chunks[chunkIndex];
+        
+        if (chunk.Nrows == 0) return;
+
+        Eigen::Map<Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> 
+            chunkValues(chunk.values.data(), chunk.Nrows, Ncols);
+        array.block(firstRows[chunkIndex], 0, chunk.Nrows, Ncols) = chunkValues;
+        vector<double>().swap(chunk.values);
+    };
+
+    threadPool.parallelFor(Nchunks, copyChunk);
+
+    return array;
+}
+
+
+
+
+
+
+
+
+
+
+
+// File::parseDouble()
+//
+// PURPOSE: 
+//      Converts a string of characters to a floating point number.
+//
+// INPUT:
+//      begin: pointer to the first character of the string
+//      end: pointer past the last character of the string. The string does not need
+//           to be terminated with a null character.
+//      value: see output
+// 
+// OUTPUT:
+//      - true if the whole string is a number, false otherwise
+//      - value will contain the number
+//
+// REMARKS:
+//      Numbers with at most 19 significant digits whose mantissa, as an integer, is 
+//      smaller than 2^53 and whose decimal exponent is at most 22 in absolute value are
+//      converted with a single multiplication or division by an exact power of ten
+//      (Clinger 1990, Proc. ACM SIGPLAN'90, 92), which is correctly rounded. This covers
+//      almost all numbers in data files. All other strings, including "inf" and "nan",
+//      are converted with strtod().
+//
+
+bool File::parseDouble(const char *begin, const char *end, double &value)
+{
+    static const double powersOfTen[23] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                           1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 
+                                           1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char *position = begin;
+    bool isNegative = false;
+
+    if ((position < end) && ((*position == '-') || (*position == '+')))
+    {
+        isNegative = (*position == '-');
+        ++position;
+    }
+
+
+    // Collect the significant digits into an integer mantissa, and the decimal exponent
+
+    uint64_t mantissa = 0;
+    int Ndigits = 0;
+    int exponent = 0;
+
+    while ((position < end) && (*position == '0'))
+    {
+        Ndigits++;
+        ++position;
+    }
+
+    const char *digitsBegin = position;
+
+    while ((position < end) && (unsigned(*position - '0') < 10))
+    {
+        mantissa = 10 * mantissa + (*position - '0');
+        ++position;
+    }
+
+    int NsignificantDigits = position - digitsBegin;
+    Ndigits += NsignificantDigits;
+
+    if ((position < end) && (*position == '.'))
+    {
+        ++position;
+        const char *fractionBegin = position;
+
+        if (NsignificantDigits == 0)
+        {
+            // Leading zeros of the fraction are not significant
+
+            while ((position < end) && (*position == '0')) ++position;
+        }
+
+        digitsBegin = position;
+
+        while ((position < end) && (unsigned(*position - '0') < 10))
+        {
+            mantissa = 10 * mantissa + (*position - '0');
+            ++position;
+        }
+
+        NsignificantDigits += position - digitsBegin;
+        Ndigits += position - fractionBegin;
+        exponent = -int(position - fractionBegin);
+    }
+
+
+    // Beyond 19 significant digits the mantissa may have overflowed
+
+    bool isFastPath = (Ndigits > 0) && (NsignificantDigits <= 19);
+
+    if (isFastPath && (position < end) && ((*position == 'e') || (*position == 'E')))
+    {
+        ++position;
+        bool exponentIsNegative = false;
+
+        if ((position < end) && ((*position == '-') || (*position == '+')))
+        {
+            exponentIsNegative = (*position == '-');
+            ++position;
+        }
+
+        int explicitExponent = 0;
+        int NexponentDigits = 0;
+
+        while ((position < end) && (unsigned(*position - '0') < 10) && (explicitExponent < 10000))
+        {
+            explicitExponent = 10 * explicitExponent + (*position - '0');
+            NexponentDigits++;
+            ++position;
+        }
+
+        isFastPath = (NexponentDigits > 0);
+        exponent += (exponentIsNegative ? -explicitExponent : explicitExponent);
+    }
+
+    isFastPath = isFastPath && (position == end) && (mantissa <= (uint64_t(1) << 53)) 
+                 && (exponent >= -22) && (exponent <= 22);
+
+    if (isFastPath)
+    {
+        value = double(mantissa);
+        value = (exponent < 0 ? value / powersOfTen[-exponent] : value * powersOfTen[exponent]);
+        if (isNegative) value = -value;
+        return true;
+    }
+
+
+    // Fall back on strtod(), on a null-terminated copy of the string
+
+    string token(begin, end);
+    char *parsedEnd;
+    value = strtod(token.c_str(), &parsedEnd);
+
+    return (token.size() > 0) && (parsedEnd == token.c_str() + token.size());
+}
+
+
+
+
+
+
+
+
+
+
+
+// File::formatScientific()
+//
+// PURPOSE: 
+//      Converts a floating point number to a string in scientific notation, with
+//      the same result as the conversion %.*e of printf().
+//
+// INPUT:
+//      value: the number to be converted
+//      precision: the number of digits after the decimal point, between 0 and 14, so that
+//                 the significant digits fit exactly in a double
+//      output: the string, with room for at least 32 characters
+//      uppercase: if true the exponent is introduced by 'E' instead of 'e'
+//      showPositiveSign: if true positive numbers are preceded by '+'
+// 
+// OUTPUT:
+//      The number of characters written in the string, which is null-terminated.
+//
+// REMARKS:
+//      The number is scaled by a power of ten in double-double arithmetic (about 106 bits),
+//      with error-free products (Dekker 1971, Numer. Math. 18, 224), so that its (precision+1) 
+//      significant digits are the integer part of the result. If the fractional part is too
+//      close to 1/2 to round reliably, and for non-finite or extreme numbers, snprintf() is used.
+//
+
+int File::formatScientific(const double value, const int precision, char *output, const bool uppercase, const bool showPositiveSign)
+{
+    assert((precision >= 0) && (precision <= 14));
+
+    // Double-double powers of ten, from 10^0 to 10^308, computed once
+
+    struct DoubleDouble
+    {
+        double high;
+        double low;
+    };
+
+    auto twoProduct = [](const double a, const double b, double &product, double &error)
+    {
+        const double splitter = 134217729.0;            // 2^27 + 1
+        double aSplit = splitter * a;
+        double aHigh = aSplit - (aSplit - a);
+        double aLow = a - aHigh;
+        double bSplit = splitter * b;
+        double bHigh = bSplit - (bSplit - b);
+        double bLow = b - bHigh;
+
+        product = a * b;
+        error = ((aHigh * bHigh - product) + aHigh * bLow + aLow * bHigh) + aLow * bLow;
+    };
+
+    static const vector<DoubleDouble> powersOfTen = [&twoProduct]()
+    {
+        vector<DoubleDouble> powers(309);
+        powers[0].high = 1.0;
+        powers[0].low = 0.0;
+
+        for (int k = 1; k < 309; ++k)
+        {
+            double product, error;
+            twoProduct(10.0, powers[k-1].high, product, error);
+            error += 10.0 * powers[k-1].low;
+            powers[k].high = product + error;
+            powers[k].low = error - (powers[k].high - product);
+        }
+
+        return powers;
+    }();
+
+    const double absoluteValue = fabs(value);
+    uint64_t digits = 0;
+    int exponent = 0;
+    bool isFastPath = (absoluteValue == 0.0) || ((absoluteValue > 1.e-290) && (absoluteValue < 1.e290));
+
+    if (isFastPath && (absoluteValue > 0.0))
+    {
+        // Scale the number to [10^precision, 10^(precision+1)). The estimate of the exponent 
+        // from log10() may be off by one.
+
+        exponent = int(floor(log10(absoluteValue)));
+        double scaledHigh = 0.0;
+        double scaledLow = 0.0;
+
+        for (int attempt = 0; attempt < 3; ++attempt)
+        {
+            const int scale = precision - exponent;
+            const DoubleDouble &power = powersOfTen[abs(scale)];
+            double product, error;
+
+            if (scale >= 0)
+            {
+                twoProduct(absoluteValue, power.high, product, error);
+                error += absoluteValue * power.low;
+            }
+            else
+            {
+                const double quotient = absoluteValue / power.high;
+                twoProduct(quotient, power.high, product, error);
+                error += quotient * power.low;
+                const double correction = ((absoluteValue - product) - error) / power.high;
+                product = quotient;
+                error = correction;
+            }
+
+            scaledHigh = product + error;
+            scaledLow = error - (scaledHigh - product);
+
+            if (scaledHigh >= powersOfTen[precision+1].high)
+            {
+                exponent++;
+            }
+            else if (scaledHigh < powersOfTen[precision].high)
+            {
+                exponent--;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+
+        // Round the scaled number to the nearest integer
+
+        double integerPart = floor(scaledHigh);
+        double fractionalPart = (scaledHigh - integerPart) + scaledLow;
+
+        if (fractionalPart < 0.0)
+        {
+            integerPart -= 1.0;
+            fractionalPart += 1.0;
+        }
+        else if (fractionalPart >= 1.0)
+        {
+            integerPart += 1.0;
+            fractionalPart -= 1.0;
+        }
+
+        isFastPath = (fabs(fractionalPart - 0.5) > 1.e-6) && (integerPart >= powersOfTen[precision].high) 
+                     && (integerPart < powersOfTen[precision+1].high);
+
+        digits = uint64_t(integerPart) + (fractionalPart > 0.5 ? 1 : 0);
+
+        if (digits == uint64_t(powersOfTen[precision+1].high))
+        {
+            digits /= 10;
+            exponent++;
+        }
+    }
+
+    if (!isFastPath)
+    {
+        const char *format = (uppercase ? (showPositiveSign ? "%+.*E" : "%.*E") : (showPositiveSign ? "%+.*e" : "%.*e"));
+        return snprintf(output, 32, format, precision, value);
+    }
+
+
+    // Write the sign, the digits and the exponent
+
+    int length = 0;
+
+    if (signbit(value))
+    {
+        output[length++] = '-';
+    }
+    else if (showPositiveSign)
+    {
+        output[length++] = '+';
+    }
+
+    // The digits after the decimal point are written from the last one, so that
+    // the leading digit is what remains of digits
+
+    char digitCharacters[16];
+
+    for (int n = precision; n >= 1; --n)
+    {
+        digitCharacters[n] = char('0' + digits % 10);
+        digits /= 10;
+    }
+
+    output[length++] = char('0' + digits);
+
+    if (precision > 0)
+    {
+        output[length++] = '.';
+        memcpy(output + length, digitCharacters + 1, precision);
+        length += precision;
+    }
+
+    output[length++] = (uppercase ? 'E' : 'e');
+    output[length++] = (exponent < 0 ? '-' : '+');
+    const int absoluteExponent = abs(exponent);
+
+    if (absoluteExponent >= 100)
+    {
+        output[length++] = char('0' + absoluteExponent / 100);
+    }
+
+    output[length++] = char('0' + (absoluteExponent / 10) % 10);
+    output[length++] = char('0' + absoluteExponent % 10);
+    output[length] = '\0';
+
+    return length;
+}
@@ -152,6 +152,433 @@ void Functions::modeProfileSinc(RefArrayXd predictions, const RefArrayXd covaria
 
 
 
+// Helpers of the windowed profiles, only used within this file.
+//
+// The covariates are split into segments of equal length 2 * halfLength. Each profile is 
+// evaluated exactly in the segments that overlap with its window. In the other segments it is 
+// expanded in a polynomial of degree wingExpansionDegree in t = (covariate - centre) / halfLength, 
+// with -1 <= t <= 1 and centre the middle of the segment. The coefficients of all profiles are 
+// accumulated per segment, so that the expansions are evaluated only once per covariate.
+// With halfLength at most a quarter of the half width of the smallest window, the centre of an 
+// expanded segment is at least 5 halfLength away from the centroid, so that the terms of the 
+// expansion decrease at least as 5^(-n).
+
+namespace
+{
+    const int wingExpansionDegree = 12;
+
+
+    struct WingSegments
+    {
+        double firstCovariate;
+        double halfLength;
+        int Nsegments;                      // Zero if the profiles are to be evaluated exactly everywhere
+        vector<int> beginIndices;           // Index of the first covariate of each segment, followed by the number of covariates
+    };
+
+
+
+    WingSegments makeWingSegments(const RefArrayXd covariates, const double maxHalfLength)
+    {
+        const int Ncovariates = covariates.size();
+        const double range = covariates(Ncovariates-1) - covariates(0);
+
+        WingSegments segments;
+        segments.firstCovariate = covariates(0);
+        segments.halfLength = maxHalfLength;
+        segments.Nsegments = 0;
+
+
+        // Accumulating the coefficients of a profile costs wingExpansionDegree+1 operations per segment.
+        // If the segments contain fewer covariates than that, it is cheaper to evaluate the profiles exactly.
+
+        const double Nsegments = max(1.0, ceil(range / (2.0 * maxHalfLength)));
+
+        if (!(Nsegments * (wingExpansionDegree + 1) <= Ncovariates))
+        {
+            return segments;
+        }
+
+        segments.Nsegments = static_cast<int>(Nsegments);
+        segments.beginIndices.resize(segments.Nsegments + 1);
+        segments.beginIndices[0] = 0;
+        segments.beginIndices[segments.Nsegments] = Ncovariates;
+
+        const double *covariatesBegin = covariates.data();
+
+        for (int segment = 1; segment < segments.Nsegments; ++segment)
+        {
+            const double lowerBoundary = segments.firstCovariate + 2.0 * segment * segments.halfLength;
+            segments.beginIndices[segment] = lower_bound(covariatesBegin, covariatesBegin + Ncovariates, lowerBoundary) 
+                                             - covariatesBegin;
+        }
+
+        return segments;
+    }
+
+
+
+    double wingSegmentCentre(const WingSegments &segments, const int segment)
+    {
+        return segments.firstCovariate + (2.0 * segment + 1.0) * segments.halfLength;
+    }
+
+
+
+    // The segment containing value, -1 below the first segment and Nsegments above the last one
+
+    int findWingSegment(const WingSegments &segments, const double value)
+    {
+        const double position = floor((value - segments.firstCovariate) / (2.0 * segments.halfLength));
+
+        return static_cast<int>(max(-1.0, min(double(segments.Nsegments), position)));
+    }
+
+
+
+    // Adds a single profile to predictions in the segments that overlap with the window [lowerBound, upperBound],
+    // and calls addWingCoefficients(segment) for all other segments.
+
+    template <typename ProfileType, typename WingCoefficientsType>
+    void addWindowedProfile(RefArrayXd predictions, const RefArrayXd covariates, const WingSegments &segments,
+                            const double lowerBound, const double upperBound,
+                            const ProfileType &profile, const WingCoefficientsType &addWingCoefficients)
+    {
+        if (segments.Nsegments == 0)
+        {
+            for (int i = 0; i < covariates.size(); ++i)
+            {
+                predictions(i) += profile(covariates(i));
+            }
+
+            return;
+        }
+
+        const int lowerSegment = findWingSegment(segments, lowerBound);
+        const int upperSegment = findWingSegment(segments, upperBound);
+        const int beginIndex = segments.beginIndices[max(lowerSegment, 0)];
+        const int endIndex = segments.beginIndices[min(upperSegment + 1, segments.Nsegments)];
+
+        for (int i = beginIndex; i < endIndex; ++i)
+        {
+            predictions(i) += profile(covariates(i));
+        }
+
+        for (int segment = 0; segment < lowerSegment; ++segment)
+        {
+            addWingCoefficients(segment);
+        }
+
+        for (int segment = upperSegment + 1; segment < segments.Nsegments; ++segment)
+        {
+            addWingCoefficients(segment);
+        }
+    }
+
+
+
+    // Adds the polynomials sum_n coefficients(n, segment) * t^n to predictions, by Horner's scheme
+
+    void addWingExpansions(RefArrayXd predictions, const RefArrayXd covariates, const WingSegments &segments,
+                           const ArrayXXd &coefficients)
+    {
+        for (int segment = 0; segment < segments.Nsegments; ++segment)
+        {
+            const double centre = wingSegmentCentre(segments, segment);
+
+            for (int i = segments.beginIndices[segment]; i < segments.beginIndices[segment+1]; ++i)
+            {
+                const double t = (covariates(i) - centre) / segments.halfLength;
+                double value = coefficients(wingExpansionDegree, segment);
+
+                for (int n = wingExpansionDegree - 1; n >= 0; --n)
+                {
+                    value = value * t + coefficients(n, segment);
+                }
+
+                predictions(i) += value;
+            }
+        }
+    }
+
+
+
+    // Adds the real part of exp(i * frequency * (covariate - centre)) * sum_n coefficients(n, segment) * t^n
+    // to predictions, by Horner's scheme
+
+    void addOscillatingWingExpansions(RefArrayXd predictions, const RefArrayXd covariates, const WingSegments &segments,
+                                      const Eigen::ArrayXXcd &coefficients, const double frequency)
+    {
+        for (int segment = 0; segment < segments.Nsegments; ++segment)
+        {
+            const double centre = wingSegmentCentre(segments, segment);
+
+            for (int i = segments.beginIndices[segment]; i < segments.beginIndices[segment+1]; ++i)
+            {
+                const double t = (covariates(i) - centre) / segments.halfLength;
+                complex<double> value = coefficients(wingExpansionDegree, segment);
+
+                for (int n = wingExpansionDegree - 1; n >= 0; --n)
+                {
+                    value = value * t + coefficients(n, segment);
+                }
+
+                predictions(i) += (value * polar(1.0, frequency * (covariates(i) - centre))).real();
+            }
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+
+// Functions::modeProfilesWindowed()
+//
+// PURPOSE: 
+//      Adds a set of Lorentzian profiles that model oscillation modes in a power spectrum.
+//      Each profile is computed given its centroid, height and linewidth. It is evaluated exactly
+//      within a window of +/- windowWidth linewidths around its centroid, and by a series 
+//      expansion of its wings outside the window.
+//
+// INPUT:
+//      predictions : vector to which the profiles are added
+//      covariates : vector containing independent variable values, sorted in ascending order
+//      centroids : centroids of the Lorentzian profiles, expressed in muHz
+//      heights : heights of the Lorentzian profiles, expressed in ppm^2 / muHz
+//      linewidths : widths of the Lorentzian profiles (mode linewidths), expressed in muHz
+//      windowWidth : half width of the window in which each profile is evaluated exactly, 
+//                    expressed in units of its linewidth (default = 50)
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Contrary to modeProfile(), the profiles are added to the input vector predictions, 
+//      which therefore needs to be initialized by the caller.
+//      Outside its window, each profile is expanded to degree 12 around the centres of segments 
+//      of the covariates, whose half length is a quarter of the smallest half window. With 
+//      H / (1 + z^2) = H Im(1 / (z - i)), the expansion is a geometric series of ratio at most 1/5, 
+//      and the relative error on the wing of each profile is about degree * 5^-(degree + 1), 
+//      i.e. below 2e-8 for windowWidth >= 1 (see demoWindowedModeProfiles.cpp).
+//      The cost is proportional to the number of covariates times the degree, plus the number of 
+//      modes times the number of covariates in a window plus the number of segments times the degree, 
+//      rather than to the number of modes times the number of covariates.
+//
+
+void Functions::modeProfilesWindowed(RefArrayXd predictions, const RefArrayXd covariates, const RefArrayXd centroids, 
+                                     const RefArrayXd heights, const RefArrayXd linewidths, const double windowWidth)
+{
+    assert(predictions.size() == covariates.size());
+    assert((centroids.size() == heights.size()) && (centroids.size() == linewidths.size()));
+    assert(windowWidth > 0.0);
+
+    if (centroids.size() == 0) return;
+
+    WingSegments segments = makeWingSegments(covariates, 0.25 * windowWidth * linewidths.minCoeff());
+    ArrayXXd wingCoefficients = ArrayXXd::Zero(wingExpansionDegree + 1, segments.Nsegments);
+
+    for (int mode = 0; mode < centroids.size(); ++mode)
+    {
+        const double centroid = centroids(mode);
+        const double height = heights(mode);
+        const double halfLinewidth = 0.5 * linewidths(mode);
+        const double halfWindow = windowWidth * linewidths(mode);
+
+
+        auto profile = [=] (double covariate) 
+        {
+            const double distance = (covariate - centroid) / halfLinewidth;
+            return height / (1.0 + distance * distance);
+        };
+
+
+        // With w = (covariate - centroid) / halfLinewidth - i = w0 + kappa t, the profile is
+        // height Im(1/w) = height Im(sum_n (-kappa t)^n / w0^(n+1))
+
+        auto addWingCoefficients = [&] (int segment)
+        {
+            const complex<double> w0((wingSegmentCentre(segments, segment) - centroid) / halfLinewidth, -1.0);
+            const complex<double> ratio = -(segments.halfLength / halfLinewidth) / w0;
+            complex<double> term = 1.0 / w0;
+
+            for (int n = 0; n <= wingExpansionDegree; ++n)
+            {
+                wingCoefficients(n, segment) += height * term.imag();
+                term *= ratio;
+            }
+        };
+
+        addWindowedProfile(predictions, covariates, segments, centroid - halfWindow, centroid + halfWindow, 
+                           profile, addWingCoefficients);
+    }
+
+    addWingExpansions(predictions, covariates, segments, wingCoefficients);
+}
+
+
+
+
+
+
+
+
+
+
+
+// Functions::modeProfilesWithAmplitudeWindowed()
+//
+// PURPOSE: 
+//      Adds a set of Lorentzian profiles that model oscillation modes in a power spectrum,
+//      computed given their centroids, amplitudes and linewidths. Each profile is only evaluated
+//      exactly within a window of +/- windowWidth linewidths around its centroid (see modeProfilesWindowed()).
+//
+// INPUT:
+//      predictions : vector to which the profiles are added
+//      covariates : vector containing independent variable values, sorted in ascending order
+//      centroids : centroids of the Lorentzian profiles, expressed in muHz
+//      amplitudes : amplitudes of the Lorentzian profiles, expressed in ppm
+//      linewidths : widths of the Lorentzian profiles (mode linewidths), expressed in muHz
+//      windowWidth : half width of the window in which each profile is evaluated exactly, 
+//                    expressed in units of its linewidth (default = 50)
+//
+// OUTPUT:
+//      void
+//
+
+void Functions::modeProfilesWithAmplitudeWindowed(RefArrayXd predictions, const RefArrayXd covariates, const RefArrayXd centroids, 
+                                                  const RefArrayXd amplitudes, const RefArrayXd linewidths, const double windowWidth)
+{
+    assert(centroids.size() == amplitudes.size());
+
+    ArrayXd heights = amplitudes.square() / (Functions::PI * linewidths);
+
+    modeProfilesWindowed(predictions, covariates, centroids, heights, linewidths, windowWidth);
+}
+
+
+
+
+
+
+
+
+
+
+
+// Functions::modeProfilesSincWindowed()
+//
+// PURPOSE: 
+//      Adds a set of sinc-square profiles that model unresolved oscillation modes in a power spectrum.
+//      Each profile is computed given its centroid and height, and the resolution of the dataset. It is 
+//      evaluated exactly within a window of +/- windowWidth resolutions around its centroid, and by a 
+//      series expansion of its wings outside the window.
+//
+// INPUT:
+//      predictions : vector to which the profiles are added
+//      covariates : vector containing independent variable values, sorted in ascending order
+//      centroids : centroids of the sinc-square profiles, expressed in muHz
+//      heights : heights of the sinc-square profiles, expressed in ppm^2 / muHz
+//      resolution : the distance from the centroid to the first zero of the sinc-square, expressed in muHz
+//      windowWidth : half width of the window in which each profile is evaluated exactly, 
+//                    expressed in units of the resolution (default = 50)
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The profiles are added to the input vector predictions. 
+//      At the centroid itself, where sin(x)/x is undefined, the limit value 1 is used.
+//      In the wings, the profile is written as H (1 - cos(2 s d)) / (2 s^2 d^2), with s = pi / resolution 
+//      and d = covariate - centroid, and 1 / d^2 is expanded to degree 12 around the centres of segments 
+//      of the covariates, whose half length is a quarter of the half window (see modeProfilesWindowed()). 
+//      The oscillation cos(2 s d) itself is evaluated exactly for each covariate, so that no average of
+//      the squared sine is involved. The error on the wing of each profile is below 3e-8 times its envelope 
+//      H / (s d)^2 (see demoWindowedModeProfiles.cpp).
+//
+
+void Functions::modeProfilesSincWindowed(RefArrayXd predictions, const RefArrayXd covariates, const RefArrayXd centroids, 
+                                         const RefArrayXd heights, const double resolution, const double windowWidth)
+{
+    assert(predictions.size() == covariates.size());
+    assert(centroids.size() == heights.size());
+    assert(windowWidth >= 1.0);
+
+    if (centroids.size() == 0) return;
+
+    const double scale = Functions::PI / resolution;
+    const double halfWindow = windowWidth * resolution;
+
+    WingSegments segments = makeWingSegments(covariates, 0.25 * halfWindow);
+    ArrayXXd wingCoefficients = ArrayXXd::Zero(wingExpansionDegree + 1, segments.Nsegments);
+    Eigen::ArrayXXcd oscillatingWingCoefficients = Eigen::ArrayXXcd::Zero(wingExpansionDegree + 1, segments.Nsegments);
+
+    for (int mode = 0; mode < centroids.size(); ++mode)
+    {
+        const double centroid = centroids(mode);
+        const double height = heights(mode);
+
+
+        auto profile = [=] (double covariate) 
+        {
+            const double sincFunctionArgument = scale * (covariate - centroid);
+
+            if (sincFunctionArgument == 0.0)
+            {
+                return height;
+            }
+            else
+            {
+                const double sincFunction = sin(sincFunctionArgument) / sincFunctionArgument;
+                return height * sincFunction * sincFunction;
+            }
+        };
+
+
+        // With d = d0 + halfLength t, 1/d^2 = sum_n (n+1) (-halfLength t / d0)^n / d0^2, and
+        // cos(2 s d) = Re(exp(2 i s d0) exp(2 i s halfLength t))
+
+        auto addWingCoefficients = [&] (int segment)
+        {
+            const double distance = wingSegmentCentre(segments, segment) - centroid;
+            const double ratio = -segments.halfLength / distance;
+            const complex<double> phase = polar(1.0, 2.0 * scale * distance);
+            double term = 0.5 * height / (scale * scale * distance * distance);
+
+            for (int n = 0; n <= wingExpansionDegree; ++n)
+            {
+                const double coefficient = (n + 1) * term;
+                wingCoefficients(n, segment) += coefficient;
+                oscillatingWingCoefficients(n, segment) -= coefficient * phase;
+                term *= ratio;
+            }
+        };
+
+        addWindowedProfile(predictions, covariates, segments, centroid - halfWindow, centroid + halfWindow, 
+                           profile, addWingCoefficients);
+    }
+
+    addWingExpansions(predictions, covariates, segments, wingCoefficients);
+    addOscillatingWingExpansions(predictions, covariates, segments, oscillatingWingCoefficients, 2.0 * scale);
+}
+
+
+
+
+
+
+
+
+
+
+
+
 // Functions::logGaussProfile()
 //
 // PURPOSE: 
@@ -472,6 +899,104 @@ double Functions::logExpDifference(const double x, const double y)
 
 
 
+// Functions::compensatedSum()
+//
+// PURPOSE:
+//      Sum the elements of a single precision array in double precision, using the
+//      compensated summation of Neumaier (1974), which is an improved version of the
+//      Kahan summation algorithm.
+//
+// INPUT:
+//      array: an Eigen array of floats
+//
+// OUTPUT:
+//      The sum of the elements of the array, as a double.
+//
+// REMARKS:
+//      The elements are first summed in double precision in blocks of consecutive elements,
+//      which can be vectorized, and the block sums are then added with compensation. 
+//      This keeps the rounding error of the total sum independent of the size of the array.
+//
+
+double Functions::compensatedSum(RefArrayXf const array)
+{
+    const int blockSize = 256;
+    double sum = 0.0;
+    double compensation = 0.0;
+
+    for (int beginIndex = 0; beginIndex < array.size(); beginIndex += blockSize)
+    {
+        const int length = min(blockSize, int(array.size()) - beginIndex);
+        const double blockSum = array.segment(beginIndex, length).cast<double>().sum();
+        const double newSum = sum + blockSum;
+
+
+        // Keep track of the low-order bits lost in the addition
+
+        if (fabs(sum) >= fabs(blockSum))
+        {
+            compensation += (sum - newSum) + blockSum;
+        }
+        else
+        {
+            compensation += (blockSum - newSum) + sum;
+        }
+
+        sum = newSum;
+    }
+
+    return sum + compensation;
+}
+
+
+
+
+
+
+
+
+
+
+
+// Functions::fnv1aHash()
+//
+// PURPOSE:
+//      Compute the 64-bit FNV-1a hash of a block of bytes.
+//
+// INPUT:
+//      data: pointer to the first byte
+//      Nbytes: the number of bytes to hash
+//      initialHash: the hash to start from. By passing the hash of a previous block, 
+//                   several blocks can be hashed as if they were contiguous.
+//
+// OUTPUT:
+//      The hash value.
+//
+
+unsigned long long Functions::fnv1aHash(const void *data, const size_t Nbytes, const unsigned long long initialHash)
+{
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    unsigned long long hash = initialHash;
+
+    for (size_t i = 0; i < Nbytes; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+
+
+
+
+
+
+
+
+
+
 // Functions::topDownMerge()
 //
 // PURPOSE: 
@@ -783,6 +1308,103 @@ vector<int> Functions::findArrayIndicesWithinBoundaries(RefArrayXd const array,
 
 
 
+// Functions::findSortedArrayIndicesWithinBoundaries()
+//
+// PURPOSE: 
+//      Find the range of indices of an array sorted in ascending order, whose elements
+//      fall within the input boundaries.
+//
+// INPUT:
+//      array:       an Eigen array sorted in ascending order
+//      lowerBound:  a double specifying the smallest value allowed in the search
+//      upperBound:  a double specifying the largest value allowed in the search
+//      beginIndex:  an integer to contain the index of the first element >= lowerBound
+//      endIndex:    an integer to contain the index of the first element > upperBound
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The elements array(beginIndex), ..., array(endIndex-1) fall within the boundaries.
+//      If no element falls within the boundaries, beginIndex = endIndex.
+//      For uniformly spaced arrays (e.g. frequency grids) the indices are found by index
+//      arithmetic and a few steps of correction. For other arrays a binary search is used.
+//
+
+void Functions::findSortedArrayIndicesWithinBoundaries(RefArrayXd const array, double lowerBound, double upperBound,
+                                                       int &beginIndex, int &endIndex)
+{
+    const int Nelements = array.size();
+    const int maxNcorrectionSteps = 8;
+
+    assert(Nelements >= 1);
+
+    if ((lowerBound > upperBound) || (upperBound < array(0)) || (lowerBound > array(Nelements-1)))
+    {
+        beginIndex = endIndex = 0;
+        return;
+    }
+
+    if (Nelements == 1)
+    {
+        beginIndex = 0;
+        endIndex = 1;
+        return;
+    }
+
+
+    // Guess the indices assuming a uniform spacing, and correct them by stepping
+    // through the array. If the array turns out not to be uniformly spaced, fall
+    // back on a binary search.
+
+    const double spacing = (array(Nelements-1) - array(0)) / (Nelements - 1);
+
+    auto findFirstIndexAbove = [&] (double bound, bool boundIsIncluded) -> int
+    {
+        double position = ceil((bound - array(0)) / spacing);
+        int index = static_cast<int>(max(0.0, min(double(Nelements), position)));
+
+        auto isAbove = [&] (int i) {return boundIsIncluded ? (array(i) >= bound) : (array(i) > bound);};
+
+        for (int step = 0; step < maxNcorrectionSteps; ++step)
+        {
+            if ((index > 0) && isAbove(index-1))
+            {
+                --index;
+            }
+            else if ((index < Nelements) && !isAbove(index))
+            {
+                ++index;
+            }
+            else
+            {
+                return index;
+            }
+        }
+
+        const double *arrayBegin = array.data();
+        const double *arrayEnd = array.data() + Nelements;
+
+        if (boundIsIncluded)
+            return lower_bound(arrayBegin, arrayEnd, bound) - arrayBegin;
+        else
+            return upper_bound(arrayBegin, arrayEnd, bound) - arrayBegin;
+    };
+
+    beginIndex = findFirstIndexAbove(lowerBound, true);
+    endIndex = findFirstIndexAbove(upperBound, false);
+}
+
+
+
+
+
+
+
+
+
+
+
 // Functions::countArrayIndicesWithinBoundaries()
 //
 // PURPOSE: 
@@ -1014,3 +1636,53 @@ ArrayXd Functions::cubicSplineInterpolation(RefArrayXd const observedAbscissa, R
 
     return interpolatedOrdinate;
 }
+
+
+
+
+
+
+
+
+
+
+// Functions::rebinSpectrum()
+//
+// PURPOSE:
+//      Average a power spectrum over groups of Nbins consecutive frequency bins, to be
+//      used with the GammaLikelihood (see GammaLikelihood.h).
+//
+// INPUT:
+//      frequencies: an Eigen array containing the frequencies of the spectrum, in ascending order
+//      spectrum: an Eigen array containing the power of the spectrum at each frequency
+//      Nbins: the number of consecutive frequency bins averaged into a single bin
+//      rebinnedFrequencies: on output, the mean frequency of each group of Nbins bins
+//      rebinnedSpectrum: on output, the mean power of each group of Nbins bins
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The last bins are dropped if their number is smaller than Nbins, so that all
+//      rebinned values follow the same distribution. The spectrum should be sampled at
+//      independent frequencies (no oversampling), and the model should vary little
+//      within a group of Nbins bins, as it is only evaluated at their mean frequency.
+//
+
+void Functions::rebinSpectrum(RefArrayXd const frequencies, RefArrayXd const spectrum, const int Nbins,
+                              ArrayXd &rebinnedFrequencies, ArrayXd &rebinnedSpectrum)
+{
+    assert(frequencies.size() == spectrum.size());
+    assert(Nbins >= 1);
+
+    const int NrebinnedBins = spectrum.size() / Nbins;
+
+    rebinnedFrequencies.resize(NrebinnedBins);
+    rebinnedSpectrum.resize(NrebinnedBins);
+
+    for (int i = 0; i < NrebinnedBins; ++i)
+    {
+        rebinnedFrequencies(i) = frequencies.segment(i*Nbins, Nbins).mean();
+        rebinnedSpectrum(i) = spectrum.segment(i*Nbins, Nbins).mean();
+    }
+}
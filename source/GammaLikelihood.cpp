@@ -0,0 +1,219 @@
+#include "GammaLikelihood.h"
+
+
+// GammaLikelihood::GammaLikelihood()
+//
+// PURPOSE:
+//      Derived class constructor.
+//
+// INPUT:
+//      observations: array containing the power spectrum averaged over Nbins
+//                    consecutive frequency bins (see Functions::rebinSpectrum())
+//      model: object specifying the model to be used. Its covariates are the
+//             mean frequencies of the averaged bins.
+//      Nbins: number of frequency bins averaged into each observation
+//
+
+GammaLikelihood::GammaLikelihood(const RefArrayXd observations, Model &model, const int Nbins)
+: Likelihood(observations, model),
+  Nbins(Nbins)
+{
+    refuseLinearParameters("GammaLikelihood");
+
+    assert(Nbins >= 1);
+
+
+    // The terms of the log-likelihood that only depend on the data are computed once
+
+    const int Nobservations = observations.size();
+
+    normalizationConstant = Nobservations * (Nbins * log(double(Nbins)) - lgamma(double(Nbins)))
+                            + (Nbins - 1.0) * observations.log().sum();
+
+
+    // The term -Nbins * (log(prediction) + observation/prediction) is maximal for prediction = observation.
+    // The upper bounds of the terms are summed per segment, for logValue() with a threshold.
+
+    const int Nsegments = (Nobservations + segmentSize - 1) / segmentSize;
+
+    remainingUpperBounds = ArrayXd::Zero(Nsegments + 1);
+
+    for (int segment = Nsegments-1; segment >= 0; --segment)
+    {
+        const int beginIndex = segment * segmentSize;
+        const int length = min(segmentSize, Nobservations - beginIndex);
+
+        remainingUpperBounds(segment) = remainingUpperBounds(segment + 1)
+                                        - Nbins * (observations.segment(beginIndex, length).log() + 1.0).sum();
+    }
+}
+
+
+
+
+
+
+
+
+
+// GammaLikelihood::~GammaLikelihood()
+//
+// PURPOSE:
+//      Derived class destructor.
+//
+
+GammaLikelihood::~GammaLikelihood()
+{
+}
+
+
+
+
+
+
+
+
+
+
+// GammaLikelihood::fingerprint()
+//
+// PURPOSE:
+//      Compute a hash of everything the log-likelihood values depend on,
+//      apart from the free parameters (see Likelihood::fingerprint()).
+//
+// OUTPUT:
+//      The hash of the base class, combined with the number of averaged bins.
+//
+
+unsigned long long GammaLikelihood::fingerprint()
+{
+    unsigned long long hash = Likelihood::fingerprint();
+    hash = Functions::fnv1aHash(&Nbins, sizeof(int), hash);
+
+    return hash;
+}
+
+
+
+
+
+
+
+
+
+// GammaLikelihood::getNbins()
+//
+// PURPOSE:
+//      Get private data member Nbins.
+//
+// OUTPUT:
+//      The number of frequency bins averaged into each observation.
+//
+
+int GammaLikelihood::getNbins()
+{
+    return Nbins;
+}
+
+
+
+
+
+
+
+
+
+// GammaLikelihood::logValue()
+//
+// PURPOSE:
+//      Compute the natural logarithm of the gamma likelihood, which is
+//      a generalized chi-square distribution with 2*Nbins d.o.f.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//      values of the free parameters that describe the model.
+//
+// OUTPUT:
+//      a double number containing the natural logarithm of the
+//      gamma likelihood
+//
+// REMARKS:
+//      The probability density of the mean P of Nbins exponentially distributed
+//      powers with mean S is
+//          p(P|S) = Nbins^Nbins / Gamma(Nbins) * P^(Nbins-1) / S^Nbins * exp(-Nbins * P/S)
+//      The log-likelihood is therefore Nbins times the one of the ExponentialLikelihood,
+//      plus a constant. Averaging reduces the number of terms by a factor Nbins, while the
+//      only approximation is that the model is evaluated at the mean frequency of the bins.
+//      The terms are summed per segment of observations (see Likelihood::sumOverSegments()),
+//      with or without threads, so that the result does not depend on the number of threads.
+//
+
+double GammaLikelihood::logValue(RefArrayXd const modelParameters)
+{
+    if (singlePrecisionIsUsed)
+    {
+        ArrayXf &predictions = getSinglePrecisionPredictionsWorkspace();
+
+        predictions.setZero();
+        model.predictSinglePrecision(predictions, modelParameters);
+        predictions = predictions.log() + observationsSinglePrecision / predictions;
+
+        return normalizationConstant - Nbins * Functions::compensatedSum(predictions);
+    }
+
+    auto sumOfTerms = [this](const int beginIndex, RefArrayXd predictions)
+    {
+        return (predictions.log() + observations.segment(beginIndex, predictions.size()) / predictions).sum();
+    };
+
+    return normalizationConstant - Nbins * sumOverSegments(modelParameters, sumOfTerms);
+}
+
+
+
+
+
+
+
+
+
+// GammaLikelihood::logValue()
+//
+// PURPOSE:
+//      Compute the natural logarithm of the gamma likelihood, but stop as
+//      soon as it is certain to be below a given threshold.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//                       values of the free parameters that describe the model.
+//      logLikelihoodThreshold: the value below which the exact log-likelihood is not needed
+//
+// OUTPUT:
+//      The natural logarithm of the gamma likelihood if it is at least logLikelihoodThreshold,
+//      otherwise an upper bound of it that is smaller than logLikelihoodThreshold.
+//
+// REMARKS:
+//      Each term -Nbins * (log(prediction) + observation/prediction) is at most
+//      -Nbins * (log(observation) + 1), as for the ExponentialLikelihood.
+//      In single precision mode, or with several threads, the exact value is always computed.
+//
+
+double GammaLikelihood::logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold)
+{
+    if (singlePrecisionIsUsed || (getNthreads() > 1))
+    {
+        return logValue(modelParameters);
+    }
+
+    auto sumOfTerms = [this](const int beginIndex, RefArrayXd predictions)
+    {
+        return Nbins * (predictions.log() + observations.segment(beginIndex, predictions.size()) / predictions).sum();
+    };
+
+    auto upperBound = [this](const int NsegmentsDone, const double partialSum)
+    {
+        return normalizationConstant + remainingUpperBounds(NsegmentsDone) - partialSum;
+    };
+
+    return boundedSumOverSegments(modelParameters, logLikelihoodThreshold, sumOfTerms, upperBound);
+}
@@ -0,0 +1,615 @@
+#include "GaussianProcessSurrogate.h"
+
+
+
+// GaussianProcessSurrogate::GaussianProcessSurrogate()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      Ndimensions: number of dimensions of the parameter space
+//      maxNtrainingPoints: maximum number of training points. When it is reached, the oldest 
+//                          quarter of the training points is dropped. This keeps the surrogate
+//                          focused on the region of the current likelihood constraint, and bounds
+//                          the cost of refitting, which scales as maxNtrainingPoints^3.
+//      kappa: initial number of standard deviations above the predicted mean used as upper
+//             confidence bound of the log-likelihood.
+//      maxFalseRejectionRate: maximum fraction of skipped points that would have fulfilled the
+//                             likelihood constraint. When the audited rate exceeds this value,
+//                             kappa is increased.
+//      auditFraction: fraction of the points predicted to be below the constraint, that are
+//                     evaluated anyway to estimate the false rejection rate.
+//      minNtrainingPoints: no point is skipped before the surrogate has this many training points.
+//
+
+GaussianProcessSurrogate::GaussianProcessSurrogate(const int Ndimensions, const int maxNtrainingPoints, const double kappa,
+                                                   const double maxFalseRejectionRate, const double auditFraction,
+                                                   const int minNtrainingPoints)
+: Ndimensions(Ndimensions),
+  maxNtrainingPoints(maxNtrainingPoints),
+  minNtrainingPoints(minNtrainingPoints),
+  kappa(kappa),
+  maxFalseRejectionRate(maxFalseRejectionRate),
+  auditFraction(auditFraction),
+  Ntraining(0),
+  NpointsSinceRefit(0),
+  auditIsPending(false),
+  NskippedPoints(0),
+  Naudits(0),
+  NfalseRejections(0),
+  totalNaudits(0),
+  totalNfalseRejections(0),
+  signalVariance(1.0),
+  noiseVariance(1.e-6),
+  meanValue(0.0),
+  fitIsValid(false),
+  uniform(0.0, 1.0)
+{
+    assert(Ndimensions > 0);
+    assert(minNtrainingPoints > 1);
+    assert(maxNtrainingPoints >= 2 * minNtrainingPoints);
+    assert((auditFraction > 0.0) && (auditFraction <= 1.0));
+
+    trainingPoints = MatrixXd::Zero(Ndimensions, maxNtrainingPoints);
+    trainingValues = VectorXd::Zero(maxNtrainingPoints);
+    lengthScales = VectorXd::Ones(Ndimensions);
+    choleskyFactor = MatrixXd::Zero(maxNtrainingPoints, maxNtrainingPoints);
+    weights = VectorXd::Zero(maxNtrainingPoints);
+
+
+    // Take an independent stream of random numbers, derived from the seed of the run
+
+    engine = RandomStreams::getNextStream("GaussianProcessSurrogate");
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::~GaussianProcessSurrogate()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+GaussianProcessSurrogate::~GaussianProcessSurrogate()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::pointCanBeSkipped()
+//
+// PURPOSE:
+//      Decide whether the evaluation of the likelihood of a candidate point can be
+//      skipped, because the upper confidence bound of its log-likelihood predicted 
+//      by the surrogate is below the likelihood constraint.
+//
+// INPUT:
+//      point: coordinates of the candidate point
+//      logLikelihoodThreshold: the log-likelihood that the point should exceed
+//
+// OUTPUT:
+//      True if the point can be rejected without evaluating its likelihood. 
+//
+// REMARKS:
+//      A random fraction auditFraction of the points that could be skipped is 
+//      not skipped. Their log-likelihood should be passed to addEvaluatedPoint(),
+//      which uses them to estimate the false rejection rate. A point whose predicted
+//      mean or variance is not finite is never skipped.
+//
+
+bool GaussianProcessSurrogate::pointCanBeSkipped(RefArrayXd const point, const double logLikelihoodThreshold)
+{
+    auditIsPending = false;
+
+    if (Ntraining < minNtrainingPoints)
+    {
+        return false;
+    }
+
+    double mean;
+    double variance;
+
+    predict(point, mean, variance);
+
+    if (!std::isfinite(mean) || !std::isfinite(variance) || (mean + kappa * sqrt(variance) >= logLikelihoodThreshold))
+    {
+        return false;
+    }
+
+    if (uniform(engine) < auditFraction)
+    {
+        auditIsPending = true;
+        return false;
+    }
+
+    NskippedPoints++;
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::addEvaluatedPoint()
+//
+// PURPOSE:
+//      Add a point with an evaluated log-likelihood to the training points, and
+//      update the false rejection statistics if the point was an audit.
+//
+// INPUT:
+//      point: coordinates of the point
+//      logLikelihood: the log-likelihood of the point. Values below logLikelihoodThreshold
+//                     may be upper bounds of the log-likelihood (see Likelihood::logValue()),
+//                     which only makes the surrogate more conservative.
+//      logLikelihoodThreshold: the likelihood constraint that the point had to fulfill
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The Cholesky factor of the kernel matrix is extended with one row for each new point.
+//      The hyperparameters are only refitted when the number of training points has grown
+//      by 20% since the last refit, or when old training points are dropped.
+//
+
+void GaussianProcessSurrogate::addEvaluatedPoint(RefArrayXd const point, const double logLikelihood, const double logLikelihoodThreshold)
+{
+    if (auditIsPending)
+    {
+        auditIsPending = false;
+        Naudits++;
+        totalNaudits++;
+
+        if (logLikelihood >= logLikelihoodThreshold)
+        {
+            NfalseRejections++;
+            totalNfalseRejections++;
+
+
+            // The rate is estimated from the audits since the last increase of kappa
+
+            if (NfalseRejections > maxFalseRejectionRate * Naudits)
+            {
+                kappa += 1.0;
+                Naudits = 0;
+                NfalseRejections = 0;
+            }
+        }
+    }
+
+    if (!std::isfinite(logLikelihood)) return;
+
+
+    // Drop the oldest quarter of the training points if needed
+
+    bool refitIsNeeded = false;
+
+    if (Ntraining == maxNtrainingPoints)
+    {
+        const int Ndropped = maxNtrainingPoints / 4;
+        const int Nkept = Ntraining - Ndropped;
+
+        trainingPoints.leftCols(Nkept) = trainingPoints.block(0, Ndropped, Ndimensions, Nkept).eval();
+        trainingValues.head(Nkept) = trainingValues.segment(Ndropped, Nkept).eval();
+        Ntraining = Nkept;
+        refitIsNeeded = true;
+    }
+
+    trainingPoints.col(Ntraining) = point.matrix();
+    trainingValues(Ntraining) = logLikelihood;
+    Ntraining++;
+    NpointsSinceRefit++;
+
+    if (Ntraining < minNtrainingPoints) return;
+
+    if (refitIsNeeded || (Ntraining == minNtrainingPoints) || (NpointsSinceRefit >= max(10, Ntraining / 5)))
+    {
+        refit();
+    }
+    else
+    {
+        appendToFit();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::predict()
+//
+// PURPOSE:
+//      Compute the mean and variance of the Gaussian process at a given point.
+//
+// INPUT:
+//      point: coordinates of the point
+//      mean: the predicted log-likelihood
+//      variance: the variance of the prediction
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      As long as there are too few training points, or the kernel matrix could
+//      not be factorized, the variance is infinite.
+//
+
+void GaussianProcessSurrogate::predict(RefArrayXd const point, double &mean, double &variance)
+{
+    if ((Ntraining < minNtrainingPoints) || !fitIsValid)
+    {
+        mean = meanValue;
+        variance = numeric_limits<double>::infinity();
+        return;
+    }
+
+    VectorXd coordinates = point.matrix();
+    VectorXd covariances(Ntraining);
+
+    for (int n = 0; n < Ntraining; ++n)
+    {
+        covariances(n) = kernel(coordinates, trainingPoints.col(n));
+    }
+
+    mean = meanValue + covariances.dot(weights.head(Ntraining));
+
+    choleskyFactor.topLeftCorner(Ntraining, Ntraining).triangularView<Lower>().solveInPlace(covariances);
+    variance = max(signalVariance + noiseVariance - covariances.squaredNorm(), noiseVariance);
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::getNtrainingPoints()
+//
+// PURPOSE:
+//      Get private data member Ntraining.
+//
+// OUTPUT:
+//      The current number of training points.
+//
+
+int GaussianProcessSurrogate::getNtrainingPoints()
+{
+    return Ntraining;
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::getKappa()
+//
+// PURPOSE:
+//      Get private data member kappa.
+//
+// OUTPUT:
+//      The current number of standard deviations used in the upper confidence bound.
+//
+
+double GaussianProcessSurrogate::getKappa()
+{
+    return kappa;
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::getNskippedPoints()
+//
+// PURPOSE:
+//      Get private data member NskippedPoints.
+//
+// OUTPUT:
+//      The number of points for which the evaluation of the likelihood was skipped.
+//
+
+unsigned long GaussianProcessSurrogate::getNskippedPoints()
+{
+    return NskippedPoints;
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::getNaudits()
+//
+// PURPOSE:
+//      Get private data member totalNaudits.
+//
+// OUTPUT:
+//      The number of points that could have been skipped, but were evaluated to
+//      estimate the false rejection rate.
+//
+
+unsigned long GaussianProcessSurrogate::getNaudits()
+{
+    return totalNaudits;
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::getNfalseRejections()
+//
+// PURPOSE:
+//      Get private data member totalNfalseRejections.
+//
+// OUTPUT:
+//      The number of audited points that did fulfill the likelihood constraint.
+//
+
+unsigned long GaussianProcessSurrogate::getNfalseRejections()
+{
+    return totalNfalseRejections;
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::getFalseRejectionRate()
+//
+// PURPOSE:
+//      Estimate the fraction of the skipped points that would have fulfilled the
+//      likelihood constraint, from all audits so far.
+//
+// OUTPUT:
+//      The estimated false rejection rate, or zero if no audit was done.
+//
+
+double GaussianProcessSurrogate::getFalseRejectionRate()
+{
+    if (totalNaudits == 0) return 0.0;
+
+    return double(totalNfalseRejections) / totalNaudits;
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::kernel()
+//
+// PURPOSE:
+//      Compute the squared exponential covariance between two points.
+//
+// INPUT:
+//      point1: coordinates of the first point
+//      point2: coordinates of the second point
+//
+// OUTPUT:
+//      The covariance of the Gaussian process between both points.
+//
+
+double GaussianProcessSurrogate::kernel(const VectorXd &point1, const VectorXd &point2)
+{
+    double squaredDistance = ((point1 - point2).array() / lengthScales.array()).square().sum();
+
+    return signalVariance * exp(-0.5 * squaredDistance);
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::refit()
+//
+// PURPOSE:
+//      Set the hyperparameters from the training points, and compute the Cholesky
+//      factor of the kernel matrix and the weights of the training points.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The hyperparameters are not optimized, but derived from the training sample:
+//      the mean and variance of the Gaussian process are those of the training values,
+//      and the length scale along each coordinate is the standard deviation of the 
+//      training points along that coordinate, scaled with Silverman's rule of thumb.
+//      If the kernel matrix is not numerically positive definite, the noise variance
+//      (the jitter on its diagonal) is increased tenfold, up to the signal variance.
+//      If it still cannot be factorized, the fit is marked as invalid, and no point
+//      is skipped until the next refit.
+//
+
+void GaussianProcessSurrogate::refit()
+{
+    const int n = Ntraining;
+    auto points = trainingPoints.leftCols(n);
+    auto values = trainingValues.head(n);
+
+    meanValue = values.mean();
+    signalVariance = max((values.array() - meanValue).square().mean(), 1.e-12);
+    noiseVariance = 1.e-6 * signalVariance;
+
+    VectorXd meanPoint = points.rowwise().mean();
+    double scaleFactor = pow(4.0 / (Ndimensions + 2.0), 1.0 / (Ndimensions + 4.0)) * pow(n, -1.0 / (Ndimensions + 4.0));
+
+    for (int i = 0; i < Ndimensions; ++i)
+    {
+        double standardDeviation = sqrt((points.row(i).array() - meanPoint(i)).square().mean());
+        lengthScales(i) = max(standardDeviation * scaleFactor, 1.e-12);
+    }
+
+
+    // Kernel matrix and its Cholesky decomposition
+
+    MatrixXd kernelMatrix(n, n);
+
+    for (int j = 0; j < n; ++j)
+    {
+        kernelMatrix(j, j) = signalVariance;
+
+        for (int i = j+1; i < n; ++i)
+        {
+            kernelMatrix(i, j) = kernel(points.col(i), points.col(j));
+            kernelMatrix(j, i) = kernelMatrix(i, j);
+        }
+    }
+
+    LLT<MatrixXd> cholesky;
+    NpointsSinceRefit = 0;
+    fitIsValid = false;
+
+    for (; noiseVariance <= signalVariance; noiseVariance *= 10.0)
+    {
+        kernelMatrix.diagonal().setConstant(signalVariance + noiseVariance);
+        cholesky.compute(kernelMatrix);
+
+        if (cholesky.info() == Eigen::Success) 
+        {
+            fitIsValid = true;
+            break;
+        }
+    }
+
+    if (!fitIsValid) return;
+
+    choleskyFactor.topLeftCorner(n, n) = cholesky.matrixL();
+    weights.head(n) = cholesky.solve(values - VectorXd::Constant(n, meanValue));
+
+    fitIsValid = weights.head(n).allFinite();
+}
+
+
+
+
+
+
+
+
+
+
+
+// GaussianProcessSurrogate::appendToFit()
+//
+// PURPOSE:
+//      Extend the Cholesky factor of the kernel matrix with the last training point, 
+//      keeping the hyperparameters fixed, and update the weights of the training points.
+//
+// OUTPUT:
+//      void
+//
+
+void GaussianProcessSurrogate::appendToFit()
+{
+    if (!fitIsValid)
+    {
+        refit();
+        return;
+    }
+
+    const int m = Ntraining - 1;
+    VectorXd covariances(m);
+
+    for (int n = 0; n < m; ++n)
+    {
+        covariances(n) = kernel(trainingPoints.col(m), trainingPoints.col(n));
+    }
+
+    auto factor = choleskyFactor.topLeftCorner(m, m).triangularView<Lower>();
+    factor.solveInPlace(covariances);
+
+    double squaredDiagonal = signalVariance + noiseVariance - covariances.squaredNorm();
+
+    if (squaredDiagonal <= noiseVariance * 1.e-3)
+    {
+        // The new point is (numerically) a duplicate of the training points, start from scratch
+
+        refit();
+        return;
+    }
+
+    choleskyFactor.block(m, 0, 1, m) = covariances.transpose();
+    choleskyFactor(m, m) = sqrt(squaredDiagonal);
+
+    auto fullFactor = choleskyFactor.topLeftCorner(Ntraining, Ntraining).triangularView<Lower>();
+    VectorXd residuals = trainingValues.head(Ntraining) - VectorXd::Constant(Ntraining, meanValue);
+    fullFactor.solveInPlace(residuals);
+    fullFactor.transpose().solveInPlace(residuals);
+    weights.head(Ntraining) = residuals;
+}
@@ -0,0 +1,769 @@
+#include "KdTree.h"
+
+
+// KdTree::KdTree()
+//
+// PURPOSE:
+//      Constructor. Creates an empty tree. Points are added with build().
+//
+// INPUT:
+//      maxNpointsPerLeaf:              a node containing more points than this number is split
+//                                      in two when the tree is (re)built.
+//      maxFractionOfModifications:     the tree is only rebuilt when the number of replaced and
+//                                      removed points since the last (re)build exceeds this
+//                                      fraction of the total number of points (lazy rebalancing).
+//
+
+KdTree::KdTree(const int maxNpointsPerLeaf, const double maxFractionOfModifications)
+: Ndimensions(0),
+  Npoints(0),
+  maxNpointsPerLeaf(maxNpointsPerLeaf),
+  NmodificationsSinceRebalance(0),
+  maxFractionOfModifications(maxFractionOfModifications)
+{
+    assert(maxNpointsPerLeaf > 0);
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::~KdTree()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+KdTree::~KdTree()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::build()
+//
+// PURPOSE:
+//      Builds a balanced tree from scratch, for a given sample of points.
+//      The index of each point in the tree is its column index in the sample.
+//      Any points stored previously are discarded.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints):   the coordinates of the points to store in the tree
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::build(RefArrayXXd const sample)
+{
+    this->sample = sample;
+    Ndimensions = sample.rows();
+    Npoints = sample.cols();
+
+    rebalance();
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::rebalance()
+//
+// PURPOSE:
+//      Rebuilds a balanced tree from the points currently stored in it.
+//      Each node is split at the median coordinate along the direction
+//      of largest spread.
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::rebalance()
+{
+    nodes.clear();
+    nodes.reserve(2 * (Npoints / maxNpointsPerLeaf + 1));
+    leafOfPoint.resize(Npoints);
+
+    vector<int> pointIndices(Npoints);
+    iota(pointIndices.begin(), pointIndices.end(), 0);
+
+    buildSubtree(pointIndices, 0, Npoints);
+
+    NmodificationsSinceRebalance = 0;
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::buildSubtree()
+//
+// PURPOSE:
+//      Recursively builds the subtree containing the points
+//      pointIndices[beginIndex, ..., endIndex-1].
+//
+// INPUT:
+//      pointIndices:   the indices of all the points in the tree. The elements between
+//                      beginIndex and endIndex are reordered in place.
+//      beginIndex:     first element of pointIndices to be put in the subtree
+//      endIndex:       one past the last element of pointIndices to be put in the subtree
+//
+// OUTPUT:
+//      The index of the root node of the subtree.
+//
+
+int KdTree::buildSubtree(vector<int> &pointIndices, const int beginIndex, const int endIndex)
+{
+    int nodeIndex = nodes.size();
+    nodes.push_back(Node());
+    nodes[nodeIndex].splitDimension = -1;
+    nodes[nodeIndex].splitValue = 0.0;
+    nodes[nodeIndex].leftChild = -1;
+    nodes[nodeIndex].rightChild = -1;
+
+
+    // Find the coordinate along which the points have the largest spread
+
+    int splitDimension = 0;
+    double largestSpread = 0.0;
+
+    if (endIndex - beginIndex > maxNpointsPerLeaf)
+    {
+        for (int i = 0; i < Ndimensions; ++i)
+        {
+            double minimum = numeric_limits<double>::max();
+            double maximum = numeric_limits<double>::lowest();
+
+            for (int n = beginIndex; n < endIndex; ++n)
+            {
+                minimum = min(minimum, sample(i, pointIndices[n]));
+                maximum = max(maximum, sample(i, pointIndices[n]));
+            }
+
+            if (maximum - minimum > largestSpread)
+            {
+                largestSpread = maximum - minimum;
+                splitDimension = i;
+            }
+        }
+    }
+
+
+    // Small nodes become leaves. So do nodes whose points all coincide,
+    // because they cannot be split any further.
+
+    if ((endIndex - beginIndex <= maxNpointsPerLeaf) || (largestSpread == 0.0))
+    {
+        nodes[nodeIndex].pointIndices.assign(pointIndices.begin() + beginIndex, pointIndices.begin() + endIndex);
+
+        for (int n = beginIndex; n < endIndex; ++n)
+        {
+            leafOfPoint[pointIndices[n]] = nodeIndex;
+        }
+
+        return nodeIndex;
+    }
+
+
+    // Split at the median. Points with a coordinate equal to the split value
+    // may end up on either side, which is taken into account in the searches.
+
+    int middleIndex = beginIndex + (endIndex - beginIndex) / 2;
+    nth_element(pointIndices.begin() + beginIndex, pointIndices.begin() + middleIndex, pointIndices.begin() + endIndex,
+                [this, splitDimension] (int i, int j) {return sample(splitDimension, i) < sample(splitDimension, j);} );
+
+    double splitValue = sample(splitDimension, pointIndices[middleIndex]);
+
+    int leftChild = buildSubtree(pointIndices, beginIndex, middleIndex);
+    int rightChild = buildSubtree(pointIndices, middleIndex, endIndex);
+
+    nodes[nodeIndex].splitDimension = splitDimension;
+    nodes[nodeIndex].splitValue = splitValue;
+    nodes[nodeIndex].leftChild = leftChild;
+    nodes[nodeIndex].rightChild = rightChild;
+
+    return nodeIndex;
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::replacePoint()
+//
+// PURPOSE:
+//      Changes the coordinates of one point in the tree, e.g. when a live point
+//      is replaced by a newly drawn one. The point keeps its index.
+//
+// INPUT:
+//      pointIndex:         the index of the point to replace
+//      newCoordinates:     the new coordinates of the point
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::replacePoint(const int pointIndex, RefArrayXd const newCoordinates)
+{
+    assert((pointIndex >= 0) && (pointIndex < Npoints));
+    assert(newCoordinates.size() == Ndimensions);
+
+    detachPoint(pointIndex);
+    sample.col(pointIndex) = newCoordinates;
+    insertPoint(pointIndex);
+
+    NmodificationsSinceRebalance++;
+    rebalanceIfNeeded();
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::removePoint()
+//
+// PURPOSE:
+//      Removes one point from the tree. To keep the indices contiguous, the point
+//      with the largest index takes over the index of the removed point. This is the
+//      same convention as the one used by NestedSampler::removeLivePointsFromSample().
+//
+// INPUT:
+//      pointIndex:     the index of the point to remove
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::removePoint(const int pointIndex)
+{
+    assert((pointIndex >= 0) && (pointIndex < Npoints));
+
+    int lastIndex = Npoints - 1;
+
+    detachPoint(pointIndex);
+
+    if (pointIndex != lastIndex)
+    {
+        // Relabel the last point in its leaf, rather than reinserting it
+
+        vector<int> &pointIndicesOfLeaf = nodes[leafOfPoint[lastIndex]].pointIndices;
+        replace(pointIndicesOfLeaf.begin(), pointIndicesOfLeaf.end(), lastIndex, pointIndex);
+        leafOfPoint[pointIndex] = leafOfPoint[lastIndex];
+        sample.col(pointIndex) = sample.col(lastIndex);
+    }
+
+    sample.conservativeResize(Ndimensions, lastIndex);
+    leafOfPoint.pop_back();
+    Npoints--;
+
+    NmodificationsSinceRebalance++;
+    rebalanceIfNeeded();
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::insertPoint()
+//
+// PURPOSE:
+//      Adds the point with the given index to the leaf where it belongs.
+//      The leaf is not split, even if it becomes too large: this is only
+//      done when the tree is rebalanced.
+//
+// INPUT:
+//      pointIndex:     the index of a point whose coordinates are already stored in the sample
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::insertPoint(const int pointIndex)
+{
+    int nodeIndex = 0;
+
+    while (nodes[nodeIndex].splitDimension >= 0)
+    {
+        if (sample(nodes[nodeIndex].splitDimension, pointIndex) < nodes[nodeIndex].splitValue)
+            nodeIndex = nodes[nodeIndex].leftChild;
+        else
+            nodeIndex = nodes[nodeIndex].rightChild;
+    }
+
+    nodes[nodeIndex].pointIndices.push_back(pointIndex);
+    leafOfPoint[pointIndex] = nodeIndex;
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::detachPoint()
+//
+// PURPOSE:
+//      Removes the given point index from the leaf that contains it.
+//      The coordinates of the point are left untouched.
+//
+// INPUT:
+//      pointIndex:     the index of the point to detach
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::detachPoint(const int pointIndex)
+{
+    vector<int> &pointIndicesOfLeaf = nodes[leafOfPoint[pointIndex]].pointIndices;
+    auto position = find(pointIndicesOfLeaf.begin(), pointIndicesOfLeaf.end(), pointIndex);
+
+    assert(position != pointIndicesOfLeaf.end());
+
+    *position = pointIndicesOfLeaf.back();
+    pointIndicesOfLeaf.pop_back();
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::rebalanceIfNeeded()
+//
+// PURPOSE:
+//      Rebuilds the tree only when enough points were modified since
+//      the last (re)build. Between rebuilds leaves simply grow or shrink,
+//      which keeps the queries exact but gradually less efficient.
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::rebalanceIfNeeded()
+{
+    if (NmodificationsSinceRebalance > maxFractionOfModifications * Npoints)
+    {
+        rebalance();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::findNearestNeighbours()
+//
+// PURPOSE:
+//      Finds the Nneighbours points of the tree that are closest (in the Euclidean sense)
+//      to a given query point.
+//
+// INPUT:
+//      queryPoint:             coordinates of the query point
+//      Nneighbours:            number of neighbours to look for. If the tree contains less
+//                              points, all of them are returned.
+//      neighbourIndices:       will contain the indices of the neighbours, sorted by increasing distance
+//      neighbourDistances:     will contain the corresponding Euclidean distances
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      A point of the tree that coincides with the query point is also returned.
+//
+
+void KdTree::findNearestNeighbours(RefArrayXd const queryPoint, const int Nneighbours,
+                                   vector<int> &neighbourIndices, vector<double> &neighbourDistances)
+{
+    assert(queryPoint.size() == Ndimensions);
+
+    priority_queue<pair<double,int>> bestCandidates;        // Max-heap on the squared distance
+
+    if ((Npoints > 0) && (Nneighbours > 0))
+    {
+        searchNearestNeighbours(0, queryPoint, Nneighbours, bestCandidates);
+    }
+
+    int Nfound = bestCandidates.size();
+    neighbourIndices.resize(Nfound);
+    neighbourDistances.resize(Nfound);
+
+    for (int n = Nfound-1; n >= 0; --n)
+    {
+        neighbourDistances[n] = sqrt(bestCandidates.top().first);
+        neighbourIndices[n] = bestCandidates.top().second;
+        bestCandidates.pop();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::findNearestNeighbours()
+//
+// PURPOSE:
+//      Batch version of findNearestNeighbours() for a set of query points (overloaded).
+//
+// INPUT:
+//      queryPoints(Ndimensions, Nqueries):     coordinates of the query points
+//      Nneighbours:                            number of neighbours to look for
+//      neighbourIndices[Nqueries]:             for each query point the indices of its neighbours,
+//                                              sorted by increasing distance
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::findNearestNeighbours(RefArrayXXd queryPoints, const int Nneighbours,
+                                   vector<vector<int>> &neighbourIndices)
+{
+    int Nqueries = queryPoints.cols();
+    vector<double> neighbourDistances;
+    neighbourIndices.resize(Nqueries);
+
+    for (int n = 0; n < Nqueries; ++n)
+    {
+        findNearestNeighbours(queryPoints.col(n), Nneighbours, neighbourIndices[n], neighbourDistances);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::findPointsWithinRadius()
+//
+// PURPOSE:
+//      Finds all points of the tree that are within a given Euclidean distance
+//      from the query point.
+//
+// INPUT:
+//      queryPoint:     coordinates of the query point
+//      radius:         the maximum distance (inclusive)
+//
+// OUTPUT:
+//      The (unsorted) indices of the points within the radius.
+//
+
+vector<int> KdTree::findPointsWithinRadius(RefArrayXd const queryPoint, const double radius)
+{
+    assert(queryPoint.size() == Ndimensions);
+
+    vector<int> pointIndices;
+
+    if (Npoints > 0)
+    {
+        searchWithinRadius(0, queryPoint, radius*radius, pointIndices);
+    }
+
+    return pointIndices;
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::findPointsWithinRadius()
+//
+// PURPOSE:
+//      Batch version of findPointsWithinRadius() for a set of query points (overloaded).
+//
+// INPUT:
+//      queryPoints(Ndimensions, Nqueries):     coordinates of the query points
+//      radius:                                 the maximum distance (inclusive)
+//      pointIndices[Nqueries]:                 for each query point, the indices of the
+//                                              points within the radius
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::findPointsWithinRadius(RefArrayXXd queryPoints, const double radius,
+                                    vector<vector<int>> &pointIndices)
+{
+    int Nqueries = queryPoints.cols();
+    pointIndices.resize(Nqueries);
+
+    for (int n = 0; n < Nqueries; ++n)
+    {
+        pointIndices[n] = findPointsWithinRadius(queryPoints.col(n), radius);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::searchNearestNeighbours()
+//
+// PURPOSE:
+//      Recursive part of findNearestNeighbours(). The nearest side of each split is
+//      visited first, the far side only if it can still contain a closer point.
+//
+// INPUT:
+//      nodeIndex:          the node to search
+//      queryPoint:         coordinates of the query point
+//      Nneighbours:        number of neighbours to look for
+//      bestCandidates:     max-heap with the (squared distance, index) pairs of the best
+//                          candidates found so far
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::searchNearestNeighbours(const int nodeIndex, RefArrayXd const queryPoint, const int Nneighbours,
+                                     priority_queue<pair<double,int>> &bestCandidates)
+{
+    const Node &node = nodes[nodeIndex];
+
+    if (node.splitDimension < 0)
+    {
+        for (int pointIndex : node.pointIndices)
+        {
+            double squaredDistance = (sample.col(pointIndex) - queryPoint).square().sum();
+
+            if (static_cast<int>(bestCandidates.size()) < Nneighbours)
+            {
+                bestCandidates.push(make_pair(squaredDistance, pointIndex));
+            }
+            else if (squaredDistance < bestCandidates.top().first)
+            {
+                bestCandidates.pop();
+                bestCandidates.push(make_pair(squaredDistance, pointIndex));
+            }
+        }
+
+        return;
+    }
+
+    double distanceToSplit = queryPoint(node.splitDimension) - node.splitValue;
+    int nearChild = (distanceToSplit < 0.0) ? node.leftChild : node.rightChild;
+    int farChild = (distanceToSplit < 0.0) ? node.rightChild : node.leftChild;
+
+    searchNearestNeighbours(nearChild, queryPoint, Nneighbours, bestCandidates);
+
+    if ((static_cast<int>(bestCandidates.size()) < Nneighbours) || (distanceToSplit*distanceToSplit < bestCandidates.top().first))
+    {
+        searchNearestNeighbours(farChild, queryPoint, Nneighbours, bestCandidates);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::searchWithinRadius()
+//
+// PURPOSE:
+//      Recursive part of findPointsWithinRadius().
+//
+// INPUT:
+//      nodeIndex:          the node to search
+//      queryPoint:         coordinates of the query point
+//      squaredRadius:      the square of the maximum distance
+//      pointIndices:       vector to which the indices of the points found are appended
+//
+// OUTPUT:
+//      void
+//
+
+void KdTree::searchWithinRadius(const int nodeIndex, RefArrayXd const queryPoint, const double squaredRadius,
+                                vector<int> &pointIndices)
+{
+    const Node &node = nodes[nodeIndex];
+
+    if (node.splitDimension < 0)
+    {
+        for (int pointIndex : node.pointIndices)
+        {
+            if ((sample.col(pointIndex) - queryPoint).square().sum() <= squaredRadius)
+            {
+                pointIndices.push_back(pointIndex);
+            }
+        }
+
+        return;
+    }
+
+    double distanceToSplit = queryPoint(node.splitDimension) - node.splitValue;
+
+    if ((distanceToSplit < 0.0) || (distanceToSplit*distanceToSplit <= squaredRadius))
+    {
+        searchWithinRadius(node.leftChild, queryPoint, squaredRadius, pointIndices);
+    }
+
+    if ((distanceToSplit >= 0.0) || (distanceToSplit*distanceToSplit <= squaredRadius))
+    {
+        searchWithinRadius(node.rightChild, queryPoint, squaredRadius, pointIndices);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::getNpoints()
+//
+// PURPOSE:
+//      Get private data member Npoints.
+//
+// OUTPUT:
+//      An integer containing the number of points stored in the tree.
+//
+
+int KdTree::getNpoints()
+{
+    return Npoints;
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::getNdimensions()
+//
+// PURPOSE:
+//      Get private data member Ndimensions.
+//
+// OUTPUT:
+//      An integer containing the number of coordinates of each point.
+//
+
+int KdTree::getNdimensions()
+{
+    return Ndimensions;
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::getNmodificationsSinceRebalance()
+//
+// PURPOSE:
+//      Get private data member NmodificationsSinceRebalance.
+//
+// OUTPUT:
+//      An integer containing the number of points replaced or removed
+//      since the tree was last (re)built.
+//
+
+int KdTree::getNmodificationsSinceRebalance()
+{
+    return NmodificationsSinceRebalance;
+}
+
+
+
+
+
+
+
+
+
+
+// KdTree::getSample()
+//
+// PURPOSE:
+//      Get private data member sample.
+//
+// OUTPUT:
+//      An Eigen Array of size (Ndimensions, Npoints) with the coordinates
+//      of the points stored in the tree.
+//
+
+ArrayXXd KdTree::getSample()
+{
+    return sample;
+}
@@ -24,10 +24,9 @@ KmeansClusterer::KmeansClusterer(Metric &metric, unsigned int minNclusters, unsi
   Ntrials(Ntrials), 
   relTolerance(relTolerance)
 {
-    // Set the seed of the random generator using the clock
+    // Take an independent stream of random numbers, derived from the seed of the run
 
-    clock_t clockticks = clock();
-    engine.seed(clockticks);
+    engine = RandomStreams::getNextStream("KmeansClusterer");
 
     // Do some sanity check(s)
 
@@ -80,10 +79,11 @@ void KmeansClusterer::chooseInitialClusterCenters(RefArrayXXd sample, RefArrayXX
     unsigned int Npoints = sample.cols();
 
 
-    // Set up a some random generators
+    // Draw at once all the uniform random numbers between 0 and 1 that are needed:
+    // one to pick the first center, and one for each of the other centers.
     
-    uniform_real_distribution<> uniform01(0.0, 1.0);
-    uniform_int_distribution<> uniform(0, Npoints-1);
+    ArrayXd uniform01Numbers(Nclusters);
+    engine.fillUniform(uniform01Numbers);
 
 
     // Picking the initial centers randomly is prone to leading to a local rather than 
@@ -96,7 +96,7 @@ void KmeansClusterer::chooseInitialClusterCenters(RefArrayXXd sample, RefArrayXX
 
     // Choose the first center randomly
 
-    int randomPointIndex = uniform(engine);
+    int randomPointIndex = int(uniform01Numbers(0) * Npoints);
     int k;
     double distanceToClosestCenter[Npoints];
     double sumOfDistancesToClosestCenters;
@@ -152,9 +152,9 @@ void KmeansClusterer::chooseInitialClusterCenters(RefArrayXXd sample, RefArrayXX
         }
     
 
-        // Generate a uniform random number between 0 and 1
+        // Take a uniform random number between 0 and 1
     
-        uniform01Number = uniform01(engine);
+        uniform01Number = uniform01Numbers(n);
     
 
         // Select the point that makes the cumulative distance greater than the random
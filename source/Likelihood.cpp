@@ -2,6 +2,10 @@
 #include "Likelihood.h"
 
 
+const int Likelihood::segmentSize = 8192;
+const int Likelihood::segmentPredictionsWorkspaceIndex = -1;
+
+
 
 // Likelihood::Likelihood()
 //
@@ -15,7 +19,9 @@
 
 Likelihood::Likelihood(const RefArrayXd observations, Model &model)
 : observations(observations), 
-  model(model)
+  model(model),
+  singlePrecisionIsUsed(false),
+  threadPool(nullptr)
 {
 
 } // END Likelihood::Likelihood()
@@ -65,3 +71,674 @@ ArrayXd Likelihood::getObservations()
 
 
 
+
+
+
+
+
+
+
+// Likelihood::getModel();
+//
+// PURPOSE:
+//      Get protected data member model.
+//
+// OUTPUT:
+//      A reference to the model used by the likelihood.
+//
+
+Model &Likelihood::getModel()
+{
+    return model;
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::fingerprint()
+//
+// PURPOSE:
+//      Compute a hash of everything the log-likelihood values depend on, apart from
+//      the free parameters, so that stored values can be told apart from the values
+//      of a different data set, likelihood or model.
+//
+// OUTPUT:
+//      The hash of the likelihood class, the observations, the model class and its
+//      covariates, and the precision mode.
+//
+// REMARKS:
+//      Derived classes holding further data (e.g. the uncertainties) override this
+//      function, and include that data in the hash of the base class. Settings of the
+//      model other than its covariates are not included.
+//
+
+unsigned long long Likelihood::fingerprint()
+{
+    ArrayXd covariates = model.getCovariates();
+    string likelihoodClass = typeid(*this).name();
+    string modelClass = typeid(model).name();
+
+    unsigned long long hash = Functions::fnv1aHash(likelihoodClass.data(), likelihoodClass.size());
+    hash = Functions::fnv1aHash(observations.data(), observations.size() * sizeof(double), hash);
+    hash = Functions::fnv1aHash(modelClass.data(), modelClass.size(), hash);
+    hash = Functions::fnv1aHash(covariates.data(), covariates.size() * sizeof(double), hash);
+    hash = Functions::fnv1aHash(&singlePrecisionIsUsed, sizeof(bool), hash);
+
+    return hash;
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::getPredictionsWorkspace()
+//
+// PURPOSE:
+//      Get a buffer to store the predictions of the model, with the same size
+//      as the observations. Each calling thread gets its own buffer for each 
+//      likelihood object, which is allocated only the first time it is requested.
+//
+// OUTPUT:
+//      A reference to the buffer of the calling thread.
+//
+// REMARKS:
+//      The buffers are owned by the likelihood, and released with it. Only the look-up
+//      is done under the mutex: the references to the elements of an unordered_map stay
+//      valid when other elements are inserted. The content of the buffer is not preserved 
+//      between calls.
+//
+
+ArrayXd &Likelihood::getPredictionsWorkspace()
+{
+    lock_guard<mutex> lock(workspacesMutex);
+
+    ArrayXd &predictions = predictionsWorkspaces[this_thread::get_id()];
+
+    if (predictions.size() != observations.size())
+    {
+        predictions.resize(observations.size());
+    }
+
+    return predictions;
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::getSinglePrecisionPredictionsWorkspace()
+//
+// PURPOSE:
+//      Get a single precision buffer to store the predictions of the model, with
+//      the same size as the observations. As for getPredictionsWorkspace(), each
+//      calling thread gets its own buffer for each likelihood object.
+//
+// OUTPUT:
+//      A reference to the buffer of the calling thread.
+//
+
+ArrayXf &Likelihood::getSinglePrecisionPredictionsWorkspace()
+{
+    lock_guard<mutex> lock(workspacesMutex);
+
+    ArrayXf &predictions = singlePrecisionPredictionsWorkspaces[this_thread::get_id()];
+
+    if (predictions.size() != observations.size())
+    {
+        predictions.resize(observations.size());
+    }
+
+    return predictions;
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::getVectorWorkspace()
+//
+// PURPOSE:
+//      Get a one-dimensional buffer for the intermediate results of a derived class.
+//      As for getPredictionsWorkspace(), each calling thread gets its own buffers for 
+//      each likelihood object, which are released with the likelihood.
+//
+// INPUT:
+//      workspaceIndex: the index of the buffer, so that a derived class can use several of them.
+//                      Negative indices are used by the base class.
+//      size: the number of elements of the buffer
+//
+// OUTPUT:
+//      A reference to the buffer of the calling thread with the given index, resized
+//      if needed. The content of the buffer is not preserved between calls.
+//
+
+ArrayXd &Likelihood::getVectorWorkspace(const int workspaceIndex, const int size)
+{
+    lock_guard<mutex> lock(workspacesMutex);
+
+    ArrayXd &workspace = vectorWorkspaces[make_pair(this_thread::get_id(), workspaceIndex)];
+
+    if (workspace.size() != size)
+    {
+        workspace.resize(size);
+    }
+
+    return workspace;
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::getMatrixWorkspace()
+//
+// PURPOSE:
+//      Get a two-dimensional buffer for the intermediate results of a derived class.
+//      As for getPredictionsWorkspace(), each calling thread gets its own buffers for 
+//      each likelihood object, which are released with the likelihood.
+//
+// INPUT:
+//      workspaceIndex: the index of the buffer, so that a derived class can use several of them
+//      Nrows: the number of rows of the buffer
+//      Ncols: the number of columns of the buffer
+//
+// OUTPUT:
+//      A reference to the buffer of the calling thread with the given index, resized
+//      if needed. The content of the buffer is not preserved between calls.
+//
+
+ArrayXXd &Likelihood::getMatrixWorkspace(const int workspaceIndex, const int Nrows, const int Ncols)
+{
+    lock_guard<mutex> lock(workspacesMutex);
+
+    ArrayXXd &workspace = matrixWorkspaces[make_pair(this_thread::get_id(), workspaceIndex)];
+
+    if ((workspace.rows() != Nrows) || (workspace.cols() != Ncols))
+    {
+        workspace.resize(Nrows, Ncols);
+    }
+
+    return workspace;
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::refuseLinearParameters()
+//
+// PURPOSE:
+//      Stop with an error if the model has linear parameters (see Model::getNlinearParameters()).
+//      It is called by the constructors of the derived classes that do not marginalize 
+//      them, since ignoring the linear parameters would give a wrong log-likelihood.
+//
+// INPUT:
+//      likelihoodName: the name of the derived class, for the error message
+//
+// OUTPUT:
+//      void
+//
+
+void Likelihood::refuseLinearParameters(const string likelihoodName)
+{
+    if (model.getNlinearParameters() > 0)
+    {
+        cerr << likelihoodName << ": the model has linear parameters, which only NormalLikelihood can marginalize." << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::setSinglePrecision()
+//
+// PURPOSE:
+//      Choose whether the predictions of the model and the terms of the log-likelihood 
+//      are computed in single precision (using Model::predictSinglePrecision() and the
+//      single precision copy of the observations), or in double precision.
+//
+// INPUT:
+//      newSinglePrecisionIsUsed: true for single precision, false for double precision.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      In single precision mode the terms of the log-likelihood are still summed in double
+//      precision, with compensated summation. For large data sets this is mainly limited 
+//      by memory bandwidth, and therefore faster than the double precision mode. Only
+//      derived classes that implement a single precision path are affected. The single 
+//      precision copies of the data are only allocated when this mode is first chosen,
+//      and the model has to implement Model::predictSinglePrecision().
+//      The observations and predictions are still rounded to single precision, so that
+//      differences of log-likelihoods have an absolute error that grows with the number 
+//      of observations and with the residuals (see demoSinglePrecisionLikelihood.cpp).
+//
+
+void Likelihood::setSinglePrecision(const bool newSinglePrecisionIsUsed)
+{
+    if (newSinglePrecisionIsUsed)
+    {
+        if (!model.canPredictSinglePrecision())
+        {
+            cerr << "Likelihood::setSinglePrecision(): the model cannot predict in single precision." << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        prepareSinglePrecision();
+    }
+
+    singlePrecisionIsUsed = newSinglePrecisionIsUsed;
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::getSinglePrecision()
+//
+// PURPOSE:
+//      Get protected data member singlePrecisionIsUsed.
+//
+// OUTPUT:
+//      True if the log-likelihood is computed in single precision mode, false otherwise.
+//
+
+bool Likelihood::getSinglePrecision()
+{
+    return singlePrecisionIsUsed;
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::prepareSinglePrecision()
+//
+// PURPOSE:
+//      Compute the single precision copies of the observations and of the covariates 
+//      of the model, if they do not exist yet.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Derived classes with further single precision data compute it by overriding
+//      this function, and calling the function of the base class.
+//
+
+void Likelihood::prepareSinglePrecision()
+{
+    if (observationsSinglePrecision.size() != observations.size())
+    {
+        observationsSinglePrecision = observations.cast<float>();
+    }
+
+    model.prepareSinglePrecision();
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::setNthreads()
+//
+// PURPOSE:
+//      Choose the number of threads over which the observations are split when
+//      computing the log-likelihood.
+//
+// INPUT:
+//      Nthreads: the number of threads. With 1 thread (the default), the log-likelihood
+//                is computed by the calling thread only.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Only derived classes that use sumOverSegments() are affected. If the model 
+//      can predict segments of the covariates (see Model::canPredictSegments()),
+//      each thread computes the predictions of its own segments. Otherwise the 
+//      predictions are computed by the calling thread, and only the terms of the 
+//      log-likelihood are computed in parallel.
+//
+
+void Likelihood::setNthreads(const int Nthreads)
+{
+    assert(Nthreads >= 1);
+
+    if (Nthreads == 1)
+    {
+        threadPool.reset();
+    }
+    else
+    {
+        threadPool.reset(new ThreadPool(Nthreads));
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::getNthreads()
+//
+// PURPOSE:
+//      Get the number of threads over which the observations are split.
+//
+// OUTPUT:
+//      The number of threads used to compute the log-likelihood.
+//
+
+int Likelihood::getNthreads()
+{
+    if (threadPool)
+    {
+        return threadPool->getNthreads();
+    }
+    else
+    {
+        return 1;
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::sumOverSegments()
+//
+// PURPOSE:
+//      Split the observations in segments of consecutive elements, compute a partial sum
+//      for each segment in parallel using the thread pool, and return the sum of the 
+//      partial sums.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual values of the
+//                       free parameters that describe the model.
+//      segmentSum: function returning the partial sum of a segment, given the index of 
+//                  the first observation of the segment and the predictions of the model
+//                  for the segment. 
+//
+// OUTPUT:
+//      The sum of the partial sums of all segments.
+//
+// REMARKS:
+//      The segments have a fixed size and the partial sums are added in the order of the
+//      segments, so that the result is reproducible, and does not depend on the number
+//      of threads.
+//
+
+double Likelihood::sumOverSegments(RefArrayXd const modelParameters, 
+                                   const function<double(const int beginIndex, RefArrayXd predictions)> &segmentSum)
+{
+    if (model.canPredictSegments())
+    {
+        auto predictAndSumSegment = [&](const int beginIndex, const int length)
+        {
+            ArrayXd &workspace = getVectorWorkspace(segmentPredictionsWorkspaceIndex, segmentSize);
+            auto predictions = workspace.head(length);
+
+            predictions.setZero();
+            model.predictSegment(predictions, modelParameters, beginIndex);
+
+            return segmentSum(beginIndex, predictions);
+        };
+
+        return sumOverSegments(predictAndSumSegment);
+    }
+    else
+    {
+        ArrayXd &predictions = getPredictionsWorkspace();
+
+        predictions.setZero();
+        model.predict(predictions, modelParameters);
+
+        auto sumSegment = [&](const int beginIndex, const int length)
+        {
+            return segmentSum(beginIndex, predictions.segment(beginIndex, length));
+        };
+
+        return sumOverSegments(sumSegment);
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::sumOverSegments()
+//
+// PURPOSE:
+//      Split the observations in segments of consecutive elements, compute a partial sum
+//      for each segment in parallel using the thread pool, and return the sum of the 
+//      partial sums. Contrary to the function above, the predictions of the model are 
+//      left to segmentSum, e.g. to compute them and the terms of the sum in a single loop.
+//
+// INPUT:
+//      segmentSum: function returning the partial sum of a segment, given the index of 
+//                  the first observation of the segment and the number of observations
+//                  in the segment.
+//
+// OUTPUT:
+//      The sum of the partial sums of all segments.
+//
+// REMARKS:
+//      As above, the result does not depend on the number of threads.
+//
+
+double Likelihood::sumOverSegments(const function<double(const int beginIndex, const int length)> &segmentSum)
+{
+    const int Nobservations = observations.size();
+    const int Nsegments = (Nobservations + segmentSize - 1) / segmentSize;
+    vector<double> partialSums(Nsegments);
+
+    auto computeSegment = [&](const int segment)
+    {
+        const int beginIndex = segment * segmentSize;
+        const int length = min(segmentSize, Nobservations - beginIndex);
+
+        partialSums[segment] = segmentSum(beginIndex, length);
+    };
+
+    if (threadPool)
+    {
+        threadPool->parallelFor(Nsegments, computeSegment);
+    }
+    else
+    {
+        for (int segment = 0; segment < Nsegments; ++segment) computeSegment(segment);
+    }
+
+
+    // Combine the partial sums in a fixed order
+
+    double sum = 0.0;
+
+    for (int segment = 0; segment < Nsegments; ++segment)
+    {
+        sum += partialSums[segment];
+    }
+
+    return sum;
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::logValue()
+//
+// PURPOSE:
+//      Compute the natural logarithm of the likelihood, when only its values above 
+//      a threshold are of interest, as for the candidate points of the nested sampler.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//                       values of the free parameters that describe the model.
+//      logLikelihoodThreshold: the value below which the exact log-likelihood is not needed
+//
+// OUTPUT:
+//      The natural logarithm of the likelihood if it is at least logLikelihoodThreshold.
+//      Otherwise a value below logLikelihoodThreshold, that is an upper bound of
+//      the natural logarithm of the likelihood.
+//
+// REMARKS:
+//      This default implementation always computes the exact value. Derived classes
+//      whose terms are bounded from above can stop as soon as the bound is below
+//      the threshold (see boundedSumOverSegments()).
+//
+
+double Likelihood::logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold)
+{
+    return logValue(modelParameters);
+}
+
+
+
+
+
+
+
+
+
+
+// Likelihood::boundedSumOverSegments()
+//
+// PURPOSE:
+//      Sum the terms of the log-likelihood segment by segment, and stop as soon as
+//      an upper bound of the log-likelihood, given the partial sum, is below the threshold.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual values of the
+//                       free parameters that describe the model.
+//      logLikelihoodThreshold: the value below which the exact log-likelihood is not needed
+//      segmentSum: function returning the partial sum of a segment, given the index of 
+//                  the first observation of the segment and the predictions of the model
+//                  for the segment. 
+//      upperBound: function returning an upper bound of the log-likelihood, given the 
+//                  number of segments summed so far and their partial sum. When all 
+//                  segments are summed, it should return the exact log-likelihood.
+//
+// OUTPUT:
+//      The log-likelihood, or an upper bound of the log-likelihood that is smaller than 
+//      logLikelihoodThreshold.
+//
+// REMARKS:
+//      When the model can predict segments of the covariates, only the predictions of the
+//      segments that are summed are computed, which is where most of the time is saved
+//      for rejected points. The segments are always summed serially.
+//
+
+double Likelihood::boundedSumOverSegments(RefArrayXd const modelParameters, const double logLikelihoodThreshold,
+                                          const function<double(const int beginIndex, RefArrayXd predictions)> &segmentSum,
+                                          const function<double(const int NsegmentsDone, const double partialSum)> &upperBound)
+{
+    const int Nobservations = observations.size();
+    const int Nsegments = (Nobservations + segmentSize - 1) / segmentSize;
+    const bool segmentsArePredicted = model.canPredictSegments();
+    ArrayXd &predictions = getPredictionsWorkspace();
+
+    if (!segmentsArePredicted)
+    {
+        predictions.setZero();
+        model.predict(predictions, modelParameters);
+    }
+
+    double partialSum = 0.0;
+
+    for (int segment = 0; segment < Nsegments; ++segment)
+    {
+        const int beginIndex = segment * segmentSize;
+        const int length = min(segmentSize, Nobservations - beginIndex);
+
+        if (segmentsArePredicted)
+        {
+            predictions.segment(beginIndex, length).setZero();
+            model.predictSegment(predictions.segment(beginIndex, length), modelParameters, beginIndex);
+        }
+
+        partialSum += segmentSum(beginIndex, predictions.segment(beginIndex, length));
+
+        const double bound = upperBound(segment + 1, partialSum);
+
+        if (bound < logLikelihoodThreshold)
+        {
+            return bound;
+        }
+    }
+
+    return upperBound(Nsegments, partialSum);
+}
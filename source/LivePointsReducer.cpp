@@ -55,14 +55,14 @@ LivePointsReducer::~LivePointsReducer()
 //          Repeats the process up to the total number of live points to be removed.
 //
 // INPUT:
-//          engine:     a Marsenne-Twister engine containing the clock seed for
-//                      generating random numbers
+//          engine:     the random number generator of the nested sampler, which 
+//                      is advanced by the numbers drawn
 //
 // OUTPUT:
 //          A vector to contain the indices of the live points to be removed.
 //
 
-vector<int> LivePointsReducer::findIndicesOfLivePointsToRemove(mt19937 engine)
+vector<int> LivePointsReducer::findIndicesOfLivePointsToRemove(Philox4x32Engine &engine)
 {
     // Compute how many live points must be removed from the current sample.
     // In case no live points must be removed, process will skip initialization
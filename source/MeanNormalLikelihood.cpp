@@ -17,13 +17,21 @@ MeanNormalLikelihood::MeanNormalLikelihood(const RefArrayXd observations, const
 : Likelihood(observations, model),
   uncertainties(uncertainties)
 {
+    refuseLinearParameters("MeanNormalLikelihood");
+
     double normalizeFactor;
     
-    assert(observations.size() != uncertainties.size());
+    assert(observations.size() == uncertainties.size());
     normalizeFactor = sqrt(observations.size()/uncertainties.pow(-2).sum());
     normalizedUncertainties = uncertainties/normalizeFactor; 
     weights = normalizedUncertainties.pow(-2);
 
+
+    // The terms of the log-likelihood that only depend on the data are computed once
+
+    double n = observations.size();
+    normalizationConstant = lgammal(n/2.) - log(2) - (n/2.)*log(Functions::PI) + 0.5*weights.log().sum();
+
 } // END MeanNormalLikelihood::MeanNormalLikelihood()
 
 
@@ -53,6 +61,62 @@ MeanNormalLikelihood::~MeanNormalLikelihood()
 
 
 
+// MeanNormalLikelihood::prepareSinglePrecision()
+//
+// PURPOSE:
+//      Compute the single precision copies of the data, if they do not exist yet
+//      (see Likelihood::prepareSinglePrecision()).
+//
+// OUTPUT:
+//      void
+//
+
+void MeanNormalLikelihood::prepareSinglePrecision()
+{
+    Likelihood::prepareSinglePrecision();
+
+    if (weightsSinglePrecision.size() != weights.size())
+    {
+        weightsSinglePrecision = weights.cast<float>();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// MeanNormalLikelihood::fingerprint()
+//
+// PURPOSE:
+//      Compute a hash of everything the log-likelihood values depend on,
+//      apart from the free parameters (see Likelihood::fingerprint()).
+//
+// OUTPUT:
+//      The hash of the base class, combined with the uncertainties.
+//
+
+unsigned long long MeanNormalLikelihood::fingerprint()
+{
+    unsigned long long hash = Likelihood::fingerprint();
+    hash = Functions::fnv1aHash(uncertainties.data(), uncertainties.size() * sizeof(double), hash);
+
+    return hash;
+}
+
+
+
+
+
+
+
+
+
+
 // MeanNormalLikelihood::getNormalizedUncertainties();
 //
 // PURPOSE:
@@ -92,26 +156,88 @@ ArrayXd MeanNormalLikelihood::getNormalizedUncertainties()
 //      a double number containing the natural logarithm of the
 //      mean likelihood
 //
+// REMARKS:
+//      The terms are summed per segment of observations (see Likelihood::sumOverSegments()),
+//      with or without threads, so that the result does not depend on the number of threads.
+//
 
 double MeanNormalLikelihood::logValue(RefArrayXd modelParameters)
 {
     unsigned long n = observations.size();
-    double lambda0;
-    double lambda;
-    ArrayXd argument;
-    ArrayXd predictions;
 
-    predictions.resize(n);
-    predictions.setZero();
-    model.predict(predictions, modelParameters);
-    argument = (observations - predictions);
-    argument = argument.square()*weights;
+    if (singlePrecisionIsUsed)
+    {
+        ArrayXf &predictions = getSinglePrecisionPredictionsWorkspace();
+
+        predictions.setZero();
+        model.predictSinglePrecision(predictions, modelParameters);
+        predictions = (observationsSinglePrecision - predictions).square() * weightsSinglePrecision;
+
+        return normalizationConstant - (n/2.)*log(Functions::compensatedSum(predictions));
+    }
 
-    lambda0 = lgammal(n/2.) - log(2) - (n/2.)*log(Functions::PI) + 0.5*weights.log().sum();
-    lambda = lambda0 - (n/2.)*log(argument.sum());
+    auto weightedSumOfSquaredResiduals = [this](const int beginIndex, RefArrayXd predictions)
+    {
+        const int length = predictions.size();
 
-    return lambda;
+        return ((observations.segment(beginIndex, length) - predictions).square() 
+                * weights.segment(beginIndex, length)).sum();
+    };
+
+    return normalizationConstant - (n/2.)*log(sumOverSegments(modelParameters, weightedSumOfSquaredResiduals));
 }
 
 
 
+
+
+
+
+
+
+// MeanNormalLikelihood::logValue()
+//
+// PURPOSE:
+//      Compute the natural logarithm of the mean normal likelihood, but stop as 
+//      soon as it is certain to be below a given threshold.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//                       values of the free parameters that describe the model.
+//      logLikelihoodThreshold: the value below which the exact log-likelihood is not needed
+//
+// OUTPUT:
+//      The natural logarithm of the mean normal likelihood if it is at least logLikelihoodThreshold,
+//      otherwise an upper bound of it that is smaller than logLikelihoodThreshold.
+//
+// REMARKS:
+//      The log-likelihood decreases with the weighted sum of squared residuals, and 
+//      each partial sum is smaller than the full sum, so that the log-likelihood 
+//      computed with a partial sum is an upper bound.
+//      In single precision mode, or with several threads, the exact value is always computed.
+//
+
+double MeanNormalLikelihood::logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold)
+{
+    if (singlePrecisionIsUsed || (getNthreads() > 1))
+    {
+        return logValue(modelParameters);
+    }
+
+    unsigned long n = observations.size();
+
+    auto weightedSumOfSquaredResiduals = [this](const int beginIndex, RefArrayXd predictions)
+    {
+        const int length = predictions.size();
+
+        return ((observations.segment(beginIndex, length) - predictions).square() 
+                * weights.segment(beginIndex, length)).sum();
+    };
+
+    auto upperBound = [this, n](const int NsegmentsDone, const double partialSum)
+    {
+        return normalizationConstant - (n/2.)*log(partialSum);
+    };
+
+    return boundedSumOverSegments(modelParameters, logLikelihoodThreshold, weightedSumOfSquaredResiduals, upperBound);
+}
@@ -0,0 +1,315 @@
+#include "MiniBatchKmeansClusterer.h"
+
+
+
+// MiniBatchKmeansClusterer::MiniBatchKmeansClusterer()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      metric: this class is used to compute the distance between two points
+//      minNclusters: the minimum number of clusters that is to be fitted
+//      maxNclusters: the maximum number of clusters that is to be fitted
+//      Ntrials: as k-means is sensitive to the initial choice of the cluster centers,
+//               repeat k-means with different trials of initial centers, and pick the best one.
+//      relTolerance: the mini-batch updates are stopped when the relative change in the (smoothed)
+//                    mean distance of the batch points to their closest center is below relTolerance.
+//      batchSize: the number of points randomly drawn from the sample for each update of the centers.
+//      maxNepochs: the maximum number of mini-batch updates of the centers.
+//
+// REMARKS:
+//      The cost of each update of the centers is proportional to batchSize, and not to the
+//      total number of points in the sample. Only one pass over the full sample is done at the
+//      end, to assign each point to its closest center.
+//
+
+MiniBatchKmeansClusterer::MiniBatchKmeansClusterer(Metric &metric, unsigned int minNclusters, unsigned int maxNclusters,
+                                                   unsigned int Ntrials, double relTolerance, unsigned int batchSize,
+                                                   unsigned int maxNepochs)
+: KmeansClusterer(metric, minNclusters, maxNclusters, Ntrials, relTolerance),
+  batchSize(batchSize),
+  maxNepochs(maxNepochs)
+{
+    assert(batchSize > 0);
+    assert(maxNepochs > 0);
+}
+
+
+
+
+
+
+
+
+
+// MiniBatchKmeansClusterer::~MiniBatchKmeansClusterer()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+MiniBatchKmeansClusterer::~MiniBatchKmeansClusterer()
+{
+
+}
+
+
+
+
+
+
+
+
+
+// MiniBatchKmeansClusterer::chooseInitialClusterCenters()
+//
+// PURPOSE:
+//      Choose semi-randomly the initial centers of the clusters, using the method of
+//      Arthur & Vassilvitskii (2007) on a random subset of batchSize points of the sample,
+//      rather than on the full sample.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      center(Ndimensions, Nclusters): set of N-dimensional coordinates of the cluster centers
+//      Nclusters: number of clusters considered
+//
+// OUTPUT:
+//      void
+//
+
+void MiniBatchKmeansClusterer::chooseInitialClusterCenters(RefArrayXXd sample, RefArrayXXd centers, unsigned int Nclusters)
+{
+    unsigned int Npoints = sample.cols();
+
+    if (Npoints <= batchSize)
+    {
+        // The sample is small enough to use all points
+
+        KmeansClusterer::chooseInitialClusterCenters(sample, centers, Nclusters);
+        return;
+    }
+
+
+    // Draw the subset of points randomly (with replacement)
+
+    ArrayXd uniform01Numbers(batchSize);
+    ArrayXXd subsample(sample.rows(), batchSize);
+    engine.fillUniform(uniform01Numbers);
+
+    for (unsigned int n = 0; n < batchSize; ++n)
+    {
+        subsample.col(n) = sample.col(int(uniform01Numbers(n) * Npoints));
+    }
+
+    KmeansClusterer::chooseInitialClusterCenters(subsample, centers, Nclusters);
+}
+
+
+
+
+
+
+
+
+
+
+
+
+// MiniBatchKmeansClusterer::updateClusterCentersUntilConverged()
+//
+// PURPOSE:
+//      Evolve the cluster centers according to the mini-batch k-means algorithm. Each epoch,
+//      batchSize points are drawn randomly from the sample and assigned to their closest center.
+//      Each center is then moved towards the points assigned to it, with a learning rate equal
+//      to the inverse of the number of points it has been assigned so far. After convergence,
+//      all points of the sample are assigned to their closest center in a single pass, and the
+//      centers are set to the barycenters of their clusters.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints):   sample of N-dimensional points
+//      center(Ndimensions, Nclusters): set of N-dimensional coordinates of the cluster centers
+//      clusterSizes(Nclusters):        for each cluster, the number of points it contains
+//      clusterIndices(Npoints):        for each point the index of the cluster it belongs to. This index
+//                                      runs from 0 to Nclusters-1.
+//      sumOfDistancesToClosestCenter:  the sum over all points of their distance to the closest
+//                                      cluster center (i.e. the center of the cluster to which they
+//                                      belong).
+//      relTolerance:                   the updates are stopped when the relative change in the smoothed
+//                                      mean distance of the batch points to their closest center is
+//                                      smaller than relTolerance.
+//
+// OUTPUT:
+//      True if all clusters contain at least 2 points after the final assignment, false otherwise.
+//
+
+bool MiniBatchKmeansClusterer::updateClusterCentersUntilConverged(RefArrayXXd sample, RefArrayXXd centers,
+                                                                  RefArrayXd clusterSizes, vector<int> &clusterIndices,
+                                                                  double &sumOfDistancesToClosestCenter, double relTolerance)
+{
+    unsigned int Npoints = sample.cols();
+    unsigned int Nclusters = centers.cols();
+    ArrayXd uniform01Numbers(batchSize);                      // To draw the indices of the batch points
+    vector<int> batchIndices(batchSize);
+    vector<int> batchClusterIndices(batchSize);
+    ArrayXd NassignedPoints = ArrayXd::Zero(Nclusters);       // Number of points assigned to each center over all epochs
+    unsigned int indexOfClosestCenter;
+    double distanceToClosestCenter;
+    double distance;
+    double smoothedMeanDistance = 0.0;
+    const double smoothingFactor = 0.3;                       // Weight of the current epoch in the smoothed mean distance
+    const unsigned int minNepochs = 10;
+
+
+    // The mean distance of a batch is a noisy estimate, hence it is smoothed with
+    // an exponentially weighted moving average before testing for convergence.
+
+    for (unsigned int epoch = 0; epoch < maxNepochs; ++epoch)
+    {
+        // Draw the batch and find for each of its points the closest center, using
+        // the centers of the previous epoch.
+
+        double batchSumOfDistances = 0.0;
+        engine.fillUniform(uniform01Numbers);
+
+        for (unsigned int n = 0; n < batchSize; ++n)
+        {
+            batchIndices[n] = int(uniform01Numbers(n) * Npoints);
+            indexOfClosestCenter = 0;
+            distanceToClosestCenter = numeric_limits<double>::max();
+
+            for (unsigned int i = 0; i < Nclusters; ++i)
+            {
+                distance = metric.distance(sample.col(batchIndices[n]), centers.col(i));
+
+                if (distance < distanceToClosestCenter)
+                {
+                    indexOfClosestCenter = i;
+                    distanceToClosestCenter = distance;
+                }
+            }
+
+            batchClusterIndices[n] = indexOfClosestCenter;
+            batchSumOfDistances += distanceToClosestCenter;
+        }
+
+
+        // Move each center towards the batch points assigned to it, with a per-center learning rate
+
+        for (unsigned int n = 0; n < batchSize; ++n)
+        {
+            int cluster = batchClusterIndices[n];
+            NassignedPoints(cluster) += 1;
+            double learningRate = 1.0 / NassignedPoints(cluster);
+            centers.col(cluster) = (1.0 - learningRate) * centers.col(cluster) + learningRate * sample.col(batchIndices[n]);
+        }
+
+
+        // Decide whether the centers have converged
+
+        double meanDistance = batchSumOfDistances / batchSize;
+
+        if (epoch == 0)
+        {
+            smoothedMeanDistance = meanDistance;
+            continue;
+        }
+
+        double newSmoothedMeanDistance = (1.0 - smoothingFactor) * smoothedMeanDistance + smoothingFactor * meanDistance;
+        bool converged = (fabs(newSmoothedMeanDistance - smoothedMeanDistance) < relTolerance * smoothedMeanDistance);
+        smoothedMeanDistance = newSmoothedMeanDistance;
+
+        if (converged && (epoch >= minNepochs)) break;
+    }
+
+
+    // Do a single pass over the full sample, to assign each point to its closest center.
+    // At the same time compute the barycenters of the resulting clusters.
+
+    ArrayXXd updatedCenters = ArrayXXd::Zero(sample.rows(), Nclusters);
+    clusterSizes.setZero();
+    sumOfDistancesToClosestCenter = 0.0;
+
+    for (unsigned int n = 0; n < Npoints; ++n)
+    {
+        indexOfClosestCenter = 0;
+        distanceToClosestCenter = numeric_limits<double>::max();
+
+        for (unsigned int i = 0; i < Nclusters; ++i)
+        {
+            distance = metric.distance(sample.col(n), centers.col(i));
+
+            if (distance < distanceToClosestCenter)
+            {
+                indexOfClosestCenter = i;
+                distanceToClosestCenter = distance;
+            }
+        }
+
+        sumOfDistancesToClosestCenter += distanceToClosestCenter;
+        updatedCenters.col(indexOfClosestCenter) += sample.col(n);
+        clusterSizes(indexOfClosestCenter) += 1;
+        clusterIndices[n] = indexOfClosestCenter;
+    }
+
+
+    // As for the standard k-means, all clusters should contain at least 2 points
+
+    if (!(clusterSizes > 1).all())
+    {
+        return false;
+    }
+
+    updatedCenters.rowwise() /= clusterSizes.transpose();
+    centers = updatedCenters;
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+
+
+// MiniBatchKmeansClusterer::getBatchSize()
+//
+// PURPOSE:
+//      Get private data member batchSize.
+//
+// OUTPUT:
+//      An integer containing the number of points used for each update of the centers.
+//
+
+unsigned int MiniBatchKmeansClusterer::getBatchSize()
+{
+    return batchSize;
+}
+
+
+
+
+
+
+
+
+
+
+
+// MiniBatchKmeansClusterer::getMaxNepochs()
+//
+// PURPOSE:
+//      Get private data member maxNepochs.
+//
+// OUTPUT:
+//      An integer containing the maximum number of mini-batch updates of the centers.
+//
+
+unsigned int MiniBatchKmeansClusterer::getMaxNepochs()
+{
+    return maxNepochs;
+}
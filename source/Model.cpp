@@ -81,3 +81,256 @@ int Model::getNparameters()
 {
     return Nparameters;
 }
+
+
+
+
+
+
+
+
+
+
+
+// Model::predictSinglePrecision()
+//
+// PURPOSE: 
+//      Compute the predictions of the model in single precision. 
+//
+// INPUT:
+//      predictions: one-dimensional array to contain the predictions
+//      modelParameters: one-dimensional array containing the values of the free parameters
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Single precision is opt-in: derived classes that override this function compute 
+//      the predictions from covariatesSinglePrecision, which halves the memory traffic and 
+//      doubles the number of values per SIMD instruction, and should also override 
+//      canPredictSinglePrecision(). Likelihoods refuse to use single precision with other
+//      models, since computing the predictions in double precision and rounding them
+//      would only add the cost of the conversion.
+//      The covariates are stored relative to the origin of their block (see prepareSinglePrecision()).
+//      Derived classes should compute the offsets between the block origins and their own
+//      parameters in double precision, e.g. for block b
+//          float offset = covariatesBlockOrigins(b) - centroid;
+//          ... covariatesSinglePrecision.segment(b * singlePrecisionBlockSize, length) + offset ...
+//      and never round the parameters themselves, so that the difference between a covariate
+//      and a parameter keeps a relative precision of about 1e-7.
+//
+
+void Model::predictSinglePrecision(RefArrayXf predictions, const RefArrayXd modelParameters)
+{
+    cerr << "Model::predictSinglePrecision(): this model cannot predict in single precision." << endl;
+    exit(EXIT_FAILURE);
+}
+
+
+
+
+
+
+
+
+
+
+
+// Model::canPredictSinglePrecision()
+//
+// PURPOSE: 
+//      Tell whether predictSinglePrecision() is implemented.
+//
+// OUTPUT:
+//      False for the base class. Derived classes that implement predictSinglePrecision() return true.
+//
+
+bool Model::canPredictSinglePrecision()
+{
+    return false;
+}
+
+
+
+
+
+
+
+
+
+
+
+// Model::prepareSinglePrecision()
+//
+// PURPOSE: 
+//      Compute the single precision copy of the covariates, if it does not exist yet.
+//      It is called by Likelihood::setSinglePrecision(), so that the copy is only 
+//      allocated for the models that are used in single precision.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Rounding the covariates themselves to single precision would lose their 
+//      differences with the parameters: near 5000, consecutive floats are 5e-4 apart.
+//      The covariates are therefore split in blocks of singlePrecisionBlockSize,
+//      and only their difference with the first covariate of their block, which is 
+//      kept in double precision in covariatesBlockOrigins, is rounded.
+//
+
+void Model::prepareSinglePrecision()
+{
+    if (covariatesSinglePrecision.size() == covariates.size())
+    {
+        return;
+    }
+
+    const int Ncovariates = covariates.size();
+    const int blockSize = singlePrecisionBlockSize;
+    const int Nblocks = (Ncovariates + blockSize - 1) / blockSize;
+
+    covariatesSinglePrecision.resize(Ncovariates);
+    covariatesBlockOrigins.resize(Nblocks);
+
+    for (int block = 0; block < Nblocks; ++block)
+    {
+        const int beginIndex = block * blockSize;
+        const int length = min(blockSize, Ncovariates - beginIndex);
+
+        covariatesBlockOrigins(block) = covariates(beginIndex);
+        covariatesSinglePrecision.segment(beginIndex, length) = 
+            (covariates.segment(beginIndex, length) - covariatesBlockOrigins(block)).cast<float>();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+
+// Model::predictSegment()
+//
+// PURPOSE: 
+//      Compute the predictions of the model for the consecutive covariates 
+//      covariates(beginIndex), ..., covariates(beginIndex + predictions.size() - 1).
+//
+// INPUT:
+//      predictions: one-dimensional array to contain the predictions of the segment
+//      modelParameters: one-dimensional array containing the values of the free parameters
+//      beginIndex: index of the covariate corresponding to predictions(0)
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Derived classes that override this function should also override canPredictSegments(),
+//      and make sure that it can be called concurrently from different threads, for
+//      different segments. This allows likelihoods to split the covariates over several 
+//      threads (see Likelihood::setNthreads()). The default implementation can only 
+//      predict the full range of covariates.
+//
+
+void Model::predictSegment(RefArrayXd predictions, const RefArrayXd modelParameters, const int beginIndex)
+{
+    if ((beginIndex != 0) || (predictions.size() != covariates.size()))
+    {
+        cerr << "Model::predictSegment(): this model can only predict the full range of covariates." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    predict(predictions, modelParameters);
+}
+
+
+
+
+
+
+
+
+
+
+
+// Model::canPredictSegments()
+//
+// PURPOSE: 
+//      Tell whether predictSegment() is implemented for any segment of the covariates.
+//
+// OUTPUT:
+//      False for the base class. Derived classes that implement predictSegment() return true.
+//
+
+bool Model::canPredictSegments()
+{
+    return false;
+}
+
+
+
+
+
+
+
+
+
+
+
+// Model::getNlinearParameters()
+//
+// PURPOSE: 
+//      Get the number of parameters in which the model is linear, and that are
+//      not among the free parameters passed to predict().
+//
+// OUTPUT:
+//      Zero for the base class. Derived classes that implement predictDesignMatrix()
+//      return the number of columns of the design matrix.
+//
+// REMARKS:
+//      The full model is predict() + designMatrix * linearParameters. A likelihood can
+//      marginalize the linear parameters analytically (see NormalLikelihood), so that 
+//      the sampler only explores the free parameters passed to predict().
+//
+
+int Model::getNlinearParameters()
+{
+    return 0;
+}
+
+
+
+
+
+
+
+
+
+
+
+// Model::predictDesignMatrix()
+//
+// PURPOSE: 
+//      Add the design matrix of the linear parameters to designMatrix, i.e. for each 
+//      linear parameter the column of its coefficients for all covariates. 
+//
+// INPUT:
+//      designMatrix: two-dimensional array of size (Ncovariates, NlinearParameters)
+//      modelParameters: one-dimensional array containing the values of the free 
+//                       (non-linear) parameters, on which the design matrix may depend
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The base class has no linear parameters, so this function should not be called.
+//
+
+void Model::predictDesignMatrix(RefArrayXXd designMatrix, const RefArrayXd modelParameters)
+{
+    cerr << "Model::predictDesignMatrix(): this model has no linear parameters." << endl;
+    exit(EXIT_FAILURE);
+}
@@ -167,7 +167,7 @@ bool MultiEllipsoidSampler::drawWithConstraint(const RefArrayXXd totalSample, co
     // Drawing a new point with the constraints mentioned above may prove difficult.
     // Hence, we won't try more than 'maxNdrawAttempts'.
 
-    int NdrawAttempts = 0;
+    NdrawAttempts = 0;
 
     while ((newPointIsFound == false) & (NdrawAttempts < maxNdrawAttempts))
     {
@@ -265,9 +265,23 @@ bool MultiEllipsoidSampler::drawWithConstraint(const RefArrayXXd totalSample, co
         // Finally, the point should not only be drawn inside the ellipsoid and according to the prior
         // density, but it should also have a likelihood that is larger than the one of the worst point.
         // We check this criterion only after the prior criterion, because often the likelihood is
-        // much more time consuming to compute than the prior.
+        // much more time consuming to compute than the prior. Passing the threshold allows the
+        // likelihood to stop as soon as it is certain that the point will be rejected.
+        // If a surrogate of the likelihood is used, points that it predicts to be rejected
+        // with high confidence are not evaluated at all.
 
-        logLikelihoodOfDrawnPoint = likelihood.logValue(drawnPoint);
+        if ((surrogate != nullptr) && surrogate->pointCanBeSkipped(drawnPoint, worstLiveLogLikelihood))
+        {
+            newPointIsFound = false;
+            continue;
+        }
+
+        logLikelihoodOfDrawnPoint = likelihood.logValue(drawnPoint, worstLiveLogLikelihood);
+
+        if (surrogate != nullptr)
+        {
+            surrogate->addEvaluatedPoint(drawnPoint, logLikelihoodOfDrawnPoint, worstLiveLogLikelihood);
+        }
 
         if (logLikelihoodOfDrawnPoint < worstLiveLogLikelihood)
         {
@@ -35,16 +35,25 @@ NestedSampler::NestedSampler(const bool printOnTheScreen, const int initialNlive
   logCumulatedPriorMass(numeric_limits<double>::lowest()),
   logRemainingPriorMass(0.0),
   ratioOfRemainderToCurrentEvidence(numeric_limits<double>::max()),
+  livePointsTreeIsEnabled(false),
+  NdrawAttempts(1),
+  surrogate(nullptr),
   Niterations(0),
   updatedNlivePoints(initialNlivePoints),
   initialNlivePoints(initialNlivePoints),
   informationGain(0.0), 
-  logEvidence(numeric_limits<double>::lowest())
+  logEvidence(numeric_limits<double>::lowest()),
+  driftTriggeredClusteringIsEnabled(false),
+  minAcceptanceRateFraction(0.5),
+  maxRelativeShift(0.25),
+  minNiterationsBetweenClusterings(10),
+  maxNiterationsBetweenClusterings(1000),
+  Nclusterings(0),
+  lastClusteringIteration(0)
 {
-   // Set the seed of the random generator using the clock
+    // Take an independent stream of random numbers, derived from the seed of the run
 
-    clock_t clockticks = clock();
-    engine.seed(clockticks);
+    engine = RandomStreams::getNextStream("NestedSampler");
 
 
     // The number of dimensions of the parameter space is the sum
@@ -113,6 +122,9 @@ NestedSampler::~NestedSampler()
 //                                            high likelihood. Clusters found in the first N initial iterations are therefore 
 //                                            likely purely noise.
 //      NiterationsWithSameClustering:        A new clustering will only happen every N iterations.
+//                                            Both NinitialIterationsWithoutClustering and NiterationsWithSameClustering
+//                                            are ignored when drift-triggered clustering is enabled 
+//                                            (see setDriftTriggeredClustering()).
 //      maxNdrawAttempts:                     The maximum number of attempts allowed when drawing from a single ellipsoid.
 //      maxRatioOfRemainderToCurrentEvidence: The fraction of remainder evidence to gained evidence used to terminate 
 //                                            the nested iteration loop. This value is also used as a tolerance on the final
@@ -141,6 +153,7 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
     {
         cerr << "------------------------------------------------" << endl;
         cerr << " Bayesian Inference problem has " << Ndimensions << " dimensions." << endl;
+        cerr << " Random numbers derived from run seed " << RandomStreams::getRunSeed() << "." << endl;
         cerr << "------------------------------------------------" << endl;
         cerr << endl;
     }
@@ -154,6 +167,7 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
    
    
     outputFile << "# List of configuring parameters used for the NSMC." << endl;
+    outputFile << "# Run seed: " << RandomStreams::getRunSeed() << endl;
     outputFile << "# Row #1: Ndimensions" << endl;
     outputFile << "# Row #2: Initial(Maximum) NlivePoints" << endl;
     outputFile << "# Row #3: Minimum NlivePoints" << endl;
@@ -232,6 +246,26 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
     }
 
 
+    // The surrogate of the likelihood, if any, is trained on the initial live sample
+
+    if (surrogate != nullptr)
+    {
+        for (int i = 0; i < NlivePoints; ++i)
+        {
+            surrogate->addEvaluatedPoint(nestedSample.col(i), logLikelihood(i), numeric_limits<double>::lowest());
+        }
+    }
+
+
+    // If requested, build the tree over the live points, which allows for fast nearest-neighbour 
+    // and range queries on the live sample. It is kept in sync with nestedSample below.
+
+    if (livePointsTreeIsEnabled)
+    {
+        livePointsTree.build(nestedSample);
+    }
+
+
     // Initialize the prior mass interval and cumulate it
 
     double logWidthInPriorMass = log(1.0 - exp(-1.0/NlivePoints));                                             // X_0 - X_1    First width in prior mass
@@ -320,18 +354,35 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
                 
 
         // Find clusters in our live sample of points. Don't do this every iteration but only
-        // every x iterations, where x is given by 'NiterationsWithSameClustering'.
+        // every x iterations, where x is given by 'NiterationsWithSameClustering', or, if 
+        // drift-triggered clustering is enabled, only when the live sample drifted away from
+        // the last clustering.
         
-        if ((Niterations % NiterationsWithSameClustering) == 0)
+        bool clusteringShouldBeUpdated;
+
+        if (driftTriggeredClusteringIsEnabled)
+        {
+            clusteringShouldBeUpdated = (Niterations == 0) || clusteringHasDrifted(clusterSizes);
+        }
+        else
+        {
+            clusteringShouldBeUpdated = ((Niterations % NiterationsWithSameClustering) == 0);
+        }
+
+        if (clusteringShouldBeUpdated)
         {            
             // Don't do clustering the first N iterations, where N is user-specified. That is, 
             // the first N iterations we assume that there is only 1 cluster containing all the points.
             // This is often useful because initially the points may be sampled from a uniform prior,
             // and we therefore don't expect any clustering _before_ the algorithm is able to tune in on 
             // the island(s) of high likelihood. Clusters found in the first N initial iterations are
-            // therefore likely purely noise.
+            // therefore likely purely noise. With drift-triggered clustering, the single cluster is 
+            // kept until the first trigger fires.
         
-            if (Niterations < NinitialIterationsWithoutClustering)
+            bool clusteringIsTrivial = (driftTriggeredClusteringIsEnabled ? (Niterations == 0) 
+                                                                          : (Niterations < NinitialIterationsWithoutClustering));
+
+            if (clusteringIsTrivial)
             {
                 // There is only 1 cluster, containing all objects. All points have the same cluster
                 // index, namely 0.
@@ -346,6 +397,14 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
                 // After the first N initial iterations, we do a proper clustering.
                 
                 Nclusters = clusterer.cluster(nestedSample, clusterIndices, clusterSizes);
+                Nclusterings++;
+            }
+
+            lastClusteringIteration = Niterations;
+
+            if (driftTriggeredClusteringIsEnabled)
+            {
+                resetDriftStatistics(Nclusters, clusterIndices, clusterSizes);
             }
         }
 
@@ -402,6 +461,22 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
 
         nestedSample.col(indexOfLivePointWithWorstLikelihood) = drawnPoint;
         logLikelihood(indexOfLivePointWithWorstLikelihood) = logLikelihoodOfDrawnPoint;
+
+        if (livePointsTreeIsEnabled)
+        {
+            livePointsTree.replacePoint(indexOfLivePointWithWorstLikelihood, drawnPoint);
+        }
+
+
+        // The new point inherits the cluster index of the point it replaces, unless drift-triggered
+        // clustering is enabled. In that case it is assigned to the closest cluster, and we keep track 
+        // of how much the live sample drifts away from the last clustering.
+
+        if (driftTriggeredClusteringIsEnabled)
+        {
+            updateDriftStatistics(posteriorSample.col(Niterations), drawnPoint, 
+                                  clusterIndices[indexOfLivePointWithWorstLikelihood], clusterSizes);
+        }
        
         
         // If we got till here this is not the last iteration possible, hence 
@@ -447,6 +522,11 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
                 // At least one live point has to be removed, hence update the sample
 
                 removeLivePointsFromSample(indicesOfLivePointsToRemove, clusterIndices, clusterSizes);
+
+                if (driftTriggeredClusteringIsEnabled)
+                {
+                    computeClusterSums(Nclusters, clusterIndices);
+                }
                         
                         
                 // Since everything is fine update discreteUniform with the corresponding new upper bound
@@ -591,6 +671,24 @@ void NestedSampler::run(LivePointsReducer &livePointsReducer, const int Ninitial
         cerr << "------------------------------------------------" << endl;
         cerr << " Final log(E): " << logEvidence << " +/- " << logEvidenceError << endl;
         cerr << "------------------------------------------------" << endl;
+
+        if (surrogate != nullptr)
+        {
+            cerr << " Surrogate: " << surrogate->getNskippedPoints() << " skipped points, " 
+                 << "false rejection rate " << surrogate->getFalseRejectionRate() 
+                 << " (" << surrogate->getNaudits() << " audits)" << endl;
+            cerr << "------------------------------------------------" << endl;
+        }
+
+        CachedLikelihood *cachedLikelihood = dynamic_cast<CachedLikelihood*>(&likelihood);
+
+        if (cachedLikelihood != nullptr)
+        {
+            cerr << " Likelihood cache: " << cachedLikelihood->getNhits() << " hits, " 
+                 << cachedLikelihood->getNmisses() << " misses, " 
+                 << cachedLikelihood->getNentries() << " entries" << endl;
+            cerr << "------------------------------------------------" << endl;
+        }
     }
 
     // Print total computational time
@@ -671,6 +769,14 @@ void NestedSampler::removeLivePointsFromSample(const vector<int> &indicesOfLiveP
         clusterIndices[indicesOfLivePointsToRemove[m]] = clusterIndexCopy;
         clusterIndices.pop_back();
 
+
+        // Remove the same live point from the tree, which follows the same swapping convention
+
+        if (livePointsTreeIsEnabled)
+        {
+            livePointsTree.removePoint(indicesOfLivePointsToRemove[m]);
+        }
+
                 
         // Reduce the current number of live points by one.
                 
@@ -741,6 +847,249 @@ void NestedSampler::printComputationalTime(const double startTime)
 
 
 
+// NestedSampler::computeClusterSums()
+//
+// PURPOSE:
+//      Compute for each cluster the sum of the coordinates and of the squared coordinates
+//      of its live points. These sums are updated incrementally during the nesting process,
+//      so that the mean and the spread of each cluster can be monitored at a cost independent
+//      of the number of live points.
+//
+// INPUT:
+//      Nclusters:          The number of clusters of the current clustering
+//      clusterIndices:     For each live point, the index of the cluster it belongs to
+//
+// OUTPUT:
+//      void
+//
+
+void NestedSampler::computeClusterSums(const unsigned int Nclusters, const vector<int> &clusterIndices)
+{
+    clusterSumOfCoordinates = ArrayXXd::Zero(Ndimensions, Nclusters);
+    clusterSumOfSquaredCoordinates = ArrayXXd::Zero(Ndimensions, Nclusters);
+
+    for (int n = 0; n < nestedSample.cols(); ++n)
+    {
+        clusterSumOfCoordinates.col(clusterIndices[n]) += nestedSample.col(n);
+        clusterSumOfSquaredCoordinates.col(clusterIndices[n]) += nestedSample.col(n).square();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::resetDriftStatistics()
+//
+// PURPOSE:
+//      Store the mean and the spread (trace of the covariance matrix) of each cluster of
+//      a new clustering, against which the drift of the live sample is measured, and reset
+//      the acceptance rate statistics.
+//
+// INPUT:
+//      Nclusters:          The number of clusters of the new clustering
+//      clusterIndices:     For each live point, the index of the cluster it belongs to
+//      clusterSizes:       The number of live points in each cluster
+//
+// OUTPUT:
+//      void
+//
+
+void NestedSampler::resetDriftStatistics(const unsigned int Nclusters, const vector<int> &clusterIndices, 
+                                         const vector<int> &clusterSizes)
+{
+    computeClusterSums(Nclusters, clusterIndices);
+
+    referenceClusterMeans = ArrayXXd::Zero(Ndimensions, Nclusters);
+    referenceClusterSpreads = ArrayXd::Zero(Nclusters);
+    referenceClusterSizes = clusterSizes;
+
+    for (unsigned int i = 0; i < Nclusters; ++i)
+    {
+        if (clusterSizes[i] < 2) continue;
+
+        referenceClusterMeans.col(i) = clusterSumOfCoordinates.col(i) / clusterSizes[i];
+        referenceClusterSpreads(i) = (clusterSumOfSquaredCoordinates.col(i) / clusterSizes[i] 
+                                      - referenceClusterMeans.col(i).square()).sum();
+    }
+
+
+    NnewPointsSinceClustering = 0;
+    NdrawAttemptsSinceClustering = 0;
+    smoothedNdrawAttempts = 0.0;
+    referenceAcceptanceRate = 0.0;
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::updateDriftStatistics()
+//
+// PURPOSE:
+//      Assign a new live point to the cluster with the closest mean, update the cluster sums
+//      after it replaced a live point, and update the smoothed number of draw attempts of the sampler.
+//
+// INPUT:
+//      removedPoint:       The coordinates of the live point that was replaced
+//      newPoint:           The coordinates of the new live point
+//      clusterIndex:       As input the index of the cluster of the replaced point, as output the
+//                          index of the cluster of the new point
+//      clusterSizes:       The number of live points in each cluster, updated if the new point 
+//                          belongs to another cluster than the replaced point
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      By default a new point simply inherits the cluster of the point it replaces, wherever it
+//      was drawn. Assigning it instead to the closest cluster (as in the assignment step of k-means) 
+//      keeps the clusters meaningful between two clusterings, so that the cluster sums monitor the 
+//      drift of the live sample rather than the inherited cluster indices.
+//      The acceptance rate is estimated from NdrawAttempts, which is set by drawWithConstraint().
+//
+
+void NestedSampler::updateDriftStatistics(RefArrayXd const removedPoint, RefArrayXd const newPoint, int &clusterIndex, 
+                                          vector<int> &clusterSizes)
+{
+    clusterSumOfCoordinates.col(clusterIndex) -= removedPoint;
+    clusterSumOfSquaredCoordinates.col(clusterIndex) -= removedPoint.square();
+    --clusterSizes[clusterIndex];
+
+
+    // Find the cluster whose mean is closest to the new point
+
+    double distanceToClosestCluster = numeric_limits<double>::max();
+
+    for (int i = 0; i < clusterSumOfCoordinates.cols(); ++i)
+    {
+        if (clusterSizes[i] == 0) continue;
+
+        ArrayXd clusterMean = clusterSumOfCoordinates.col(i) / clusterSizes[i];
+        double distance = metric.distance(newPoint, clusterMean);
+
+        if (distance < distanceToClosestCluster)
+        {
+            clusterIndex = i;
+            distanceToClosestCluster = distance;
+        }
+    }
+
+    clusterSumOfCoordinates.col(clusterIndex) += newPoint;
+    clusterSumOfSquaredCoordinates.col(clusterIndex) += newPoint.square();
+    ++clusterSizes[clusterIndex];
+
+
+    // The acceptance rate during the first minNiterationsBetweenClusterings iterations after the
+    // clustering serves as a reference. Afterwards, the number of draw attempts is smoothed with 
+    // an exponential moving average, because a single number of attempts is a very noisy estimate.
+
+    const double smoothingFactor = 0.1;
+
+    NnewPointsSinceClustering++;
+    NdrawAttemptsSinceClustering += max(NdrawAttempts, 1);
+
+    if (NnewPointsSinceClustering <= minNiterationsBetweenClusterings)
+    {
+        referenceAcceptanceRate = double(NnewPointsSinceClustering) / NdrawAttemptsSinceClustering;
+        smoothedNdrawAttempts = 1.0 / referenceAcceptanceRate;
+    }
+    else
+    {
+        smoothedNdrawAttempts = (1.0 - smoothingFactor) * smoothedNdrawAttempts + smoothingFactor * max(NdrawAttempts, 1);
+    }
+
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::clusteringHasDrifted()
+//
+// PURPOSE:
+//      Decide whether the live sample drifted far enough from the last clustering
+//      to justify a new clustering. This is the case when either
+//      - the smoothed acceptance rate dropped below a fraction minAcceptanceRateFraction of 
+//        the acceptance rate right after the last clustering;
+//      - the mean of a cluster moved, or the spread of a cluster changed, by more than a 
+//        fraction maxRelativeShift of the size of the cluster at the last clustering;
+//      - a cluster became too small to build an ellipsoid around it.
+//      Apart from the last case, a new clustering is never done within minNiterationsBetweenClusterings 
+//      iterations of the previous one, and always after maxNiterationsBetweenClusterings iterations.
+//
+// INPUT:
+//      clusterSizes:       The number of live points in each cluster
+//
+// OUTPUT:
+//      True if a new clustering should be done, false otherwise.
+//
+// REMARKS:
+//      The size of a cluster is measured as the square root of the trace of its covariance matrix.
+//
+
+bool NestedSampler::clusteringHasDrifted(const vector<int> &clusterSizes)
+{
+    // A cluster that became too small to be enclosed by an ellipsoid leaves its points uncovered,
+    // hence recluster right away.
+
+    const int minClusterSize = Ndimensions + 1;
+
+    for (size_t i = 0; i < clusterSizes.size(); ++i)
+    {
+        if ((referenceClusterSizes[i] >= minClusterSize) && (clusterSizes[i] < minClusterSize)) return true;
+    }
+
+    int NiterationsSinceClustering = Niterations - lastClusteringIteration;
+
+    if (NiterationsSinceClustering < minNiterationsBetweenClusterings) return false;
+    if (NiterationsSinceClustering >= maxNiterationsBetweenClusterings) return true;
+
+    if (1.0 / smoothedNdrawAttempts < minAcceptanceRateFraction * referenceAcceptanceRate) return true;
+
+    for (int i = 0; i < clusterSumOfCoordinates.cols(); ++i)
+    {
+        if ((clusterSizes[i] < 2) || (referenceClusterSpreads(i) <= 0.0)) continue;
+
+        ArrayXd clusterMean = clusterSumOfCoordinates.col(i) / clusterSizes[i];
+        double clusterSpread = (clusterSumOfSquaredCoordinates.col(i) / clusterSizes[i] - clusterMean.square()).sum();
+        double squaredShift = (clusterMean - referenceClusterMeans.col(i)).square().sum();
+
+        if (squaredShift > maxRelativeShift * maxRelativeShift * referenceClusterSpreads(i)) return true;
+        if (fabs(clusterSpread / referenceClusterSpreads(i) - 1.0) > maxRelativeShift) return true;
+    }
+
+    return false;
+}
+
+
+
+
+
+
+
+
+
+
+
 // NestedSampler::getNiterations()
 //
 // PURPOSE:
@@ -1095,6 +1444,252 @@ ArrayXd NestedSampler::getLogLikelihood()
 
 
 
+
+// NestedSampler::setLivePointsTreeEnabled()
+//
+// PURPOSE:
+//      Choose whether a k-d tree over the live points is kept up to date during 
+//      the nesting process, for nearest-neighbour and range queries on the live 
+//      sample (see getLivePointsTree()).
+//
+// INPUT:
+//      isEnabled: true to keep the tree up to date, false otherwise (the default).
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The sampler itself does not query the tree, so that keeping it up to date is 
+//      only worthwhile for code that does, e.g. a derived sampler or a reducer. 
+//      It has to be enabled before calling run().
+//
+
+void NestedSampler::setLivePointsTreeEnabled(const bool isEnabled)
+{
+    livePointsTreeIsEnabled = isEnabled;
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::getLivePointsTreeEnabled()
+//
+// PURPOSE:
+//      Get protected data member livePointsTreeIsEnabled.
+//
+// OUTPUT:
+//      True if the k-d tree over the live points is kept up to date, false otherwise.
+//
+
+bool NestedSampler::getLivePointsTreeEnabled()
+{
+    return livePointsTreeIsEnabled;
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::getLivePointsTree()
+//
+// PURPOSE:
+//      Get protected data member livePointsTree.
+//
+// OUTPUT:
+//      A reference to the k-d tree built over the current set of live points.
+//      Indices in the tree correspond to the column indices in nestedSample.
+//
+// REMARKS:
+//      A reference rather than a copy is returned, so that nearest-neighbour and
+//      range queries can be done on the live sample without rebuilding the tree.
+//      The tree is only built if it was enabled with setLivePointsTreeEnabled().
+//
+
+KdTree &NestedSampler::getLivePointsTree()
+{
+    assert(livePointsTreeIsEnabled);
+
+    return livePointsTree;
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::getNclusterings()
+//
+// PURPOSE:
+//      Get private data member Nclusterings.
+//
+// OUTPUT:
+//      An unsigned integer containing the number of times the clusterer was called
+//      during the nesting process.
+//
+
+unsigned int NestedSampler::getNclusterings()
+{
+    return Nclusterings;
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::setSurrogate()
+//
+// PURPOSE:
+//      Use a surrogate of the log-likelihood to skip the evaluation of candidate points 
+//      that are almost certainly below the likelihood constraint. This is only worthwhile
+//      for likelihoods that are expensive to evaluate.
+//
+// INPUT:
+//      newSurrogate: pointer to the surrogate, or nullptr to evaluate all candidate points
+//                    (the default). The surrogate is not owned by the sampler.
+//
+// OUTPUT:
+//      void
+//
+
+void NestedSampler::setSurrogate(GaussianProcessSurrogate *newSurrogate)
+{
+    surrogate = newSurrogate;
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::getSurrogate()
+//
+// PURPOSE:
+//      Get protected data member surrogate.
+//
+// OUTPUT:
+//      A pointer to the surrogate of the log-likelihood, or nullptr if none is used.
+//
+
+GaussianProcessSurrogate *NestedSampler::getSurrogate()
+{
+    return surrogate;
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::setDriftTriggeredClustering()
+//
+// PURPOSE:
+//      Choose between a fixed clustering schedule (a new clustering every NiterationsWithSameClustering
+//      iterations, after NinitialIterationsWithoutClustering iterations with a single cluster), 
+//      and a clustering triggered by the drift of the live sample away from the last clustering.
+//
+// INPUT:
+//      isEnabled:                          If true, use the drift-triggered clustering, otherwise the fixed schedule.
+//      minAcceptanceRateFraction:          Recluster when the smoothed acceptance rate of the sampler drops below 
+//                                          this fraction of the acceptance rate right after the last clustering.
+//      maxRelativeShift:                   Recluster when the mean of a cluster moved, or its spread changed, by more than 
+//                                          this fraction of the size of the cluster at the last clustering.
+//      minNiterationsBetweenClusterings:   The minimum number of iterations between two clusterings.
+//      maxNiterationsBetweenClusterings:   The maximum number of iterations between two clusterings.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      With drift-triggered clustering, stable phases of the nesting process skip the clustering,
+//      while rapidly shrinking phases are reclustered promptly. The live sample is considered as 
+//      a single cluster until the first trigger fires.
+//
+
+void NestedSampler::setDriftTriggeredClustering(const bool isEnabled, const double minAcceptanceRateFraction, 
+                                                const double maxRelativeShift,
+                                                const int minNiterationsBetweenClusterings, 
+                                                const int maxNiterationsBetweenClusterings)
+{
+    assert((minAcceptanceRateFraction >= 0.0) && (minAcceptanceRateFraction <= 1.0));
+    assert(maxRelativeShift > 0.0);
+    assert((minNiterationsBetweenClusterings > 0) && (minNiterationsBetweenClusterings <= maxNiterationsBetweenClusterings));
+
+    driftTriggeredClusteringIsEnabled = isEnabled;
+    this->minAcceptanceRateFraction = minAcceptanceRateFraction;
+    this->maxRelativeShift = maxRelativeShift;
+    this->minNiterationsBetweenClusterings = minNiterationsBetweenClusterings;
+    this->maxNiterationsBetweenClusterings = maxNiterationsBetweenClusterings;
+}
+
+
+
+
+
+
+
+
+
+
+
+// NestedSampler::getDriftTriggeredClustering()
+//
+// PURPOSE:
+//      Get private data member driftTriggeredClusteringIsEnabled.
+//
+// OUTPUT:
+//      A boolean that is true if the clustering is triggered by the drift of the live sample, 
+//      and false if a fixed clustering schedule is used.
+//
+
+bool NestedSampler::getDriftTriggeredClustering()
+{
+    return driftTriggeredClusteringIsEnabled;
+}
+
+
+
+
+
+
+
+
+
+
+
 // NestedSampler::setLogEvidence()
 //
 // PURPOSE:
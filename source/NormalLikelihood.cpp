@@ -14,9 +14,18 @@
 
 NormalLikelihood::NormalLikelihood(const RefArrayXd observations, const RefArrayXd uncertainties, Model &model)
 : Likelihood(observations, model),
-  uncertainties(uncertainties)
+  uncertainties(uncertainties),
+  linearParametersLogPriorVolume(0.0)
 {
     assert(observations.size() || uncertainties.size());
+
+
+    // The terms of the log-likelihood that only depend on the data are computed once
+
+    double n = observations.size();
+
+    inverseSquaredUncertainties = uncertainties.square().inverse();
+    normalizationConstant = -0.5 * n * n * log(2.0*Functions::PI) - uncertainties.log().sum();
 }
 
 
@@ -46,6 +55,64 @@ NormalLikelihood::~NormalLikelihood()
 
 
 
+
+// NormalLikelihood::prepareSinglePrecision()
+//
+// PURPOSE:
+//      Compute the single precision copies of the data, if they do not exist yet
+//      (see Likelihood::prepareSinglePrecision()).
+//
+// OUTPUT:
+//      void
+//
+
+void NormalLikelihood::prepareSinglePrecision()
+{
+    Likelihood::prepareSinglePrecision();
+
+    if (inverseSquaredUncertaintiesSinglePrecision.size() != inverseSquaredUncertainties.size())
+    {
+        inverseSquaredUncertaintiesSinglePrecision = inverseSquaredUncertainties.cast<float>();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// NormalLikelihood::fingerprint()
+//
+// PURPOSE:
+//      Compute a hash of everything the log-likelihood values depend on,
+//      apart from the free parameters (see Likelihood::fingerprint()).
+//
+// OUTPUT:
+//      The hash of the base class, combined with the uncertainties and the prior
+//      volume of the marginalized linear parameters.
+//
+
+unsigned long long NormalLikelihood::fingerprint()
+{
+    unsigned long long hash = Likelihood::fingerprint();
+    hash = Functions::fnv1aHash(uncertainties.data(), uncertainties.size() * sizeof(double), hash);
+    hash = Functions::fnv1aHash(&linearParametersLogPriorVolume, sizeof(double), hash);
+
+    return hash;
+}
+
+
+
+
+
+
+
+
+
 // NormalLikelihood::getUncertainties();
 //
 // PURPOSE:
@@ -82,22 +149,260 @@ ArrayXd NormalLikelihood::getUncertainties()
 //      a double number containing the natural logarithm of the
 //      normal likelihood
 //
+// REMARKS:
+//      The constant term normalizationConstant is computed at construction.
+//      The terms are summed per segment of observations (see Likelihood::sumOverSegments()),
+//      with or without threads, so that the result does not depend on the number of threads.
+//      In single precision mode, the terms are computed in single precision
+//      and summed in double precision (see Likelihood::setSinglePrecision()).
+//      If the model has linear parameters, they are marginalized (see 
+//      marginalizedLogValue()).
+//
 
 double NormalLikelihood::logValue(RefArrayXd modelParameters)
 {
-    ArrayXd predictions;
-    ArrayXd lambda;
-    ArrayXd lambda0;
-    
-    predictions.resize(observations.size());
-    predictions.setZero();
-    model.predict(predictions, modelParameters);
-    
-    lambda0 = -0.5 * observations.size() * log(2.0*Functions::PI) -1.0 * uncertainties.log(); 
-    lambda = lambda0 - 0.5 * ((observations - predictions)*(observations - predictions)) / (uncertainties*uncertainties);
-    
-    return lambda.sum();
+    if (model.getNlinearParameters() > 0)
+    {
+        VectorXd bestLinearParameters;
+        return marginalizedLogValue(modelParameters, bestLinearParameters);
+    }
+
+    if (singlePrecisionIsUsed)
+    {
+        ArrayXf &predictions = getSinglePrecisionPredictionsWorkspace();
+
+        predictions.setZero();
+        model.predictSinglePrecision(predictions, modelParameters);
+
+
+        // The weighted squared residuals overwrite the predictions, and are summed in double precision
+
+        predictions = (observationsSinglePrecision - predictions).square() * inverseSquaredUncertaintiesSinglePrecision;
+
+        return normalizationConstant - 0.5 * Functions::compensatedSum(predictions);
+    }
+
+    auto weightedSumOfSquaredResiduals = [this](const int beginIndex, RefArrayXd predictions)
+    {
+        const int length = predictions.size();
+
+        return ((observations.segment(beginIndex, length) - predictions).square() 
+                * inverseSquaredUncertainties.segment(beginIndex, length)).sum();
+    };
+
+    return normalizationConstant - 0.5 * sumOverSegments(modelParameters, weightedSumOfSquaredResiduals);
 }
 
 
 
+
+
+
+
+
+
+// NormalLikelihood::logValue()
+//
+// PURPOSE:
+//      Compute the natural logarithm of the normal likelihood, but stop as soon as
+//      it is certain to be below a given threshold.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//                       values of the free parameters that describe the model.
+//      logLikelihoodThreshold: the value below which the exact log-likelihood is not needed
+//
+// OUTPUT:
+//      The natural logarithm of the normal likelihood if it is at least logLikelihoodThreshold,
+//      otherwise an upper bound of it that is smaller than logLikelihoodThreshold.
+//
+// REMARKS:
+//      Each term -0.5 * residual^2 / uncertainty^2 is negative, so that the normalization
+//      constant plus the partial sum of the terms is an upper bound of the log-likelihood.
+//      In single precision mode, with several threads, or when linear parameters are 
+//      marginalized, the exact value is always computed.
+//
+
+double NormalLikelihood::logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold)
+{
+    if (singlePrecisionIsUsed || (getNthreads() > 1) || (model.getNlinearParameters() > 0))
+    {
+        return logValue(modelParameters);
+    }
+
+    auto weightedSumOfSquaredResiduals = [this](const int beginIndex, RefArrayXd predictions)
+    {
+        const int length = predictions.size();
+
+        return ((observations.segment(beginIndex, length) - predictions).square() 
+                * inverseSquaredUncertainties.segment(beginIndex, length)).sum();
+    };
+
+    auto upperBound = [this](const int NsegmentsDone, const double partialSum)
+    {
+        return normalizationConstant - 0.5 * partialSum;
+    };
+
+    return boundedSumOverSegments(modelParameters, logLikelihoodThreshold, weightedSumOfSquaredResiduals, upperBound);
+}
+
+
+
+
+
+
+
+
+
+// NormalLikelihood::setLinearParametersLogPriorVolume()
+//
+// PURPOSE:
+//      Set the natural logarithm of the volume of the uniform prior of the linear
+//      parameters of the model, which are marginalized analytically.
+//
+// INPUT:
+//      newLogPriorVolume: log of the product of the widths of the uniform priors of 
+//                         the linear parameters. The prior should be wide enough to 
+//                         contain the likelihood of the linear parameters.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The default is zero, i.e. a unit volume. This only shifts the log-likelihood
+//      (and the log-evidence) by a constant, but it is needed to compare the evidence 
+//      of models with different linear parameters.
+//
+
+void NormalLikelihood::setLinearParametersLogPriorVolume(const double newLogPriorVolume)
+{
+    linearParametersLogPriorVolume = newLogPriorVolume;
+}
+
+
+
+
+
+
+
+
+
+// NormalLikelihood::getLinearParametersLogPriorVolume()
+//
+// PURPOSE:
+//      Get private data member linearParametersLogPriorVolume.
+//
+// OUTPUT:
+//      The natural logarithm of the volume of the uniform prior of the linear parameters.
+//
+
+double NormalLikelihood::getLinearParametersLogPriorVolume()
+{
+    return linearParametersLogPriorVolume;
+}
+
+
+
+
+
+
+
+
+
+// NormalLikelihood::getLinearParameters()
+//
+// PURPOSE:
+//      Compute the best-fitting values of the linear parameters of the model, for given
+//      values of the free parameters. These are also the means of the conditional posterior
+//      of the linear parameters, so that they can be computed for the posterior sample of
+//      the free parameters after the nested sampling.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the values of the free 
+//                       (non-linear) parameters of the model.
+//
+// OUTPUT:
+//      The weighted least-squares solution for the linear parameters.
+//
+
+ArrayXd NormalLikelihood::getLinearParameters(RefArrayXd const modelParameters)
+{
+    assert(model.getNlinearParameters() > 0);
+
+    VectorXd bestLinearParameters;
+    marginalizedLogValue(modelParameters, bestLinearParameters);
+
+    return bestLinearParameters.array();
+}
+
+
+
+
+
+
+
+
+
+// NormalLikelihood::marginalizedLogValue()
+//
+// PURPOSE:
+//      Compute the natural logarithm of the normal likelihood, integrated over the linear 
+//      parameters of the model with a uniform prior.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the values of the free
+//                       (non-linear) parameters of the model.
+//      bestLinearParameters: the weighted least-squares solution for the linear parameters
+//
+// OUTPUT:
+//      The natural logarithm of the marginalized likelihood.
+//
+// REMARKS:
+//      With the residuals r = observations - predict(), the design matrix A and the weights
+//      W = 1/uncertainties^2, the normal matrix M = A^T W A and b = A^T W r, the likelihood 
+//      is a Gaussian in the linear parameters centred at M^{-1} b. Its integral gives
+//          log L = normalizationConstant - 0.5 * (r^T W r - b^T M^{-1} b)
+//                  + 0.5 * Nlinear * log(2 pi) - 0.5 * log|M| - linearParametersLogPriorVolume
+//      The cost is O(Nobservations * Nlinear^2) for M, plus a Nlinear x Nlinear solve.
+//
+
+double NormalLikelihood::marginalizedLogValue(RefArrayXd const modelParameters, VectorXd &bestLinearParameters)
+{
+    const int Nobservations = observations.size();
+    const int NlinearParameters = model.getNlinearParameters();
+    ArrayXd &residuals = getPredictionsWorkspace();
+    ArrayXXd &designMatrix = getMatrixWorkspace(0, Nobservations, NlinearParameters);
+    ArrayXXd &weightedDesignMatrix = getMatrixWorkspace(1, Nobservations, NlinearParameters);
+
+    residuals.setZero();
+    model.predict(residuals, modelParameters);
+    residuals = observations - residuals;
+
+    designMatrix.setZero();
+    model.predictDesignMatrix(designMatrix, modelParameters);
+    weightedDesignMatrix = designMatrix.colwise() * inverseSquaredUncertainties;
+
+
+    // Weighted least-squares solution for the linear parameters, from the normal equations
+
+    MatrixXd normalMatrix = designMatrix.matrix().transpose() * weightedDesignMatrix.matrix();
+    VectorXd projections = weightedDesignMatrix.matrix().transpose() * residuals.matrix();
+    LDLT<MatrixXd> decomposition(normalMatrix);
+
+    if ((decomposition.vectorD().array() <= 0.0).any())
+    {
+        // The columns of the design matrix are linearly dependent, so that the 
+        // likelihood is not integrable over the linear parameters
+
+        bestLinearParameters = VectorXd::Zero(NlinearParameters);
+        return numeric_limits<double>::lowest();
+    }
+
+    bestLinearParameters = decomposition.solve(projections);
+
+    double minimumChiSquare = (residuals.square() * inverseSquaredUncertainties).sum() - projections.dot(bestLinearParameters);
+    double logDeterminant = decomposition.vectorD().array().log().sum();
+
+    return normalizationConstant - 0.5 * minimumChiSquare + 0.5 * NlinearParameters * log(2.0*Functions::PI)
+           - 0.5 * logDeterminant - linearParametersLogPriorVolume;
+}
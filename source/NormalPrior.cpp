@@ -27,14 +27,6 @@ NormalPrior::NormalPrior(RefArrayXd const mean, RefArrayXd const standardDeviati
         cerr << "Normal Prior hyper parameters are not correctly typeset." << endl;
         exit(EXIT_FAILURE);
     }
-
-    normalDistributionVector.resize(mean.size());
-
-    for (int i = 0; i < mean.size(); i++)
-    {
-        normal_distribution<double> normal(mean(i),standardDeviation(i));
-        normalDistributionVector[i] = normal;
-    }
 }
 
 
@@ -222,14 +214,14 @@ void NormalPrior::draw(RefArrayXXd drawnSample)
     int Npoints = drawnSample.cols();
  
     
-    // Normal sampling over all free parameters and points 
+    // Normal sampling over all free parameters and points, drawn in bulk from the
+    // standard normal distribution and then rescaled to the mean and SDV of each free parameter
+
+    engine.fillNormalSample(drawnSample);
 
-    for (int i = 0; i < Ndimensions; i++)
+    for (int j = 0; j < Npoints; j++)
     {
-        for (int j = 0; j < Npoints; j++)
-        {
-            drawnSample(i,j) = normalDistributionVector[i](engine);
-        }
+        drawnSample.col(j) = drawnSample.col(j) * standardDeviation + mean;
     }
 
 }
@@ -265,10 +257,8 @@ void NormalPrior::drawWithConstraint(RefArrayXd drawnPoint, Likelihood &likeliho
     
     do
     {
-        for (int i = 0; i < Ndimensions; i++)
-        {
-            drawnPoint(i) = normalDistributionVector[i](engine);
-        }
+        engine.fillNormal(drawnPoint);
+        drawnPoint = drawnPoint * standardDeviation + mean;
     
         logLikelihood = likelihood.logValue(drawnPoint);
     }
@@ -0,0 +1,195 @@
+#include "ParameterQuantizer.h"
+
+
+
+// ParameterQuantizer::ParameterQuantizer()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      quantizationSteps: for each free parameter, the step of the grid to which it
+//                         is rounded. A zero step keeps the exact values of that parameter.
+//
+
+ParameterQuantizer::ParameterQuantizer(const RefArrayXd quantizationSteps)
+: quantizationSteps(quantizationSteps)
+{
+    assert((quantizationSteps >= 0.0).all());
+}
+
+
+
+
+
+
+
+
+
+// ParameterQuantizer::~ParameterQuantizer()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+ParameterQuantizer::~ParameterQuantizer()
+{
+
+}
+
+
+
+
+
+
+
+
+
+// ParameterQuantizer::makeKey()
+//
+// PURPOSE:
+//      Compute the key of the node of the grid nearest to a set of model parameters.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//                       values of the free parameters that describe the model.
+//
+// OUTPUT:
+//      For each parameter, the index of the nearest multiple of its quantization 
+//      step, or the bit pattern of its value if the step is zero.
+//
+
+ParameterQuantizer::Key ParameterQuantizer::makeKey(RefArrayXd const modelParameters)
+{
+    assert(modelParameters.size() == quantizationSteps.size());
+
+    Key key(modelParameters.size());
+
+    for (int i = 0; i < modelParameters.size(); ++i)
+    {
+        double value = modelParameters(i);
+
+        if (quantizationSteps(i) > 0.0)
+        {
+            key[i] = llround(value / quantizationSteps(i));
+        }
+        else
+        {
+            memcpy(&key[i], &value, sizeof(double));
+        }
+    }
+
+    return key;
+}
+
+
+
+
+
+
+
+
+
+// ParameterQuantizer::getNode()
+//
+// PURPOSE:
+//      Compute the model parameters of the node of the grid with a given key.
+//
+// INPUT:
+//      key: the key of the node, as computed by makeKey()
+//
+// OUTPUT:
+//      The parameters of the node. They only depend on the key, so that the 
+//      log-likelihood computed at the node does not depend on which point 
+//      of the grid cell was evaluated first.
+//
+
+ArrayXd ParameterQuantizer::getNode(const Key &key)
+{
+    assert(key.size() == static_cast<size_t>(quantizationSteps.size()));
+
+    ArrayXd node(quantizationSteps.size());
+
+    for (int i = 0; i < quantizationSteps.size(); ++i)
+    {
+        if (quantizationSteps(i) > 0.0)
+        {
+            node(i) = key[i] * quantizationSteps(i);
+        }
+        else
+        {
+            memcpy(&node(i), &key[i], sizeof(double));
+        }
+    }
+
+    return node;
+}
+
+
+
+
+
+
+
+
+
+// ParameterQuantizer::getQuantizationSteps()
+//
+// PURPOSE:
+//      Get private data member quantizationSteps.
+//
+// OUTPUT:
+//      For each free parameter, the step of the grid (zero for exact values).
+//
+
+ArrayXd ParameterQuantizer::getQuantizationSteps()
+{
+    return quantizationSteps;
+}
+
+
+
+
+
+
+
+
+
+// ParameterQuantizer::getNdimensions()
+//
+// PURPOSE:
+//      Get the number of free parameters.
+//
+// OUTPUT:
+//      The number of quantization steps.
+//
+
+int ParameterQuantizer::getNdimensions()
+{
+    return quantizationSteps.size();
+}
+
+
+
+
+
+
+
+
+
+// ParameterQuantizer::KeyHash::operator()
+//
+// PURPOSE:
+//      Hash function of the keys (FNV-1a over the elements of the key).
+//
+// INPUT:
+//      key: the key of a node of the grid
+//
+// OUTPUT:
+//      The hash value of the key.
+//
+
+size_t ParameterQuantizer::KeyHash::operator()(const Key &key) const
+{
+    return static_cast<size_t>(Functions::fnv1aHash(key.data(), key.size() * sizeof(long long)));
+}
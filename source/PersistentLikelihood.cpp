@@ -0,0 +1,703 @@
+#include "PersistentLikelihood.h"
+
+
+namespace
+{
+    const char magicString[8] = {'D', 'I', 'A', 'M', 'O', 'N', 'D', 'S'};
+    const uint32_t formatVersion = 1;
+    const size_t headerSize = sizeof(magicString) + 2 * sizeof(uint32_t);
+}
+
+
+
+// PersistentLikelihood::PersistentLikelihood()
+//
+// PURPOSE: 
+//      Derived class constructor. Opens (or creates) the file of stored evaluations,
+//      and loads the records whose fingerprint matches the current data and model.
+//      The values of the free parameters are stored exactly.
+//
+// INPUT:
+//      likelihood: the likelihood whose values are to be stored
+//      Ndimensions: the number of free parameters
+//      fileName: the name of the file of stored evaluations
+//      modelTag: an optional string that is included in the fingerprint, to distinguish
+//                models of the same class with different settings. The fingerprint of the
+//                likelihood includes the covariates of the model, but no other setting of it.
+//
+// REMARKS:
+//      The file is a header (the string "DIAMONDS", the format version and Ndimensions),
+//      followed by fixed-size records: the fingerprint (64-bit), the key of the free 
+//      parameters (64-bit each) and the log-likelihood (double), in the native byte order. 
+//      An incomplete record at the end of the file, left by an interrupted run, is discarded.
+//      Several processes can store evaluations in the same file: the file is locked while
+//      it is read at construction, and while a record is appended.
+// 
+
+PersistentLikelihood::PersistentLikelihood(Likelihood &likelihood, const int Ndimensions, const string fileName, 
+                                           const string modelTag)
+: PersistentLikelihood(likelihood, likelihood.getObservations(), ArrayXd::Zero(Ndimensions), fileName, modelTag)
+{
+
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::PersistentLikelihood()
+//
+// PURPOSE: 
+//      Derived class constructor, as above, but with the free parameters quantized
+//      before they are looked up and stored.
+//
+// INPUT:
+//      likelihood: the likelihood whose values are to be stored
+//      quantizationSteps: for each free parameter, the step of the grid to which its
+//                         values are rounded. A step of zero keeps the exact values.
+//      fileName: the name of the file of stored evaluations
+//      modelTag: as above
+//
+// REMARKS:
+//      As for CachedLikelihood, the value stored for a node of the grid is the 
+//      log-likelihood of the node itself, so that it does not depend on the order 
+//      in which the points are evaluated. The quantization steps are included in 
+//      the fingerprint.
+// 
+
+PersistentLikelihood::PersistentLikelihood(Likelihood &likelihood, const RefArrayXd quantizationSteps, 
+                                           const string fileName, const string modelTag)
+: PersistentLikelihood(likelihood, likelihood.getObservations(), quantizationSteps, fileName, modelTag)
+{
+
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::PersistentLikelihood()
+//
+// PURPOSE: 
+//      Private constructor, to which the public constructor delegates. The copy of the
+//      observations is passed by value, so that it can be bound to the argument of
+//      the constructor of Likelihood.
+// 
+
+PersistentLikelihood::PersistentLikelihood(Likelihood &likelihood, ArrayXd observations, ArrayXd quantizationSteps, 
+                                           const string fileName, const string modelTag)
+: Likelihood(observations, likelihood.getModel()),
+  likelihood(likelihood),
+  Ndimensions(quantizationSteps.size()),
+  quantizer(quantizationSteps),
+  fileName(fileName),
+  fileDescriptor(-1),
+  recordSize(sizeof(uint64_t) + (Ndimensions + 1) * sizeof(double)),
+  NloadedEvaluations(0),
+  NreplayedEvaluations(0),
+  NstoredEvaluations(0)
+{
+    assert(Ndimensions > 0);
+
+
+    // The fingerprint of the data, the likelihood, the model and the quantization
+
+    storeFingerprint = likelihood.fingerprint();
+    storeFingerprint = Functions::fnv1aHash(modelTag.data(), modelTag.size(), storeFingerprint);
+    storeFingerprint = Functions::fnv1aHash(quantizationSteps.data(), quantizationSteps.size() * sizeof(double), 
+                                            storeFingerprint);
+
+    openFile();
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::~PersistentLikelihood()
+//
+// PURPOSE: 
+//      Derived class destructor.
+//
+
+PersistentLikelihood::~PersistentLikelihood()
+{
+    if (fileDescriptor >= 0)
+    {
+        close(fileDescriptor);
+    }
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::logValue()
+//
+// PURPOSE:
+//      Get the natural logarithm of the likelihood from the stored evaluations, 
+//      or compute it with the wrapped likelihood and append it to the file.
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//                       values of the free parameters that describe the model.
+//
+// OUTPUT:
+//      a double number containing the natural logarithm of the likelihood
+//
+
+double PersistentLikelihood::logValue(RefArrayXd const modelParameters)
+{
+    Key key = quantizer.makeKey(modelParameters);
+    double logLikelihood;
+
+    if (lookUp(key, logLikelihood))
+    {
+        return logLikelihood;
+    }
+
+    ArrayXd node = quantizer.getNode(key);
+    logLikelihood = likelihood.logValue(node);
+    store(key, logLikelihood);
+
+    return logLikelihood;
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::logValue()
+//
+// PURPOSE:
+//      As logValue() above, when only values of the log-likelihood above a threshold
+//      are of interest (see Likelihood::logValue()).
+//
+// INPUT:
+//      modelParameters: a one-dimensional array containing the actual
+//                       values of the free parameters that describe the model.
+//      logLikelihoodThreshold: the value below which the exact log-likelihood is not needed
+//
+// OUTPUT:
+//      The natural logarithm of the likelihood if it is at least logLikelihoodThreshold,
+//      otherwise an upper bound of it that is smaller than logLikelihoodThreshold.
+//
+// REMARKS:
+//      Values below the threshold may be upper bounds only, so they are not stored.
+//
+
+double PersistentLikelihood::logValue(RefArrayXd const modelParameters, const double logLikelihoodThreshold)
+{
+    Key key = quantizer.makeKey(modelParameters);
+    double logLikelihood;
+
+    if (lookUp(key, logLikelihood))
+    {
+        return logLikelihood;
+    }
+
+    ArrayXd node = quantizer.getNode(key);
+    logLikelihood = likelihood.logValue(node, logLikelihoodThreshold);
+
+    if (logLikelihood >= logLikelihoodThreshold)
+    {
+        store(key, logLikelihood);
+    }
+
+    return logLikelihood;
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::fingerprint()
+//
+// PURPOSE:
+//      Get private data member storeFingerprint.
+//
+// OUTPUT:
+//      The hash of the fingerprint of the wrapped likelihood, the model tag and the
+//      quantization steps, with which the records of this likelihood are tagged.
+//
+
+unsigned long long PersistentLikelihood::fingerprint()
+{
+    return storeFingerprint;
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::getNloadedEvaluations()
+//
+// PURPOSE:
+//      Get private data member NloadedEvaluations.
+//
+// OUTPUT:
+//      The number of evaluations with the same fingerprint found in the file at construction.
+//
+
+unsigned long PersistentLikelihood::getNloadedEvaluations()
+{
+    return NloadedEvaluations;
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::getNreplayedEvaluations()
+//
+// PURPOSE:
+//      Get private data member NreplayedEvaluations.
+//
+// OUTPUT:
+//      The number of log-likelihood values that were taken from the stored evaluations.
+//
+
+unsigned long PersistentLikelihood::getNreplayedEvaluations()
+{
+    lock_guard<mutex> lock(storeMutex);
+
+    return NreplayedEvaluations;
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::getNstoredEvaluations()
+//
+// PURPOSE:
+//      Get private data member NstoredEvaluations.
+//
+// OUTPUT:
+//      The number of evaluations appended to the file by this object.
+//
+
+unsigned long PersistentLikelihood::getNstoredEvaluations()
+{
+    lock_guard<mutex> lock(storeMutex);
+
+    return NstoredEvaluations;
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::lookUp()
+//
+// PURPOSE:
+//      Look up the stored log-likelihood value of a key.
+//
+// INPUT:
+//      key: the key of the model parameters
+//      logLikelihood: the stored value, if found
+//
+// OUTPUT:
+//      True if the key was found, false otherwise.
+//
+
+bool PersistentLikelihood::lookUp(const Key &key, double &logLikelihood)
+{
+    lock_guard<mutex> lock(storeMutex);
+
+    auto found = logLikelihoodOfKey.find(key);
+
+    if (found == logLikelihoodOfKey.end())
+    {
+        return false;
+    }
+
+    logLikelihood = found->second;
+    NreplayedEvaluations++;
+
+    return true;
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::store()
+//
+// PURPOSE:
+//      Append an evaluation to the file, and add it to the stored evaluations.
+//
+// INPUT:
+//      key: the key of the model parameters
+//      logLikelihood: the log-likelihood of the model parameters
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Each record is written with a single call to write() on a file opened in
+//      append mode, so that an interruption leaves at most one incomplete record.
+//      The write is done under an exclusive advisory lock of the file, shared by all
+//      processes that store evaluations in it. An incomplete record left by an interrupted 
+//      process is discarded first, so that the new record starts at a record boundary.
+//
+
+void PersistentLikelihood::store(const Key &key, const double logLikelihood)
+{
+    lock_guard<mutex> lock(storeMutex);
+
+    if (logLikelihoodOfKey.count(key) > 0) return;
+
+    logLikelihoodOfKey[key] = logLikelihood;
+
+    vector<char> record(recordSize);
+    uint64_t recordFingerprint = storeFingerprint;
+
+    memcpy(record.data(), &recordFingerprint, sizeof(uint64_t));
+    memcpy(record.data() + sizeof(uint64_t), key.data(), Ndimensions * sizeof(long long));
+    memcpy(record.data() + sizeof(uint64_t) + Ndimensions * sizeof(double), &logLikelihood, sizeof(double));
+
+    lockFile();
+    countCompleteRecords();
+
+    if (write(fileDescriptor, record.data(), recordSize) != static_cast<ssize_t>(recordSize))
+    {
+        cerr << "PersistentLikelihood: cannot append to file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    unlockFile();
+
+    NstoredEvaluations++;
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::openFile()
+//
+// PURPOSE:
+//      Open the file of stored evaluations in append mode, create its header if it is
+//      new, or check its header and load its records otherwise.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      A non-empty file that is shorter than the header is not a store of evaluations,
+//      and is left untouched. The file is locked while its header is written or checked
+//      and its records are loaded, so that several processes can open it at the same time.
+//
+
+void PersistentLikelihood::openFile()
+{
+    fileDescriptor = open(fileName.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+
+    if (fileDescriptor < 0)
+    {
+        cerr << "PersistentLikelihood: cannot open file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    lockFile();
+
+    size_t fileSize = getFileSize();
+
+    if ((fileSize > 0) && (fileSize < headerSize))
+    {
+        cerr << "PersistentLikelihood: " << fileName << " is not a store of evaluations" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (fileSize == 0)
+    {
+        // A new (or empty) file: write the header
+
+        char header[headerSize];
+        uint32_t NdimensionsInFile = Ndimensions;
+
+        memcpy(header, magicString, sizeof(magicString));
+        memcpy(header + sizeof(magicString), &formatVersion, sizeof(uint32_t));
+        memcpy(header + sizeof(magicString) + sizeof(uint32_t), &NdimensionsInFile, sizeof(uint32_t));
+
+        if (write(fileDescriptor, header, headerSize) != static_cast<ssize_t>(headerSize))
+        {
+            cerr << "PersistentLikelihood: cannot write header of file " << fileName << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        unlockFile();
+        return;
+    }
+
+
+    // An existing file: check the header
+
+    char header[headerSize];
+    uint32_t versionInFile;
+    uint32_t NdimensionsInFile;
+
+    if (pread(fileDescriptor, header, headerSize, 0) != static_cast<ssize_t>(headerSize))
+    {
+        cerr << "PersistentLikelihood: cannot read header of file " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    memcpy(&versionInFile, header + sizeof(magicString), sizeof(uint32_t));
+    memcpy(&NdimensionsInFile, header + sizeof(magicString) + sizeof(uint32_t), sizeof(uint32_t));
+
+    if ((memcmp(header, magicString, sizeof(magicString)) != 0) || (versionInFile != formatVersion) 
+        || (NdimensionsInFile != static_cast<uint32_t>(Ndimensions)))
+    {
+        cerr << "PersistentLikelihood: " << fileName << " is not a store of evaluations with " 
+             << Ndimensions << " free parameters" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Discard an incomplete last record, and load the complete ones
+
+    loadRecords(countCompleteRecords());
+    unlockFile();
+}
+
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::countCompleteRecords()
+//
+// PURPOSE:
+//      Count the complete records of the file, and discard an incomplete last record.
+//
+// OUTPUT:
+//      The number of complete records.
+//
+// REMARKS:
+//      Should only be called with the file locked (see lockFile()). Since every process
+//      appends its records under the same lock, an incomplete record at the end of the 
+//      file cannot be one that another process is still writing: it was left by a process
+//      that was interrupted, or that failed to write it, and it would shift all the records
+//      appended after it.
+//
+
+size_t PersistentLikelihood::countCompleteRecords()
+{
+    const size_t fileSize = getFileSize();
+    const size_t Nrecords = (fileSize - headerSize) / recordSize;
+
+    if (headerSize + Nrecords * recordSize != fileSize)
+    {
+        if (ftruncate(fileDescriptor, headerSize + Nrecords * recordSize) != 0)
+        {
+            cerr << "PersistentLikelihood: cannot truncate file " << fileName << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return Nrecords;
+}
+
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::getFileSize()
+//
+// PURPOSE:
+//      Get the current size of the file, including the records appended by other processes.
+//
+// OUTPUT:
+//      The size of the file in bytes.
+//
+
+size_t PersistentLikelihood::getFileSize()
+{
+    struct stat fileStatus;
+
+    if (fstat(fileDescriptor, &fileStatus) != 0)
+    {
+        cerr << "PersistentLikelihood: cannot read the size of file " << fileName << ": " << strerror(errno) << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    return fileStatus.st_size;
+}
+
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::lockFile()
+//
+// PURPOSE:
+//      Take an exclusive advisory lock of the file, waiting for other processes to release it.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The lock belongs to the open file, and is released by unlockFile(), or by the
+//      system when the process ends. Threads of the same process are serialized by 
+//      storeMutex instead.
+//
+
+void PersistentLikelihood::lockFile()
+{
+    while (flock(fileDescriptor, LOCK_EX) != 0)
+    {
+        if (errno != EINTR)
+        {
+            cerr << "PersistentLikelihood: cannot lock file " << fileName << ": " << strerror(errno) << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::unlockFile()
+//
+// PURPOSE:
+//      Release the lock taken by lockFile().
+//
+// OUTPUT:
+//      void
+//
+
+void PersistentLikelihood::unlockFile()
+{
+    if (flock(fileDescriptor, LOCK_UN) != 0)
+    {
+        cerr << "PersistentLikelihood: cannot unlock file " << fileName << ": " << strerror(errno) << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+
+
+
+
+
+
+
+// PersistentLikelihood::loadRecords()
+//
+// PURPOSE:
+//      Map the file in memory, and add the records with the current fingerprint 
+//      to the stored evaluations.
+//
+// INPUT:
+//      Nrecords: the number of complete records in the file
+//
+// OUTPUT:
+//      void
+//
+
+void PersistentLikelihood::loadRecords(const size_t Nrecords)
+{
+    if (Nrecords == 0) return;
+
+    const size_t mappedSize = headerSize + Nrecords * recordSize;
+    void *mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+    if (mapping == MAP_FAILED)
+    {
+        cerr << "PersistentLikelihood: cannot map file " << fileName << " in memory" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    const char *record = static_cast<const char*>(mapping) + headerSize;
+    Key key(Ndimensions);
+    uint64_t recordFingerprint;
+    double logLikelihood;
+
+    logLikelihoodOfKey.reserve(Nrecords);
+
+    for (size_t n = 0; n < Nrecords; ++n, record += recordSize)
+    {
+        memcpy(&recordFingerprint, record, sizeof(uint64_t));
+
+        if (recordFingerprint != storeFingerprint) continue;
+
+        memcpy(key.data(), record + sizeof(uint64_t), Ndimensions * sizeof(long long));
+        memcpy(&logLikelihood, record + sizeof(uint64_t) + Ndimensions * sizeof(double), sizeof(double));
+        logLikelihoodOfKey[key] = logLikelihood;
+    }
+
+    NloadedEvaluations = logLikelihoodOfKey.size();
+
+    munmap(mapping, mappedSize);
+}
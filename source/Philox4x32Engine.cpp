@@ -0,0 +1,529 @@
+#include "Philox4x32Engine.h"
+
+
+// Philox4x32Engine::Philox4x32Engine()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      seed: the seed, used as the key of the generator
+//      streamIndex: the index of the stream. Streams with different indices
+//                   (or different seeds) do not overlap.
+//
+
+Philox4x32Engine::Philox4x32Engine(const uint64_t seed, const uint64_t streamIndex)
+{
+    this->seed(seed, streamIndex);
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::~Philox4x32Engine()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+Philox4x32Engine::~Philox4x32Engine()
+{
+
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::seed()
+//
+// PURPOSE:
+//      Select a stream, and go to its beginning.
+//
+// INPUT:
+//      seed: the seed, used as the key of the generator
+//      streamIndex: the index of the stream
+//
+// OUTPUT:
+//      void
+//
+
+void Philox4x32Engine::seed(const uint64_t seed, const uint64_t streamIndex)
+{
+    seedValue = seed;
+    this->streamIndex = streamIndex;
+    blockIndex = 0;
+    indexInBlock = 4;
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::seek()
+//
+// PURPOSE:
+//      Go to a given position in the current stream, in constant time.
+//
+// INPUT:
+//      position: the number of random numbers drawn since the beginning of the stream,
+//                e.g. from getPosition()
+//
+// OUTPUT:
+//      void
+//
+
+void Philox4x32Engine::seek(const uint64_t position)
+{
+    blockIndex = position / 4;
+    indexInBlock = 4;
+
+    if (position % 4 != 0)
+    {
+        generateNextBlock();
+        indexInBlock = position % 4;
+    }
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::discard()
+//
+// PURPOSE:
+//      Skip a number of random numbers, in constant time.
+//
+// INPUT:
+//      Nnumbers: the number of random numbers to be skipped
+//
+// OUTPUT:
+//      void
+//
+
+void Philox4x32Engine::discard(const uint64_t Nnumbers)
+{
+    seek(getPosition() + Nnumbers);
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::getSeed()
+//
+// PURPOSE:
+//      Get private data member seedValue.
+//
+// OUTPUT:
+//      The seed of the generator.
+//
+
+uint64_t Philox4x32Engine::getSeed()
+{
+    return seedValue;
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::getStreamIndex()
+//
+// PURPOSE:
+//      Get private data member streamIndex.
+//
+// OUTPUT:
+//      The index of the current stream.
+//
+
+uint64_t Philox4x32Engine::getStreamIndex()
+{
+    return streamIndex;
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::getPosition()
+//
+// PURPOSE:
+//      Get the number of random numbers drawn since the beginning of the stream.
+//
+// OUTPUT:
+//      The position in the stream. Together with the seed and the stream index,
+//      it is the full state of the generator, to be restored with seed() and seek().
+//
+
+uint64_t Philox4x32Engine::getPosition()
+{
+    return 4 * blockIndex - (4 - indexInBlock);
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::generateBlock()
+//
+// PURPOSE:
+//      Compute the Philox4x32-10 bijection of a counter.
+//
+// INPUT:
+//      counter: the four 32-bit words of the counter
+//      key: the two 32-bit words of the key
+//      output: the four 32-bit random words
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Each of the 10 rounds multiplies two words of the counter by fixed constants,
+//      and mixes the high and low halves of the products with the other words and the
+//      key. The key is incremented by fixed constants between rounds.
+//
+
+void Philox4x32Engine::generateBlock(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4])
+{
+    const uint32_t multiplier0 = 0xD2511F53;
+    const uint32_t multiplier1 = 0xCD9E8D57;
+    const uint32_t keyIncrement0 = 0x9E3779B9;
+    const uint32_t keyIncrement1 = 0xBB67AE85;
+
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < 10; ++round)
+    {
+        const uint64_t product0 = uint64_t(multiplier0) * c0;
+        const uint64_t product1 = uint64_t(multiplier1) * c2;
+
+        c0 = uint32_t(product1 >> 32) ^ c1 ^ k0;
+        c2 = uint32_t(product0 >> 32) ^ c3 ^ k1;
+        c1 = uint32_t(product1);
+        c3 = uint32_t(product0);
+
+        k0 += keyIncrement0;
+        k1 += keyIncrement1;
+    }
+
+    output[0] = c0;
+    output[1] = c1;
+    output[2] = c2;
+    output[3] = c3;
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::generateNextBlock()
+//
+// PURPOSE:
+//      Generate the block of random numbers of the current counter, and increment the counter.
+//
+// OUTPUT:
+//      void
+//
+
+void Philox4x32Engine::generateNextBlock()
+{
+    const uint32_t counter[4] = {uint32_t(blockIndex), uint32_t(blockIndex >> 32),
+                                 uint32_t(streamIndex), uint32_t(streamIndex >> 32)};
+    const uint32_t key[2] = {uint32_t(seedValue), uint32_t(seedValue >> 32)};
+
+    generateBlock(counter, key, block);
+    blockIndex++;
+    indexInBlock = 0;
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::fillUniform()
+//
+// PURPOSE:
+//      Fill an array with random numbers uniformly distributed in [0, 1).
+//
+// INPUT:
+//      values: the array to be filled
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Each value takes 53 random bits from two 32-bit numbers. The bulk functions start
+//      with a new block of the stream: the unused numbers of the current block are skipped.
+//
+
+void Philox4x32Engine::fillUniform(RefArrayXd values)
+{
+    generateUniforms(values.data(), values.size(), false);
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::fillNormal()
+//
+// PURPOSE:
+//      Fill an array with random numbers from the standard normal distribution.
+//
+// INPUT:
+//      values: the array to be filled
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Uses the Box-Muller transform of pairs of uniform numbers (u1, u2), with u1 in (0, 1]:
+//      sqrt(-2 log u1) cos(2 pi u2) and sqrt(-2 log u1) sin(2 pi u2) are independent standard
+//      normal numbers. Unlike the polar method of std::normal_distribution, there is no
+//      rejection step, so that whole arrays are transformed without branches.
+//      The radii and angles are kept in buffers of the engine, which are only reallocated
+//      when the size of the array changes.
+//
+
+void Philox4x32Engine::fillNormal(RefArrayXd values)
+{
+    const int Nvalues = values.size();
+    const int Npairs = (Nvalues + 1) / 2;
+    const int Nsines = Nvalues - Npairs;
+
+    radii.resize(Npairs);
+    angles.resize(Npairs);
+    generateUniforms(radii.data(), Npairs, true);
+    generateUniforms(angles.data(), Npairs, false);
+
+    radii = (-2.0 * radii.log()).sqrt();
+    angles *= 2.0 * M_PI;
+
+    // The cosine and the sine of the same angle are computed in the same loop, so that
+    // the compiler can merge them into a single call
+
+    for (int n = 0; n < Nsines; ++n)
+    {
+        values(n) = radii(n) * cos(angles(n));
+        values(Npairs + n) = radii(n) * sin(angles(n));
+    }
+
+    if (Nsines < Npairs)
+    {
+        values(Nsines) = radii(Nsines) * cos(angles(Nsines));
+    }
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::fillUniformSample()
+//
+// PURPOSE:
+//      Fill a two-dimensional array with random numbers uniformly distributed in [0, 1).
+//
+// INPUT:
+//      sample: the array to be filled, e.g. of size (Ndimensions, Npoints)
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      If the columns are stored contiguously, the array is filled in a single pass,
+//      otherwise column after column.
+//
+
+void Philox4x32Engine::fillUniformSample(RefArrayXXd sample)
+{
+    if (sample.outerStride() == sample.rows())
+    {
+        generateUniforms(sample.data(), sample.size(), false);
+        return;
+    }
+
+    for (int j = 0; j < sample.cols(); ++j)
+    {
+        fillUniform(sample.col(j));
+    }
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::fillNormalSample()
+//
+// PURPOSE:
+//      Fill a two-dimensional array with random numbers from the standard normal distribution.
+//
+// INPUT:
+//      sample: the array to be filled, e.g. of size (Ndimensions, Npoints)
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      If the columns are stored contiguously, the array is filled in a single pass,
+//      otherwise column after column.
+//
+
+void Philox4x32Engine::fillNormalSample(RefArrayXXd sample)
+{
+    if (sample.outerStride() == sample.rows())
+    {
+        Eigen::Map<ArrayXd> values(sample.data(), sample.size());
+        fillNormal(values);
+        return;
+    }
+
+    for (int j = 0; j < sample.cols(); ++j)
+    {
+        fillNormal(sample.col(j));
+    }
+}
+
+
+
+
+
+
+
+
+
+// Philox4x32Engine::generateUniforms()
+//
+// PURPOSE:
+//      Generate uniform random numbers from consecutive blocks of the stream.
+//
+// INPUT:
+//      values: pointer to the first of the numbers to be generated
+//      Nvalues: the number of values to be generated
+//      zeroIsExcluded: if true the numbers are in (0, 1], otherwise in [0, 1)
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      Blocks are generated Nlanes at a time, with the Philox rounds written as loops
+//      over the lanes, without dependencies between them, so that they are vectorized.
+//      Each block gives two values.
+//
+
+void Philox4x32Engine::generateUniforms(double *values, const int Nvalues, const bool zeroIsExcluded)
+{
+    const int Nlanes = 8;
+    const uint32_t multiplier0 = 0xD2511F53;
+    const uint32_t multiplier1 = 0xCD9E8D57;
+    const uint32_t keyIncrement0 = 0x9E3779B9;
+    const uint32_t keyIncrement1 = 0xBB67AE85;
+    const double scale = 1.0 / 9007199254740992.0;            // 2^-53
+    const double offset = (zeroIsExcluded ? 1.0 : 0.0);
+
+    uint32_t c0[Nlanes], c1[Nlanes], c2[Nlanes], c3[Nlanes];
+    indexInBlock = 4;
+
+    for (int beginIndex = 0; beginIndex < Nvalues; beginIndex += 2 * Nlanes)
+    {
+        // Only the blocks whose values are used are generated and consumed from the stream
+
+        const int NusedValues = std::min(2 * Nlanes, Nvalues - beginIndex);
+        const int NusedLanes = (NusedValues + 1) / 2;
+
+        for (int lane = 0; lane < NusedLanes; ++lane)
+        {
+            const uint64_t counter = blockIndex + lane;
+            c0[lane] = uint32_t(counter);
+            c1[lane] = uint32_t(counter >> 32);
+            c2[lane] = uint32_t(streamIndex);
+            c3[lane] = uint32_t(streamIndex >> 32);
+        }
+
+        uint32_t k0 = uint32_t(seedValue);
+        uint32_t k1 = uint32_t(seedValue >> 32);
+
+        for (int round = 0; round < 10; ++round)
+        {
+            for (int lane = 0; lane < NusedLanes; ++lane)
+            {
+                const uint64_t product0 = uint64_t(multiplier0) * c0[lane];
+                const uint64_t product1 = uint64_t(multiplier1) * c2[lane];
+
+                c0[lane] = uint32_t(product1 >> 32) ^ c1[lane] ^ k0;
+                c2[lane] = uint32_t(product0 >> 32) ^ c3[lane] ^ k1;
+                c1[lane] = uint32_t(product1);
+                c3[lane] = uint32_t(product0);
+            }
+
+            k0 += keyIncrement0;
+            k1 += keyIncrement1;
+        }
+
+
+        for (int n = 0; n < NusedValues; ++n)
+        {
+            const int lane = n / 2;
+            const uint64_t bits = (n % 2 == 0) ? ((uint64_t(c1[lane]) << 32) | c0[lane])
+                                               : ((uint64_t(c3[lane]) << 32) | c2[lane]);
+
+            values[beginIndex + n] = ((bits >> 11) + offset) * scale;
+        }
+
+        blockIndex += NusedLanes;
+    }
+}
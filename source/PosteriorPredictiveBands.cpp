@@ -0,0 +1,489 @@
+#include "PosteriorPredictiveBands.h"
+
+
+// PosteriorPredictiveBands::PosteriorPredictiveBands()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      model: the model whose predictions are computed for the posterior sample.
+//             Its predict() function should be safe to call from several threads.
+//      quantileLevels: the probabilities of the quantiles to be computed, between 0 and 1,
+//                      e.g. (0.16, 0.5, 0.84)
+//      Nthreads: the number of threads computing the predictions and updating the quantiles
+//      blockSize: the number of samples whose predictions are kept in memory at once
+//
+
+PosteriorPredictiveBands::PosteriorPredictiveBands(Model &model, const RefArrayXd quantileLevels, const int Nthreads,
+                                                   const int blockSize)
+: model(model),
+  quantileLevels(quantileLevels),
+  blockSize(blockSize),
+  Nsamples(0),
+  threadPool(Nthreads)
+{
+    assert(quantileLevels.size() > 0);
+    assert((quantileLevels > 0.0).all() && (quantileLevels < 1.0).all());
+    assert(blockSize > 0);
+}
+
+
+
+
+
+
+
+
+
+// PosteriorPredictiveBands::~PosteriorPredictiveBands()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+PosteriorPredictiveBands::~PosteriorPredictiveBands()
+{
+
+}
+
+
+
+
+
+
+
+
+
+// PosteriorPredictiveBands::compute()
+//
+// PURPOSE:
+//      Compute the quantiles of the model predictions over the posterior sample.
+//
+// INPUT:
+//      posteriorSample: two-dimensional array of size (Ndimensions, NposteriorSamples),
+//                       e.g. from NestedSampler::getPosteriorSample()
+//      posteriorProbability: the weights of the posterior samples, which need not be normalized
+//      Nsamples: the number of equally weighted samples drawn from the weighted posterior sample
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The samples are drawn with systematic resampling, which keeps each posterior sample
+//      a number of times that differs by less than one from Nsamples times its probability,
+//      and then shuffled, because the P^2 estimates are less accurate for sorted input.
+//      For each block of blockSize samples, the predictions are first computed in parallel
+//      over the samples, after which the quantile estimates are updated in parallel over
+//      the covariates. The memory used is O(Ncovariates * (blockSize + Nquantiles)).
+//
+
+void PosteriorPredictiveBands::compute(RefArrayXXd const posteriorSample, RefArrayXd const posteriorProbability,
+                                       const int Nsamples)
+{
+    assert(posteriorSample.cols() == posteriorProbability.size());
+    assert(Nsamples > 0);
+
+    this->Nsamples = Nsamples;
+
+
+    // Systematic resampling of the posterior sample
+
+    const int NposteriorSamples = posteriorProbability.size();
+    const double totalProbability = posteriorProbability.sum();
+    vector<int> sampleIndices(Nsamples);
+    double cumulatedProbability = posteriorProbability(0) / totalProbability;
+    int index = 0;
+
+    for (int n = 0; n < Nsamples; ++n)
+    {
+        const double u = (n + 0.5) / Nsamples;
+
+        while ((u > cumulatedProbability) && (index < NposteriorSamples - 1))
+        {
+            ++index;
+            cumulatedProbability += posteriorProbability(index) / totalProbability;
+        }
+
+        sampleIndices[n] = index;
+    }
+
+    Philox4x32Engine engine = RandomStreams::getStream("PosteriorPredictiveBands", Nsamples);
+    shuffle(sampleIndices.begin(), sampleIndices.end(), engine);
+
+
+    // Reset the quantile estimators of all covariates
+
+    const int Ncovariates = model.getCovariates().size();
+    const int Nquantiles = quantileLevels.size();
+
+    estimators.resize(Ncovariates * Nquantiles);
+
+    for (int covariate = 0; covariate < Ncovariates; ++covariate)
+    {
+        for (int quantile = 0; quantile < Nquantiles; ++quantile)
+        {
+            resetQuantileEstimator(estimators[covariate * Nquantiles + quantile], quantileLevels(quantile));
+        }
+    }
+
+
+    // Process the samples block by block. The covariates are split into one chunk per task.
+
+    const int Ndimensions = posteriorSample.rows();
+    const int NcovariateChunks = min(Ncovariates, 4 * threadPool.getNthreads());
+    const int chunkSize = (Ncovariates + NcovariateChunks - 1) / NcovariateChunks;
+    ArrayXXd blockParameters(Ndimensions, blockSize);
+    ArrayXXd blockPredictions(Ncovariates, blockSize);
+
+    for (int beginIndex = 0; beginIndex < Nsamples; beginIndex += blockSize)
+    {
+        const int length = min(blockSize, Nsamples - beginIndex);
+
+        for (int n = 0; n < length; ++n)
+        {
+            blockParameters.col(n) = posteriorSample.col(sampleIndices[beginIndex + n]);
+        }
+
+        auto predictSample = [&](const int n)
+        {
+            blockPredictions.col(n).setZero();
+            model.predict(blockPredictions.col(n), blockParameters.col(n));
+        };
+
+        threadPool.parallelFor(length, predictSample);
+
+        auto updateChunk = [&](const int chunk)
+        {
+            const int endCovariate = min(Ncovariates, (chunk + 1) * chunkSize);
+
+            for (int covariate = chunk * chunkSize; covariate < endCovariate; ++covariate)
+            {
+                for (int n = 0; n < length; ++n)
+                {
+                    for (int quantile = 0; quantile < Nquantiles; ++quantile)
+                    {
+                        updateQuantileEstimator(estimators[covariate * Nquantiles + quantile], blockPredictions(covariate, n));
+                    }
+                }
+            }
+        };
+
+        threadPool.parallelFor(NcovariateChunks, updateChunk);
+    }
+}
+
+
+
+
+
+
+
+
+
+// PosteriorPredictiveBands::writeBandsToFile()
+//
+// PURPOSE:
+//      Write the covariates and the quantiles of the predictions to an ASCII file,
+//      one row per covariate.
+//
+// INPUT:
+//      fullPath: the full path of the output file
+//
+// OUTPUT:
+//      void
+//
+
+void PosteriorPredictiveBands::writeBandsToFile(string fullPath)
+{
+    ArrayXd covariates = model.getCovariates();
+    ArrayXXd bands = getBands();
+    ArrayXXd covariatesAndBands(covariates.size(), bands.cols() + 1);
+
+    covariatesAndBands.col(0) = covariates;
+    covariatesAndBands.rightCols(bands.cols()) = bands;
+
+    ofstream outputFile;
+    File::openOutputFile(outputFile, fullPath);
+
+    outputFile << "# Posterior predictive bands from " << Nsamples << " resampled posterior samples" << endl;
+    outputFile << "# Column #1: Covariate" << endl;
+
+    for (int quantile = 0; quantile < quantileLevels.size(); ++quantile)
+    {
+        outputFile << "# Column #" << quantile + 2 << ": Quantile " << quantileLevels(quantile) << " of the model" << endl;
+    }
+
+    outputFile << scientific << setprecision(9);
+    File::arrayXXdToFile(outputFile, covariatesAndBands);
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+// PosteriorPredictiveBands::getBands()
+//
+// PURPOSE:
+//      Get the estimated quantiles of the predictions.
+//
+// OUTPUT:
+//      Two-dimensional array of size (Ncovariates, Nquantiles), in the order of the quantile levels.
+//
+
+ArrayXXd PosteriorPredictiveBands::getBands()
+{
+    const int Nquantiles = quantileLevels.size();
+    const int Ncovariates = estimators.size() / Nquantiles;
+    ArrayXXd bands(Ncovariates, Nquantiles);
+
+    for (int covariate = 0; covariate < Ncovariates; ++covariate)
+    {
+        for (int quantile = 0; quantile < Nquantiles; ++quantile)
+        {
+            bands(covariate, quantile) = quantileEstimate(estimators[covariate * Nquantiles + quantile]);
+        }
+    }
+
+    return bands;
+}
+
+
+
+
+
+
+
+
+
+// PosteriorPredictiveBands::getQuantileLevels()
+//
+// PURPOSE:
+//      Get private data member quantileLevels.
+//
+// OUTPUT:
+//      The probabilities of the computed quantiles.
+//
+
+ArrayXd PosteriorPredictiveBands::getQuantileLevels()
+{
+    return quantileLevels;
+}
+
+
+
+
+
+
+
+
+
+// PosteriorPredictiveBands::getNsamples()
+//
+// PURPOSE:
+//      Get private data member Nsamples.
+//
+// OUTPUT:
+//      The number of resampled posterior samples of the last computation.
+//
+
+int PosteriorPredictiveBands::getNsamples()
+{
+    return Nsamples;
+}
+
+
+
+
+
+
+
+
+
+// PosteriorPredictiveBands::resetQuantileEstimator()
+//
+// PURPOSE:
+//      Initialize a P^2 estimator of a quantile, without observations.
+//
+// INPUT:
+//      estimator: the estimator to be initialized
+//      level: the probability of the quantile, between 0 and 1
+//
+// OUTPUT:
+//      void
+//
+
+void PosteriorPredictiveBands::resetQuantileEstimator(QuantileEstimator &estimator, const double level)
+{
+    estimator.level = level;
+    estimator.Nobservations = 0;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        estimator.heights[i] = 0.0;
+        estimator.positions[i] = i + 1.0;
+    }
+
+    estimator.desiredPositions[0] = 1.0;
+    estimator.desiredPositions[1] = 1.0 + 2.0 * level;
+    estimator.desiredPositions[2] = 1.0 + 4.0 * level;
+    estimator.desiredPositions[3] = 3.0 + 2.0 * level;
+    estimator.desiredPositions[4] = 5.0;
+}
+
+
+
+
+
+
+
+
+
+// PosteriorPredictiveBands::updateQuantileEstimator()
+//
+// PURPOSE:
+//      Add an observation to a P^2 estimator of a quantile.
+//
+// INPUT:
+//      estimator: the estimator to be updated
+//      observation: the new observation
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The five markers are the minimum, the quantiles of probability level/2, level
+//      and (1+level)/2, and the maximum. When the position of a middle marker is off by
+//      one or more from its desired position, it is moved by one, and its height is
+//      adjusted with a piecewise-parabolic (or, if that is not monotonic, linear)
+//      interpolation of the neighbouring markers.
+//
+
+void PosteriorPredictiveBands::updateQuantileEstimator(QuantileEstimator &estimator, const double observation)
+{
+    double *heights = estimator.heights;
+    double *positions = estimator.positions;
+    const double level = estimator.level;
+
+
+    // The first five observations are the initial marker heights
+
+    if (estimator.Nobservations < 5)
+    {
+        heights[estimator.Nobservations] = observation;
+        estimator.Nobservations++;
+
+        if (estimator.Nobservations == 5)
+        {
+            sort(heights, heights + 5);
+        }
+
+        return;
+    }
+
+
+    // Find the cell containing the observation, and extend the extreme markers if needed
+
+    int cell;
+
+    if (observation < heights[0])
+    {
+        heights[0] = observation;
+        cell = 0;
+    }
+    else if (observation >= heights[4])
+    {
+        heights[4] = observation;
+        cell = 3;
+    }
+    else
+    {
+        cell = 0;
+        while (observation >= heights[cell+1]) ++cell;
+    }
+
+    for (int i = cell + 1; i < 5; ++i)
+    {
+        positions[i] += 1.0;
+    }
+
+    const double increments[5] = {0.0, level / 2.0, level, (1.0 + level) / 2.0, 1.0};
+
+    for (int i = 0; i < 5; ++i)
+    {
+        estimator.desiredPositions[i] += increments[i];
+    }
+
+    estimator.Nobservations++;
+
+
+    // Adjust the middle markers
+
+    for (int i = 1; i < 4; ++i)
+    {
+        const double offset = estimator.desiredPositions[i] - positions[i];
+
+        if (((offset >= 1.0) && (positions[i+1] - positions[i] > 1.0)) ||
+            ((offset <= -1.0) && (positions[i-1] - positions[i] < -1.0)))
+        {
+            const double step = (offset > 0.0 ? 1.0 : -1.0);
+            const double parabolicHeight = heights[i] + step / (positions[i+1] - positions[i-1])
+                                           * ((positions[i] - positions[i-1] + step) * (heights[i+1] - heights[i]) / (positions[i+1] - positions[i])
+                                              + (positions[i+1] - positions[i] - step) * (heights[i] - heights[i-1]) / (positions[i] - positions[i-1]));
+
+            if ((heights[i-1] < parabolicHeight) && (parabolicHeight < heights[i+1]))
+            {
+                heights[i] = parabolicHeight;
+            }
+            else
+            {
+                const int neighbour = i + int(step);
+                heights[i] += step * (heights[neighbour] - heights[i]) / (positions[neighbour] - positions[i]);
+            }
+
+            positions[i] += step;
+        }
+    }
+}
+
+
+
+
+
+
+
+
+
+// PosteriorPredictiveBands::quantileEstimate()
+//
+// PURPOSE:
+//      Get the current estimate of a quantile from its P^2 estimator.
+//
+// INPUT:
+//      estimator: the estimator of the quantile
+//
+// OUTPUT:
+//      The height of the middle marker, or the quantile of the observations
+//      if there are fewer than five of them.
+//
+
+double PosteriorPredictiveBands::quantileEstimate(const QuantileEstimator &estimator)
+{
+    if (estimator.Nobservations >= 5)
+    {
+        return estimator.heights[2];
+    }
+
+    assert(estimator.Nobservations > 0);
+
+    vector<double> observations(estimator.heights, estimator.heights + estimator.Nobservations);
+    sort(observations.begin(), observations.end());
+    const int index = min(estimator.Nobservations - 1, int(estimator.level * estimator.Nobservations));
+
+    return observations[index];
+}
@@ -0,0 +1,189 @@
+#include "PrincipalComponentsClusterer.h"
+
+
+
+// PrincipalComponentsClusterer::PrincipalComponentsClusterer()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      clusterer: the clustering algorithm applied to the projected sample (e.g. KmeansClusterer)
+//      retainedVarianceFraction: the sample is projected onto the smallest set of principal
+//                                components whose variances add up to at least this fraction
+//                                of the total variance of the sample.
+//      minNdimensions: the minimum number of principal components to retain.
+//
+// REMARKS:
+//      The distances are only computed by the clusterer, with its own metric, in the projected
+//      subspace. That metric is also the one of this clusterer.
+//
+
+PrincipalComponentsClusterer::PrincipalComponentsClusterer(Clusterer &clusterer, double retainedVarianceFraction, int minNdimensions)
+: Clusterer(clusterer.getMetric()),
+  clusterer(clusterer),
+  retainedVarianceFraction(retainedVarianceFraction),
+  minNdimensions(minNdimensions),
+  NprojectedDimensions(0)
+{
+    assert((retainedVarianceFraction > 0.0) && (retainedVarianceFraction <= 1.0));
+    assert(minNdimensions > 0);
+}
+
+
+
+
+
+
+
+
+
+// PrincipalComponentsClusterer::~PrincipalComponentsClusterer()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+PrincipalComponentsClusterer::~PrincipalComponentsClusterer()
+{
+
+}
+
+
+
+
+
+
+
+
+
+// PrincipalComponentsClusterer::cluster()
+//
+// PURPOSE:
+//      Project the sample onto its principal components that retain the required fraction
+//      of the total variance, and cluster the projected sample.
+//
+// INPUT:
+//      sample(Ndimensions, Npoints): sample of N-dimensional points
+//      optimalClusterIndices(Npoints): for each point the index of the cluster it belongs to. This index
+//                                      runs from 0 to Nclusters-1.
+//      optimalClusterSizes(Nclusters): for each of the clusters, this vector contains the number of points
+//
+// OUTPUT:
+//      The number of clusters found by the clusterer in the projected subspace.
+//
+// REMARKS:
+//      Since the projection keeps the order of the points, optimalClusterIndices directly applies
+//      to the points of the original (unprojected) sample.
+//      If the projection would retain all dimensions, the sample is clustered as it is.
+//
+
+int PrincipalComponentsClusterer::cluster(RefArrayXXd sample, vector<int> &optimalClusterIndices, vector<int> &optimalClusterSizes)
+{
+    int Ndimensions = sample.rows();
+    int Npoints = sample.cols();
+
+    if ((Ndimensions <= minNdimensions) || (Npoints < 2))
+    {
+        NprojectedDimensions = Ndimensions;
+        return clusterer.cluster(sample, optimalClusterIndices, optimalClusterSizes);
+    }
+
+
+    // Compute the principal components of the sample
+
+    ArrayXXd covarianceMatrix(Ndimensions, Ndimensions);
+    ArrayXd centerCoordinates(Ndimensions);
+    ArrayXd eigenvalues(Ndimensions);
+    ArrayXXd eigenvectorsMatrix(Ndimensions, Ndimensions);
+
+    Functions::clusterCovariance(sample, covarianceMatrix, centerCoordinates);
+
+    if (!Functions::selfAdjointMatrixDecomposition(covarianceMatrix, eigenvalues, eigenvectorsMatrix))
+    {
+        // Fall back on clustering in the full space
+
+        NprojectedDimensions = Ndimensions;
+        return clusterer.cluster(sample, optimalClusterIndices, optimalClusterSizes);
+    }
+
+
+    // The eigenvalues are sorted in ascending order, so the principal components
+    // are retained starting from the last one.
+
+    double totalVariance = eigenvalues.sum();
+    double retainedVariance = 0.0;
+    NprojectedDimensions = 0;
+
+    while (NprojectedDimensions < Ndimensions)
+    {
+        retainedVariance += eigenvalues(Ndimensions - 1 - NprojectedDimensions);
+        NprojectedDimensions++;
+
+        if ((NprojectedDimensions >= minNdimensions) && (retainedVariance >= retainedVarianceFraction * totalVariance))
+        {
+            break;
+        }
+    }
+
+    if (NprojectedDimensions == Ndimensions)
+    {
+        return clusterer.cluster(sample, optimalClusterIndices, optimalClusterSizes);
+    }
+
+
+    // Project the centered sample onto the retained principal components
+
+    MatrixXd principalComponents = eigenvectorsMatrix.rightCols(NprojectedDimensions).matrix();
+    ArrayXXd centeredSample = sample.colwise() - centerCoordinates;
+    ArrayXXd projectedSample = (principalComponents.transpose() * centeredSample.matrix()).array();
+
+
+    // Cluster the projected sample. The point order is unchanged.
+
+    return clusterer.cluster(projectedSample, optimalClusterIndices, optimalClusterSizes);
+}
+
+
+
+
+
+
+
+
+
+// PrincipalComponentsClusterer::getNprojectedDimensions()
+//
+// PURPOSE:
+//      Get private data member NprojectedDimensions.
+//
+// OUTPUT:
+//      An integer containing the number of principal components used in the last clustering.
+//
+
+int PrincipalComponentsClusterer::getNprojectedDimensions()
+{
+    return NprojectedDimensions;
+}
+
+
+
+
+
+
+
+
+
+// PrincipalComponentsClusterer::getRetainedVarianceFraction()
+//
+// PURPOSE:
+//      Get private data member retainedVarianceFraction.
+//
+// OUTPUT:
+//      A double containing the minimum fraction of the total variance retained by the projection.
+//
+
+double PrincipalComponentsClusterer::getRetainedVarianceFraction()
+{
+    return retainedVarianceFraction;
+}
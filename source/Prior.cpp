@@ -15,10 +15,9 @@ Prior::Prior(const int Ndimensions)
 : minusInfinity(numeric_limits<double>::lowest()),
   Ndimensions(Ndimensions)
 {
-	// Set the seed of the random generator using the clock
+    // Take an independent stream of random numbers, derived from the seed of the run
 
-    clock_t clockticks = clock();
-    engine.seed(clockticks);
+    engine = RandomStreams::getNextStream("Prior");
 }
 
 
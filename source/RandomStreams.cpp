@@ -0,0 +1,145 @@
+#include "RandomStreams.h"
+
+
+namespace
+{
+    mutex streamsMutex;
+    bool runSeedIsSet = false;
+    uint64_t runSeed = 0;
+    unordered_map<string, uint64_t> NstreamsOfComponent;        // Number of streams handed out by getNextStream()
+}
+
+
+
+
+
+
+
+
+
+// RandomStreams::setRunSeed()
+//
+// PURPOSE:
+//      Set the seed from which all streams are derived.
+//
+// INPUT:
+//      newRunSeed: the seed of the run
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      This should be called before the components of the run are constructed.
+//      The instance numbers used by getNextStream() restart from zero, so that
+//      components constructed again in the same order get the same streams.
+//
+
+void RandomStreams::setRunSeed(const uint64_t newRunSeed)
+{
+    lock_guard<mutex> lock(streamsMutex);
+
+    runSeed = newRunSeed;
+    runSeedIsSet = true;
+    NstreamsOfComponent.clear();
+}
+
+
+
+
+
+
+
+
+
+// RandomStreams::getRunSeed()
+//
+// PURPOSE:
+//      Get the seed from which all streams are derived.
+//
+// OUTPUT:
+//      The seed of the run. If it was not set with setRunSeed(), it is
+//      taken from the system clock the first time a seed is needed.
+//
+
+uint64_t RandomStreams::getRunSeed()
+{
+    lock_guard<mutex> lock(streamsMutex);
+
+    if (!runSeedIsSet)
+    {
+        runSeed = chrono::high_resolution_clock::now().time_since_epoch().count();
+        runSeedIsSet = true;
+    }
+
+    return runSeed;
+}
+
+
+
+
+
+
+
+
+
+// RandomStreams::getStream()
+//
+// PURPOSE:
+//      Get the stream of random numbers of a component.
+//
+// INPUT:
+//      componentName: the name of the component, e.g. "NestedSampler"
+//      index1, index2: indices distinguishing the streams of the same component,
+//                      e.g. its instance number and the thread or iteration number
+//
+// OUTPUT:
+//      A generator at the beginning of the stream. The same arguments always give
+//      the same stream for the same run seed, and different arguments give streams
+//      that do not overlap.
+//
+
+Philox4x32Engine RandomStreams::getStream(const string &componentName, const uint64_t index1, const uint64_t index2)
+{
+    unsigned long long streamIndex = Functions::fnv1aHash(componentName.data(), componentName.size());
+    streamIndex = Functions::fnv1aHash(&index1, sizeof(index1), streamIndex);
+    streamIndex = Functions::fnv1aHash(&index2, sizeof(index2), streamIndex);
+
+    return Philox4x32Engine(getRunSeed(), streamIndex);
+}
+
+
+
+
+
+
+
+
+
+// RandomStreams::getNextStream()
+//
+// PURPOSE:
+//      Get the stream of random numbers of a new instance of a component.
+//
+// INPUT:
+//      componentName: the name of the component, e.g. "Prior"
+//
+// OUTPUT:
+//      The stream getStream(componentName, instanceNumber), where the instance number
+//      is the number of streams of this component handed out before.
+//
+// REMARKS:
+//      The streams are reproducible if the instances are constructed in the same order,
+//      which is the case for the components constructed by a serial program.
+//
+
+Philox4x32Engine RandomStreams::getNextStream(const string &componentName)
+{
+    uint64_t instanceNumber;
+
+    {
+        lock_guard<mutex> lock(streamsMutex);
+        instanceNumber = NstreamsOfComponent[componentName]++;
+    }
+
+    return getStream(componentName, instanceNumber);
+}
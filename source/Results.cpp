@@ -394,6 +394,8 @@ ArrayXd Results::computeCredibleLimits(const double credibleLevel, const double
 //                                  credible level of 68.27 %.
 //      writeMarginalDistribution:  a boolean variable specifying whether the marginal distribution for
 //                                  each parameter has to be written in an output file.
+//      marginalDistributionArchive: if not NULL, the marginal distributions are appended to this
+//                                  binary archive, instead of being written in ASCII files.
 //      
 // OUTPUT:
 //      A bidimensional Eigen Array containing all the estimators of the
@@ -406,7 +408,7 @@ ArrayXd Results::computeCredibleLimits(const double credibleLevel, const double
 //      (6) Upper CL
 // 
 
-ArrayXXd Results::parameterEstimation(double credibleLevel, bool writeMarginalDistribution)
+ArrayXXd Results::parameterEstimation(double credibleLevel, bool writeMarginalDistribution, ArchiveWriter *marginalDistributionArchive)
 {
     int Ndimensions = nestedSampler.getPosteriorSample().rows();
     ArrayXd posteriorDistribution = posteriorProbability();
@@ -596,12 +598,22 @@ ArrayXXd Results::parameterEstimation(double credibleLevel, bool writeMarginalDi
         parameterEstimates(i,6) = skewness;
 
         
-        // If required, save the interpolated marginal distribution in an output file
+        // If required, save the interpolated marginal distribution in an output file or in the archive
 
-        if (writeMarginalDistribution)
+        if (writeMarginalDistribution && (marginalDistributionArchive == NULL))
         {
             writeMarginalDistributionToFile(i);
         }
+        else if (writeMarginalDistribution)
+        {
+            ArrayXXd parameterDistribution(parameterValuesInterpolated.size(), 2);
+            parameterDistribution.col(0) = parameterValuesInterpolated;
+            parameterDistribution.col(1) = marginalDistributionInterpolated;
+
+            ostringstream numberString;
+            numberString << setfill('0') << setw(3) << i;
+            marginalDistributionArchive->appendArrayXXd("marginalDistribution" + numberString.str(), parameterDistribution);
+        }
 
         
     }   // END for loop over the parameters
@@ -866,3 +878,138 @@ void Results::writeParametersSummaryToFile(string fileName, const double credibl
 
 
 
+
+
+
+
+
+
+
+
+// Results::writeArchive()
+//
+// PURPOSE:
+//      Writes all the results of the nested sampling in a single binary archive:
+//      the posterior sample with its log(Likelihood), log(Weight) and posterior probability
+//      values, the evidence information, the summary of the parameter estimation and
+//      the marginal distributions. A text block "description" describes the other blocks.
+//
+// INPUT:
+//      fileName:                   a string variable containing the file name of the archive.
+//      singlePrecision:            if true the posterior sample and its probabilities are stored as float32.
+//                                  The log(Likelihood) and log(Weight) values are always stored as float64,
+//                                  since the evidence of merged runs is computed from them.
+//      credibleLevel:              the credible level of the credible intervals, in percent.
+//      writeMarginalDistribution:  a boolean variable specifying whether the marginal distribution for
+//                                  each parameter has to be included in the archive.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The posterior sample is stored with one sample per row, so that the values of each free 
+//      parameter are contiguous. It is streamed to the archive in blocks of NsamplesPerBlock samples.
+//
+
+void Results::writeArchive(string fileName, const bool singlePrecision, const double credibleLevel, 
+                           const bool writeMarginalDistribution)
+{
+    const int NsamplesPerBlock = 65536;
+
+    string fullPath = nestedSampler.getOutputPathPrefix() + fileName;
+    ArchiveWriter archive(fullPath);
+
+    archive.appendText("description", 
+        "posteriorSample: posterior sample from nested sampling, one row per sample, one column per free parameter\n"
+        "logLikelihood: log(Likelihood) of the posterior sample\n"
+        "logWeight: log(Weight) = log(dX) of the posterior sample\n"
+        "posteriorProbability: posterior probability of the posterior sample (probability only)\n"
+        "evidenceInformation: Skilling's log(Evidence), its error, and Skilling's information gain\n"
+        "credibleLevel: credible level of the credible limits, in percent\n"
+        "parameterSummary: one row per free parameter, with columns I Moment (Mean), Median, Mode, II Moment, "
+        "Lower Credible Limit, Upper Credible Limit, Skewness\n"
+        "marginalDistributionNNN: parameter values and marginal distribution values (probability only) "
+        "of cubic-spline interpolated points, for free parameter NNN\n");
+
+
+    // Stream the posterior sample
+
+    ArrayXXd posteriorSample = nestedSampler.getPosteriorSample();
+    ArrayXd logLikelihoodOfPosteriorSample = nestedSampler.getLogLikelihoodOfPosteriorSample();
+    ArrayXd logWeightOfPosteriorSample = nestedSampler.getLogWeightOfPosteriorSample();
+    ArrayXd posteriorDistribution = posteriorProbability();
+    int Nsamples = posteriorSample.cols();
+
+    for (int firstSample = 0; firstSample < Nsamples; firstSample += NsamplesPerBlock)
+    {
+        int NsamplesInBlock = min(NsamplesPerBlock, Nsamples - firstSample);
+        ArrayXXd sampleBlock = posteriorSample.middleCols(firstSample, NsamplesInBlock).transpose();
+
+        archive.appendArrayXXd("posteriorSample", sampleBlock, singlePrecision);
+        archive.appendArrayXd("logLikelihood", logLikelihoodOfPosteriorSample.segment(firstSample, NsamplesInBlock));
+        archive.appendArrayXd("logWeight", logWeightOfPosteriorSample.segment(firstSample, NsamplesInBlock));
+        archive.appendArrayXd("posteriorProbability", posteriorDistribution.segment(firstSample, NsamplesInBlock), 
+                              singlePrecision);
+    }
+
+
+    // Append the evidence information and the summary of the parameter estimation
+
+    ArrayXXd evidenceInformation(1, 3);
+    evidenceInformation << nestedSampler.getLogEvidence(), nestedSampler.getLogEvidenceError(), 
+                           nestedSampler.getInformationGain();
+    archive.appendArrayXXd("evidenceInformation", evidenceInformation);
+
+    ArrayXXd credibleLevelArray(1, 1);
+    credibleLevelArray << credibleLevel;
+    archive.appendArrayXXd("credibleLevel", credibleLevelArray);
+
+    ArrayXXd parameterEstimates = parameterEstimation(credibleLevel, writeMarginalDistribution, &archive);
+    archive.appendArrayXXd("parameterSummary", parameterEstimates);
+
+    archive.close();
+}
+
+
+
+
+
+
+
+
+
+
+
+
+// Results::readArchive()
+//
+// PURPOSE:
+//      Reads the posterior sample, its log(Likelihood) and log(Weight) values, and the
+//      evidence information from a binary archive written by writeArchive(), into the 
+//      nested sampler. The other functions of Results can then be used on them, 
+//      e.g. to recompute the parameter estimation with another credible level.
+//
+// INPUT:
+//      fullPath:   a string variable containing the full path of the archive.
+//
+// OUTPUT:
+//      void
+//
+
+void Results::readArchive(string fullPath)
+{
+    ArchiveReader archive(fullPath);
+
+    ArrayXXd posteriorSample = archive.readArrayXXd("posteriorSample").transpose();
+    nestedSampler.setPosteriorSample(posteriorSample);
+    nestedSampler.setLogLikelihoodOfPosteriorSample(archive.readArrayXd("logLikelihood"));
+    nestedSampler.setLogWeightOfPosteriorSample(archive.readArrayXd("logWeight"));
+
+    if (archive.containsBlock("evidenceInformation"))
+    {
+        ArrayXXd evidenceInformation = archive.readArrayXXd("evidenceInformation");
+        nestedSampler.setLogEvidence(evidenceInformation(0, 0));
+        nestedSampler.setLogEvidenceError(evidenceInformation(0, 1));
+        nestedSampler.setInformationGain(evidenceInformation(0, 2));
+    }
+}
@@ -0,0 +1,758 @@
+#include "RunMerger.h"
+
+
+const int RunMerger::NpointsPerRead = 4096;
+const int RunMerger::NsamplesPerBlock = 65536;
+
+
+// RunMerger::RunMerger()
+//
+// PURPOSE:
+//      Constructor.
+//
+// INPUT:
+//      Ndimensions: the number of free parameters of the runs to be merged
+//
+
+RunMerger::RunMerger(const int Ndimensions)
+: Ndimensions(Ndimensions),
+  totalNlive(0),
+  Nsamples(0),
+  logEvidence(numeric_limits<double>::lowest()),
+  logEvidenceError(0.0),
+  informationGain(0.0)
+{
+    assert(Ndimensions > 0);
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::~RunMerger()
+//
+// PURPOSE:
+//      Destructor.
+//
+
+RunMerger::~RunMerger()
+{
+
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::addRunFromFiles()
+//
+// PURPOSE:
+//      Add a run whose posterior sample was written to ASCII files by Results, i.e.
+//      logLikelihood.txt and one file parameterNNN.txt per free parameter.
+//
+// INPUT:
+//      inputPathPrefix: the path prefix of the files of the run
+//      Nlive: the number of live points of the run
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The files are kept open, and are only read during the merging.
+//
+
+void RunMerger::addRunFromFiles(string inputPathPrefix, const int Nlive)
+{
+    assert(Nlive > 0);
+
+    Run run;
+    run.name = inputPathPrefix;
+    run.NarchiveRows = 0;
+    run.nextArchiveRow = 0;
+    run.Nlive = Nlive;
+    run.Nstored = 0;
+    run.Nbuffered = 0;
+    run.nextBuffered = 0;
+    run.isExhausted = false;
+
+    run.inputFileNames.push_back(inputPathPrefix + "logLikelihood.txt");
+
+    for (int j = 0; j < Ndimensions; ++j)
+    {
+        ostringstream numberString;
+        numberString << setfill('0') << setw(3) << j;
+        run.inputFileNames.push_back(inputPathPrefix + "parameter" + numberString.str() + ".txt");
+    }
+
+    for (size_t n = 0; n < run.inputFileNames.size(); ++n)
+    {
+        run.inputFiles.push_back(unique_ptr<ifstream>(new ifstream()));
+        File::openInputFile(*run.inputFiles.back(), run.inputFileNames[n]);
+    }
+
+    runs.push_back(move(run));
+    totalNlive += Nlive;
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::addRunFromArchive()
+//
+// PURPOSE:
+//      Add a run whose posterior sample was written to a binary archive by
+//      Results::writeArchive().
+//
+// INPUT:
+//      fullPath: the full path of the archive of the run
+//      Nlive: the number of live points of the run
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The archive is memory-mapped, and is only read during the merging.
+//
+
+void RunMerger::addRunFromArchive(string fullPath, const int Nlive)
+{
+    assert(Nlive > 0);
+
+    Run run;
+    run.name = fullPath;
+    run.archive.reset(new ArchiveReader(fullPath));
+    run.NarchiveRows = run.archive->getNrows("logLikelihood");
+    run.nextArchiveRow = 0;
+    run.Nlive = Nlive;
+    run.Nstored = 0;
+    run.Nbuffered = 0;
+    run.nextBuffered = 0;
+    run.isExhausted = false;
+
+    if (run.archive->getNrows("posteriorSample") != run.NarchiveRows)
+    {
+        cerr << "Error: the posterior sample and the log(Likelihood) values in " << fullPath
+             << " have different sizes." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    runs.push_back(move(run));
+    totalNlive += Nlive;
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::mergeToFiles()
+//
+// PURPOSE:
+//      Merge the runs, and write the merged posterior sample to ASCII files in the
+//      format of Results, i.e. parameterNNN.txt, logLikelihood.txt, logWeight.txt
+//      and evidenceInformation.txt.
+//
+// INPUT:
+//      outputPathPrefix: the path prefix of the output files
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The runs are consumed by the merging, which can therefore be done only once.
+//
+
+void RunMerger::mergeToFiles(string outputPathPrefix)
+{
+    // Open the output files of the merged sample
+
+    vector<unique_ptr<ofstream>> outputFiles;
+
+    for (int j = 0; j < Ndimensions + 2; ++j)
+    {
+        string fullPath;
+
+        if (j < Ndimensions)
+        {
+            ostringstream numberString;
+            numberString << setfill('0') << setw(3) << j;
+            fullPath = outputPathPrefix + "parameter" + numberString.str() + ".txt";
+        }
+        else
+        {
+            fullPath = outputPathPrefix + (j == Ndimensions ? "logLikelihood.txt" : "logWeight.txt");
+        }
+
+        outputFiles.push_back(unique_ptr<ofstream>(new ofstream()));
+        File::openOutputFile(*outputFiles.back(), fullPath);
+    }
+
+    *outputFiles[Ndimensions] << "# Posterior sample from nested sampling" << endl;
+    *outputFiles[Ndimensions] << "# log(Likelihood)" << endl;
+    *outputFiles[Ndimensions+1] << "# Posterior sample from nested sampling" << endl;
+    *outputFiles[Ndimensions+1] << "# log(Weight) = log(dX)" << endl;
+
+    for (size_t n = 0; n < outputFiles.size(); ++n)
+    {
+        *outputFiles[n] << scientific << setprecision(9);
+    }
+
+
+    // Merge the runs, and write the evidence information once it is complete
+
+    merge(NULL, false, outputFiles);
+
+    for (size_t n = 0; n < outputFiles.size(); ++n)
+    {
+        outputFiles[n]->close();
+    }
+
+    ofstream outputFile;
+    File::openOutputFile(outputFile, outputPathPrefix + "evidenceInformation.txt");
+    outputFile << "# Evidence results from nested sampling" << endl;
+    outputFile << scientific << setprecision(9);
+    outputFile << "# Skilling's log(Evidence)" << setw(40) << "Skilling's Error log(Evidence)"
+    << setw(40) << "Skilling's Information Gain" << endl;
+    outputFile << logEvidence << setw(40) << logEvidenceError << setw(40) << informationGain << endl;
+    outputFile.close();
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::mergeToArchive()
+//
+// PURPOSE:
+//      Merge the runs, and write the merged posterior sample, its log(Likelihood)
+//      and log(Weight) values, and the evidence information to a binary archive,
+//      with the same block names as Results::writeArchive().
+//
+// INPUT:
+//      fullPath: the full path of the archive
+//      singlePrecision: if true the posterior sample is stored as float32
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The runs are consumed by the merging, which can therefore be done only once.
+//      The archive can be read with Results::readArchive(), e.g. to compute the
+//      parameter estimation of the merged sample.
+//
+
+void RunMerger::mergeToArchive(string fullPath, const bool singlePrecision)
+{
+    ArchiveWriter archive(fullPath);
+
+    archive.appendText("description",
+        "posteriorSample: merged posterior sample of several nested sampling runs, one row per sample, "
+        "one column per free parameter\n"
+        "logLikelihood: log(Likelihood) of the posterior sample\n"
+        "logWeight: log(Weight) = log(dX) of the posterior sample\n"
+        "evidenceInformation: Skilling's log(Evidence), its error, and Skilling's information gain\n");
+
+    vector<unique_ptr<ofstream>> noOutputFiles;
+    merge(&archive, singlePrecision, noOutputFiles);
+
+    ArrayXXd evidenceInformation(1, 3);
+    evidenceInformation << logEvidence, logEvidenceError, informationGain;
+    archive.appendArrayXXd("evidenceInformation", evidenceInformation);
+
+    archive.close();
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::getTotalNlive()
+//
+// PURPOSE:
+//      Get the total number of live points of the runs.
+//
+// OUTPUT:
+//      The sum of the numbers of live points of all runs added so far.
+//
+
+int RunMerger::getTotalNlive()
+{
+    return totalNlive;
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::getNsamples()
+//
+// PURPOSE:
+//      Get the number of samples of the merged posterior sample.
+//
+// OUTPUT:
+//      The number of samples, zero before the merging.
+//
+
+int64_t RunMerger::getNsamples()
+{
+    return Nsamples;
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::getLogEvidence()
+//
+// PURPOSE:
+//      Get Skilling's log(Evidence) of the merged posterior sample.
+//
+// OUTPUT:
+//      The natural logarithm of the evidence.
+//
+
+double RunMerger::getLogEvidence()
+{
+    return logEvidence;
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::getLogEvidenceError()
+//
+// PURPOSE:
+//      Get Skilling's error on the log(Evidence) of the merged posterior sample.
+//
+// OUTPUT:
+//      The error on the natural logarithm of the evidence.
+//
+
+double RunMerger::getLogEvidenceError()
+{
+    return logEvidenceError;
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::getInformationGain()
+//
+// PURPOSE:
+//      Get Skilling's information gain of the merged posterior sample.
+//
+// OUTPUT:
+//      The information gain, in natural units.
+//
+
+double RunMerger::getInformationGain()
+{
+    return informationGain;
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::fillBuffer()
+//
+// PURPOSE:
+//      Read the next points of a run into its buffer.
+//
+// INPUT:
+//      run: the run whose buffer is to be filled
+//
+// OUTPUT:
+//      False if all points of the run have already been read, true otherwise.
+//
+// REMARKS:
+//      The sample of a run ends with the final live points, which are not sorted by
+//      likelihood, but all have a likelihood higher than the dead points before them.
+//      The last Nlive points read are therefore held back in the buffer, and sorted
+//      once the end of the run is reached. Nlive is the initial (maximum) number of
+//      live points of the run, which is never smaller than the final one.
+//
+
+bool RunMerger::fillBuffer(Run &run)
+{
+    // Move the points held back to the beginning of the buffer
+
+    const int NheldBack = run.Nstored - run.Nbuffered;
+
+    if (NheldBack > 0)
+    {
+        run.logLikelihood.head(NheldBack) = run.logLikelihood.segment(run.Nbuffered, NheldBack).eval();
+        run.parameters.leftCols(NheldBack) = run.parameters.middleCols(run.Nbuffered, NheldBack).eval();
+    }
+
+    run.Nstored = NheldBack;
+    run.Nbuffered = 0;
+    run.nextBuffered = 0;
+
+
+    // Read new points until some of them can be released, or the run ends
+
+    while ((run.Nbuffered == 0) && !run.isExhausted)
+    {
+        int Npoints;
+        run.logLikelihood.conservativeResize(run.Nstored + NpointsPerRead);
+        run.parameters.conservativeResize(Ndimensions, run.Nstored + NpointsPerRead);
+
+        if (run.archive)
+        {
+            Npoints = min(uint64_t(NpointsPerRead), run.NarchiveRows - run.nextArchiveRow);
+
+            if (Npoints > 0)
+            {
+                ArrayXXd parameters = run.archive->readArrayXXd("posteriorSample", run.nextArchiveRow, Npoints);
+
+                if (parameters.cols() != Ndimensions)
+                {
+                    cerr << "Error: the posterior sample in " << run.name << " has " << parameters.cols()
+                         << " free parameters instead of " << Ndimensions << endl;
+                    exit(EXIT_FAILURE);
+                }
+
+                run.logLikelihood.segment(run.Nstored, Npoints) = run.archive->readArrayXXd("logLikelihood", run.nextArchiveRow, Npoints).col(0);
+                run.parameters.middleCols(run.Nstored, Npoints) = parameters.transpose();
+                run.nextArchiveRow += Npoints;
+            }
+        }
+        else
+        {
+            Npoints = readValues(*run.inputFiles[0], run.inputFileNames[0], run.logLikelihood.data() + run.Nstored, NpointsPerRead);
+            ArrayXd parameterValues(Npoints);
+
+            for (int j = 0; j < Ndimensions; ++j)
+            {
+                if (readValues(*run.inputFiles[j+1], run.inputFileNames[j+1], parameterValues.data(), Npoints) != Npoints)
+                {
+                    cerr << "Error: " << run.inputFileNames[j+1] << " has fewer values than " << run.inputFileNames[0] << endl;
+                    exit(EXIT_FAILURE);
+                }
+
+                run.parameters.row(j).segment(run.Nstored, Npoints) = parameterValues.transpose();
+            }
+        }
+
+        run.Nstored += Npoints;
+        run.isExhausted = (Npoints < NpointsPerRead);
+
+        if (!run.isExhausted)
+        {
+            run.Nbuffered = max(0, run.Nstored - run.Nlive);
+        }
+    }
+
+
+    // At the end of the run, sort the points held back by increasing likelihood
+
+    if (run.isExhausted && (run.Nbuffered == 0))
+    {
+        vector<double> logLikelihoodOfHeldBackPoints(run.logLikelihood.data(), run.logLikelihood.data() + run.Nstored);
+        vector<int> indices = Functions::argsort(logLikelihoodOfHeldBackPoints);
+        ArrayXXd parameters = run.parameters.leftCols(run.Nstored);
+
+        for (int i = 0; i < run.Nstored; ++i)
+        {
+            run.logLikelihood(i) = logLikelihoodOfHeldBackPoints[indices[i]];
+            run.parameters.col(i) = parameters.col(indices[i]);
+        }
+
+        run.Nbuffered = run.Nstored;
+    }
+
+    return (run.Nbuffered > 0);
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::readValues()
+//
+// PURPOSE:
+//      Read the next values of a one-column ASCII file, skipping the comment lines
+//      starting with '#' and the empty lines.
+//
+// INPUT:
+//      inputFile: the stream of the input file
+//      inputFileName: the name of the input file, for the error messages
+//      values: pointer to the array in which the values are stored
+//      Nvalues: the maximum number of values to be read
+//
+// OUTPUT:
+//      The number of values read, smaller than Nvalues only at the end of the file.
+//
+
+int RunMerger::readValues(ifstream &inputFile, string inputFileName, double *values, const int Nvalues)
+{
+    string line;
+    int Nread = 0;
+
+    while ((Nread < Nvalues) && getline(inputFile, line))
+    {
+        const char *begin = line.c_str();
+        const char *end = begin + line.size();
+
+        while ((begin < end) && isspace(*begin)) begin++;
+        while ((end > begin) && isspace(*(end-1))) end--;
+
+        if ((begin == end) || (*begin == '#')) continue;
+
+        if (!File::parseDouble(begin, end, values[Nread]))
+        {
+            cerr << "Error: can't convert " << string(begin, end) << " in " << inputFileName << " to a number" << endl;
+            exit(EXIT_FAILURE);
+        }
+
+        Nread++;
+    }
+
+    return Nread;
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::merge()
+//
+// PURPOSE:
+//      Merge the runs by increasing likelihood, and compute the log(Weight) of each
+//      merged sample, the evidence and the information gain on the fly.
+//
+// INPUT:
+//      archive: the archive to which the merged sample is written, or NULL
+//      singlePrecision: if true the posterior sample is stored as float32 in the archive
+//      outputFiles: the ASCII files to which the merged sample is written, i.e. one
+//                   file per free parameter, the log(Likelihood) and the log(Weight)
+//                   files, or none
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      A min-heap holds the next point of each run, so that each merged sample costs
+//      O(log k) for k runs. The merged sample is the dead points of a single run with
+//      the total number of live points N, so that with the trapezoidal rule the prior
+//      mass X_i = exp(-i/N) gives the weights
+//          w_0 = (2 - X_1 - X_2) / 2   and   w_i = (X_(i-1) - X_(i+1)) / 2 = w_1 exp(-(i-1)/N).
+//      Their logarithms follow without computing any power, and without knowing the
+//      total number of samples in advance.
+//
+
+void RunMerger::merge(ArchiveWriter *archive, const bool singlePrecision, vector<unique_ptr<ofstream>> &outputFiles)
+{
+    if (runs.empty())
+    {
+        cerr << "Error: no runs to be merged." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+
+    // Put the first point of each run on the heap. Equal likelihoods are taken
+    // in the order in which the runs were added.
+
+    priority_queue<pair<double,int>, vector<pair<double,int>>, greater<pair<double,int>>> nextPoints;
+
+    for (size_t k = 0; k < runs.size(); ++k)
+    {
+        if (fillBuffer(runs[k]))
+        {
+            nextPoints.push(make_pair(runs[k].logLikelihood(0), int(k)));
+        }
+    }
+
+
+    // Take the points with the lowest likelihood one by one
+
+    const double reductionFactor = exp(-1.0/totalNlive);
+    const double logFirstWeight = log(0.5) + log(2.0 - reductionFactor - reductionFactor*reductionFactor);
+    const double logSecondWeight = log(0.5) + log(1.0 - reductionFactor*reductionFactor);
+
+    ArrayXXd parameterBlock(Ndimensions, NsamplesPerBlock);
+    ArrayXd logLikelihoodBlock(NsamplesPerBlock);
+    ArrayXd logWeightBlock(NsamplesPerBlock);
+    int NsamplesInBlock = 0;
+
+    Nsamples = 0;
+    logEvidence = numeric_limits<double>::lowest();
+    informationGain = 0.0;
+
+    while (!nextPoints.empty())
+    {
+        const int runNumber = nextPoints.top().second;
+        Run &run = runs[runNumber];
+        nextPoints.pop();
+
+        const double logLikelihood = run.logLikelihood(run.nextBuffered);
+        parameterBlock.col(NsamplesInBlock) = run.parameters.col(run.nextBuffered);
+        run.nextBuffered++;
+
+        if ((run.nextBuffered < run.Nbuffered) || fillBuffer(run))
+        {
+            if (run.logLikelihood(run.nextBuffered) < logLikelihood)
+            {
+                cerr << "Error: the posterior sample of " << run.name << " is not sorted by increasing likelihood." << endl;
+                exit(EXIT_FAILURE);
+            }
+
+            nextPoints.push(make_pair(run.logLikelihood(run.nextBuffered), runNumber));
+        }
+
+
+        // Update the evidence and the information gain
+
+        const double logWeight = (Nsamples == 0 ? logFirstWeight : logSecondWeight - (Nsamples - 1) / double(totalNlive));
+        const double logEvidenceContributionNew = logWeight + logLikelihood;
+        const double logEvidenceNew = Functions::logExpSum(logEvidence, logEvidenceContributionNew);
+        informationGain = exp(logEvidenceContributionNew - logEvidenceNew) * logLikelihood
+                        + exp(logEvidence - logEvidenceNew) * (informationGain + logEvidence)
+                        - logEvidenceNew;
+        logEvidence = logEvidenceNew;
+
+        logLikelihoodBlock(NsamplesInBlock) = logLikelihood;
+        logWeightBlock(NsamplesInBlock) = logWeight;
+        NsamplesInBlock++;
+        Nsamples++;
+
+
+        // Write the block of merged samples once it is full
+
+        if (NsamplesInBlock == NsamplesPerBlock)
+        {
+            writeBlock(parameterBlock, logLikelihoodBlock, logWeightBlock, archive, singlePrecision, outputFiles);
+            NsamplesInBlock = 0;
+        }
+    }
+
+    if (NsamplesInBlock > 0)
+    {
+        writeBlock(parameterBlock.leftCols(NsamplesInBlock), logLikelihoodBlock.head(NsamplesInBlock),
+                   logWeightBlock.head(NsamplesInBlock), archive, singlePrecision, outputFiles);
+    }
+
+
+    // Compute Skilling's error on the log(Evidence), and release the runs
+
+    logEvidenceError = sqrt(fabs(informationGain)/totalNlive);
+    runs.clear();
+}
+
+
+
+
+
+
+
+
+
+
+// RunMerger::writeBlock()
+//
+// PURPOSE:
+//      Write a block of merged samples to the archive and to the ASCII files.
+//
+// INPUT:
+//      parameters: the merged samples, one column per sample
+//      logLikelihood: the log(Likelihood) values of the merged samples
+//      logWeight: the log(Weight) values of the merged samples
+//      archive: the archive to which the block is written, or NULL
+//      singlePrecision: if true the posterior sample is stored as float32 in the archive
+//      outputFiles: the ASCII files to which the block is written, or none
+//
+// OUTPUT:
+//      void
+//
+
+void RunMerger::writeBlock(RefArrayXXd parameters, RefArrayXd logLikelihood, RefArrayXd logWeight, ArchiveWriter *archive,
+                           const bool singlePrecision, vector<unique_ptr<ofstream>> &outputFiles)
+{
+    if (archive != NULL)
+    {
+        ArrayXXd sampleBlock = parameters.transpose();
+        archive->appendArrayXXd("posteriorSample", sampleBlock, singlePrecision);
+        archive->appendArrayXd("logLikelihood", logLikelihood);
+        archive->appendArrayXd("logWeight", logWeight);
+    }
+
+    if (!outputFiles.empty())
+    {
+        for (int j = 0; j < Ndimensions; ++j)
+        {
+            ArrayXd parameterValues = parameters.row(j).transpose();
+            File::arrayXdToFile(*outputFiles[j], parameterValues);
+        }
+
+        File::arrayXdToFile(*outputFiles[Ndimensions], logLikelihood);
+        File::arrayXdToFile(*outputFiles[Ndimensions+1], logWeight);
+    }
+}
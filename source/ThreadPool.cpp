@@ -0,0 +1,223 @@
+#include "ThreadPool.h"
+
+
+
+// ThreadPool::ThreadPool()
+//
+// PURPOSE:
+//      Constructor. Starts the worker threads, which wait for tasks.
+//
+// INPUT:
+//      Nthreads: the number of threads that run the tasks, including the thread
+//                that calls parallelFor(). Hence Nthreads-1 worker threads are started.
+//
+
+ThreadPool::ThreadPool(const int Nthreads)
+: Nthreads(Nthreads),
+  task(nullptr),
+  Ntasks(0),
+  nextTaskIndex(0),
+  NbusyWorkers(0),
+  generation(0),
+  isStopping(false)
+{
+    assert(Nthreads >= 1);
+
+    for (int i = 0; i < Nthreads-1; ++i)
+    {
+        workers.push_back(thread(&ThreadPool::work, this));
+    }
+}
+
+
+
+
+
+
+
+
+
+// ThreadPool::~ThreadPool()
+//
+// PURPOSE:
+//      Destructor. Stops and joins the worker threads.
+//
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(poolMutex);
+        isStopping = true;
+    }
+
+    workIsAvailable.notify_all();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+
+
+
+
+
+
+
+
+// ThreadPool::parallelFor()
+//
+// PURPOSE:
+//      Run task(taskIndex) for taskIndex = 0, ..., Ntasks-1, distributed over the 
+//      threads of the pool, and return when all tasks are done.
+//
+// INPUT:
+//      Ntasks: the number of tasks
+//      task: function to be called for each task index. It should be safe to call it
+//            concurrently for different task indices.
+//
+// OUTPUT:
+//      void
+//
+// REMARKS:
+//      The tasks are handed out dynamically, so the order in which they are run is 
+//      not deterministic. Results that have to be combined deterministically should 
+//      be stored per task index, and combined after this function returns.
+//
+
+void ThreadPool::parallelFor(const int Ntasks, const function<void(const int taskIndex)> &task)
+{
+    if (Ntasks <= 0) return;
+
+    lock_guard<mutex> callLock(callMutex);
+
+    if (workers.empty() || (Ntasks == 1))
+    {
+        for (int taskIndex = 0; taskIndex < Ntasks; ++taskIndex)
+        {
+            task(taskIndex);
+        }
+
+        return;
+    }
+
+
+    // Hand out the tasks to the workers
+
+    {
+        lock_guard<mutex> lock(poolMutex);
+        this->task = &task;
+        this->Ntasks = Ntasks;
+        nextTaskIndex = 0;
+        NbusyWorkers = workers.size();
+        generation++;
+    }
+
+    workIsAvailable.notify_all();
+
+
+    // The calling thread runs tasks as well, and then waits for the workers
+
+    runTasks();
+
+    unique_lock<mutex> lock(poolMutex);
+    workIsFinished.wait(lock, [this]{ return NbusyWorkers == 0; });
+    this->task = nullptr;
+}
+
+
+
+
+
+
+
+
+
+
+// ThreadPool::getNthreads()
+//
+// PURPOSE:
+//      Get private data member Nthreads.
+//
+// OUTPUT:
+//      The number of threads that run the tasks, including the calling thread.
+//
+
+int ThreadPool::getNthreads()
+{
+    return Nthreads;
+}
+
+
+
+
+
+
+
+
+
+
+// ThreadPool::work()
+//
+// PURPOSE:
+//      Main loop of the worker threads: wait for a new call of parallelFor(),
+//      run tasks until there are none left, and signal when done.
+//
+// OUTPUT:
+//      void
+//
+
+void ThreadPool::work()
+{
+    unsigned long lastGeneration = 0;
+
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(poolMutex);
+            workIsAvailable.wait(lock, [this, lastGeneration]{ return isStopping || (generation != lastGeneration); });
+
+            if (isStopping) return;
+
+            lastGeneration = generation;
+        }
+
+        runTasks();
+
+        {
+            lock_guard<mutex> lock(poolMutex);
+            NbusyWorkers--;
+        }
+
+        workIsFinished.notify_one();
+    }
+}
+
+
+
+
+
+
+
+
+
+
+// ThreadPool::runTasks()
+//
+// PURPOSE:
+//      Claim and run the remaining tasks of the current call of parallelFor(), one at a time.
+//
+// OUTPUT:
+//      void
+//
+
+void ThreadPool::runTasks()
+{
+    int taskIndex;
+
+    while ((taskIndex = nextTaskIndex++) < Ntasks)
+    {
+        (*task)(taskIndex);
+    }
+}
@@ -16,7 +16,6 @@
 
 UniformPrior::UniformPrior(const RefArrayXd minima, const RefArrayXd maxima)
 : Prior(minima.size()),
-  uniform(0.0,1.0),
   minima(minima),
   maxima(maxima)
 {
@@ -214,14 +213,14 @@ void UniformPrior::draw(RefArrayXXd drawnSample)
     int Npoints = drawnSample.cols();
  
 
-    // Uniform sampling over all free parameters and points
+    // Uniform sampling over all free parameters and points, drawn in bulk in [0, 1)
+    // and then rescaled to the range of each free parameter
 
-    for (int i = 0; i < Ndimensions; i++)
+    engine.fillUniformSample(drawnSample);
+
+    for (int j = 0; j < Npoints; j++)
     {
-        for (int j = 0; j < Npoints; j++)
-        {
-            drawnSample(i,j) = uniform(engine)*(maxima(i)-minima(i)) + minima(i);
-        }
+        drawnSample.col(j) = drawnSample.col(j) * (maxima - minima) + minima;
     }
 
 }
@@ -261,10 +260,8 @@ void UniformPrior::drawWithConstraint(RefArrayXd drawnPoint, Likelihood &likelih
     
     do
     {
-        for (int i = 0; i < Ndimensions; i++)
-            {
-                drawnPoint(i) = uniform(engine)*(maxima(i) - minima(i)) + minima(i);
-            }
+        engine.fillUniform(drawnPoint);
+        drawnPoint = drawnPoint * (maxima - minima) + minima;
     
         logLikelihood = likelihood.logValue(drawnPoint);
     }
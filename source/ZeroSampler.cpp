@@ -81,3 +81,26 @@ bool ZeroSampler::drawWithConstraint(const RefArrayXXd totalSample, const unsign
 {    
     return false;
 }
+
+
+
+
+
+
+
+
+
+
+// ZeroSampler::verifySamplerStatus()
+//
+// PURPOSE:
+//      Empty function not to be used.
+//
+// OUTPUT:
+//      Always true, since this sampler has no status to verify.
+//
+
+bool ZeroSampler::verifySamplerStatus()
+{
+    return true;
+}